@@ -0,0 +1,128 @@
+/**
+ * @file bench_tsdb.cpp
+ * @brief Benchmark das séries comprimidas (`tsdb.hpp`).
+ *
+ * Grava uma semana de leituras a 1 Hz de um sensor de temperatura simulado
+ * (variação lenta com ruído de quantização de 0,01 °C e algumas lacunas),
+ * confere que a leitura devolve exatamente os pontos gravados e mede:
+ *
+ * - bytes por ponto no arquivo, comparado com a linha JSON de `serialize()`;
+ * - vazão da varredura completa (`forEachSpan()`), em pontos/s;
+ * - tempo de `aggregate()` em janelas de 1 h e 1 dia, e quantos blocos
+ *   foram resolvidos só pelo cabeçalho.
+ *
+ * Compilação (a partir da raiz do projeto):
+ * @code
+ * g++ -std=c++17 -O2 coletor/bench/bench_tsdb.cpp coletor/src/tsdb.cpp -o build/bench_tsdb
+ * ./build/bench_tsdb [arquivo]
+ * @endcode
+ */
+
+#include "../include/tsdb.hpp"
+#include "../../embarcado/include/udp_protocol.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <unistd.h>
+
+/**
+ * @brief Evita que o compilador descarte o resultado medido.
+ */
+static volatile double sink;
+
+/**
+ * @brief Executa `fn()` `rounds` vezes e retorna o tempo por execução em ns.
+ */
+template <typename Fn>
+static double measure(Fn fn, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+int main(int argc, char **argv) {
+    const std::string path = argc > 1 ? argv[1] : "/tmp/bench_tsdb.tsc";
+    const std::size_t points = 7 * 24 * 3600;
+    const std::int64_t t0 = 1760000000000LL;
+
+    // Série simulada: ciclo diário de 8 °C, arredondada a 0,01 °C como no sensor
+    std::vector<TsPoint> source;
+    source.reserve(points);
+    std::int64_t ts = t0;
+    unsigned seed = 12345;
+    for (std::size_t i = 0; i < points; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const int jitter = static_cast<int>((seed >> 16) % 5) - 2;   // ±2 ms de atraso no agendamento
+        const double v = 22.0 + 4.0 * std::sin(i * 2.0 * M_PI / 86400.0) + ((seed >> 8) % 7) * 0.01;
+        source.push_back(TsPoint{ts + jitter, std::round(v * 100.0) / 100.0});
+        ts += (i % 10000 == 9999) ? 30000 : 1000;  // lacuna de 30 s de vez em quando
+    }
+
+    unlink(path.c_str());
+    TsSeriesWriter writer;
+    if (!writer.open(path))
+        return 1;
+    double writeNs = measure([&] {
+        for (const TsPoint &p : source)
+            writer.append(p.tsMs, p.value);
+        writer.flush();
+    }, 1) / points;
+    writer.close();
+
+    TsSeriesReader reader;
+    if (!reader.open(path))
+        return 1;
+
+    std::vector<TsPoint> back;
+    reader.scan(INT64_MIN, INT64_MAX, back);
+    std::size_t mismatches = back.size() == source.size() ? 0 : source.size();
+    for (std::size_t i = 0; i < back.size() && i < source.size(); ++i)
+        if (back[i].tsMs != source[i].tsMs || back[i].value != source[i].value)
+            ++mismatches;
+    std::printf("pontos: %zu, blocos: %zu, divergencias: %zu\n", back.size(), reader.chunkCount(), mismatches);
+
+    UdpPacket pkt;
+    pkt.group_id = "grupo6";
+    pkt.sensor_id = "SensorDeTemperatura";
+    pkt.unit = "°C";
+    pkt.value = source[0].value;
+    pkt.timestamp = formatTimestamp(source[0].tsMs * 1000000LL);
+    const double jsonBytes = serialize(pkt).size() + 1.0;  // + '\n' de um arquivo de linhas
+    const double bytesPerPoint = static_cast<double>(reader.fileBytes()) / points;
+    std::printf("%-22s %10.2f\n", "bytes/ponto (tsdb)", bytesPerPoint);
+    std::printf("%-22s %10.2f\n", "bytes/ponto (JSON)", jsonBytes);
+    std::printf("%-22s %10.1f\n", "compressao", jsonBytes / bytesPerPoint);
+    std::printf("%-22s %10.1f\n", "gravacao (ns/ponto)", writeNs);
+
+    const int rounds = 20;
+    double scanNs = measure([&] {
+        double s = 0.0;
+        reader.forEachSpan(INT64_MIN, INT64_MAX, [&s](const TsPoint *pts, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                s += pts[i].value;
+        });
+        sink = s;
+    }, rounds);
+    std::printf("%-22s %10.1f\n", "varredura (Mpontos/s)", points / scanNs * 1e3);
+
+    const std::int64_t mid = t0 + 3 * 86400000LL + 1234;
+    const std::int64_t windows[] = {3600000LL, 86400000LL};
+    const char *names[] = {"1 h", "1 dia"};
+    for (int w = 0; w < 2; ++w) {
+        TsAggregate a;
+        double aggNs = measure([&] {
+            a = reader.aggregate(mid, mid + windows[w]);
+            sink = a.mean();
+        }, 1000);
+        std::printf("aggregate(%-5s) %8.1f us  n=%llu min=%.2f max=%.2f media=%.3f "
+                    "blocos: %llu cabecalho, %llu descomprimidos\n",
+                    names[w], aggNs / 1e3, static_cast<unsigned long long>(a.count), a.min, a.max, a.mean(),
+                    static_cast<unsigned long long>(a.chunksFromHeader),
+                    static_cast<unsigned long long>(a.chunksDecoded));
+    }
+
+    unlink(path.c_str());
+    return mismatches == 0 ? 0 : 1;
+}
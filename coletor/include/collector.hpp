@@ -0,0 +1,143 @@
+/**
+ * @file collector.hpp
+ * @brief Declaração da classe Collector, receptor UDP dos pacotes dos sensores.
+ *
+ * O coletor abre um socket UDP por thread na mesma porta (`SO_REUSEPORT`):
+ * o kernel distribui os remetentes entre os sockets, e cada thread recebe
+ * em lote com `recvmmsg()` e decodifica os datagramas sem alocação, com os
+ * mesmos cabeçalhos usados pelo lado embarcado (`udp_protocol.hpp` e
+ * `binary_protocol.hpp`).
+ *
+ * Pacotes com número de sequência têm as perdas contadas de forma exata
+ * (`sequence.hpp`); com `CollectorConfig::nack`, cada lacuna é pedida de
+ * volta ao remetente com um NACK.
+ */
+
+#ifndef COLLECTOR_HPP
+#define COLLECTOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../embarcado/include/sequence.hpp"
+
+/**
+ * @struct CollectorConfig
+ * @brief Parâmetros do coletor.
+ */
+struct CollectorConfig {
+    std::string bindAddress = "0.0.0.0";  /**< Endereço IPv4 local. */
+    std::uint16_t port = 5000;            /**< Porta UDP (a mesma do `UDPClient`). */
+    unsigned threads = 0;                 /**< Sockets/threads de recepção (0 = um por núcleo). */
+    unsigned batch = 64;                  /**< Datagramas por chamada a `recvmmsg()`. */
+    int receiveBufferBytes = 4 << 20;     /**< `SO_RCVBUF` de cada socket. */
+    std::string storageDir;               /**< Diretório das séries comprimidas (`tsdb.hpp`); vazio = não grava. */
+    std::uint32_t pointsPerChunk = 1024;  /**< Pontos por bloco das séries gravadas. */
+    bool nack = false;                    /**< Pede as lacunas de sequência de volta ao remetente. */
+};
+
+/**
+ * @struct SensorStats
+ * @brief Estatísticas de um sensor, identificado por grupo e sensor (ou origem e número, no formato binário).
+ */
+struct SensorStats {
+    std::uint64_t packets = 0;        /**< Leituras recebidas. */
+    std::uint64_t estimatedLost = 0;  /**< Leituras perdidas estimadas por lacunas no intervalo de chegada (sem sequência). */
+    double lastValue = 0.0;           /**< Último valor recebido. */
+    std::string unit;                 /**< Unidade da última leitura. */
+    std::string lastTimestamp;        /**< Timestamp da última leitura, como enviado. */
+    std::int64_t firstArrivalNs = 0;  /**< Chegada da primeira leitura (CLOCK_MONOTONIC). */
+    std::int64_t lastArrivalNs = 0;   /**< Chegada da última leitura (CLOCK_MONOTONIC). */
+    double meanIntervalNs = 0.0;      /**< Intervalo médio entre leituras (média exponencial). */
+    SequenceTracker sequence;         /**< Perdas e reordenações exatas por sessão, se os pacotes tiverem sequência. */
+};
+
+/**
+ * @struct CollectorTotals
+ * @brief Contadores globais do coletor.
+ */
+struct CollectorTotals {
+    std::uint64_t datagrams = 0;      /**< Datagramas recebidos. */
+    std::uint64_t packets = 0;        /**< Leituras decodificadas (um datagrama de lote tem várias). */
+    std::uint64_t parseErrors = 0;    /**< Datagramas malformados. */
+    std::uint64_t truncated = 0;      /**< Datagramas maiores que o buffer de recepção. */
+    std::uint64_t duplicates = 0;     /**< Leituras repetidas (mesma sequência), descartadas. */
+    std::uint64_t nacksSent = 0;      /**< NACKs enviados aos remetentes. */
+};
+
+/**
+ * @class Collector
+ * @brief Recebe, decodifica e contabiliza os pacotes dos sensores.
+ *
+ * Cada thread mantém sua própria tabela de sensores; como o `SO_REUSEPORT`
+ * direciona sempre o mesmo remetente para o mesmo socket, um sensor só
+ * aparece em uma tabela. As tabelas são lidas por `snapshot()`.
+ *
+ * Com `CollectorConfig::storageDir` definido, cada leitura também é
+ * acrescentada à série do sensor (`<storageDir>/<chave>.tsc`, com `/`
+ * trocado por `_`), gravada pela própria thread que a recebeu.
+ */
+class Collector {
+public:
+    /**
+     * @brief Cria o coletor (sem abrir sockets).
+     *
+     * @param cfg Parâmetros do coletor.
+     */
+    explicit Collector(const CollectorConfig &cfg = CollectorConfig());
+
+    /**
+     * @brief Encerra as threads e fecha os sockets.
+     */
+    ~Collector();
+
+    Collector(const Collector &) = delete;
+    Collector &operator=(const Collector &) = delete;
+
+    /**
+     * @brief Abre os sockets e inicia as threads de recepção.
+     *
+     * @return `false` se nenhum socket puder ser aberto.
+     */
+    bool start();
+
+    /**
+     * @brief Para as threads de recepção (retorna em até ~200 ms).
+     */
+    void stop();
+
+    /**
+     * @brief Número de threads de recepção em execução.
+     */
+    std::size_t threadCount() const;
+
+    /**
+     * @brief Soma dos contadores de todas as threads.
+     */
+    CollectorTotals totals() const;
+
+    /**
+     * @brief Copia as estatísticas de todos os sensores.
+     *
+     * @param out Pares (chave "grupo/sensor" ou "endereço#número", estatísticas); substituído.
+     */
+    void snapshot(std::vector<std::pair<std::string, SensorStats>> &out) const;
+
+private:
+    struct Worker;
+
+    /**
+     * @brief Laço de recepção de uma thread.
+     */
+    void run(Worker &w);
+
+    CollectorConfig config;                        /**< Parâmetros do coletor. */
+    std::vector<std::unique_ptr<Worker>> workers;  /**< Sockets e threads de recepção. */
+    std::atomic<bool> running;                     /**< Threads em execução. */
+};
+
+#endif // COLLECTOR_HPP
@@ -0,0 +1,295 @@
+/**
+ * @file tsdb.hpp
+ * @brief Armazenamento colunar comprimido das leituras recebidas (uma série por sensor).
+ *
+ * Cada sensor tem um arquivo só de acréscimo, formado por blocos (chunks)
+ * de até `pointsPerChunk` pontos. Dentro do bloco, os instantes (ms) são
+ * codificados por delta-de-delta e os valores (`double`) por XOR com o
+ * valor anterior, como no Gorilla (Pelkonen et al., VLDB 2015): uma série
+ * a 1 Hz com valor estável custa poucos bits por ponto.
+ *
+ * Cada bloco começa com um cabeçalho com o intervalo de tempo, a contagem e
+ * mínimo/máximo/soma dos valores; a leitura (via `mmap`) usa o cabeçalho
+ * para pular blocos fora da janela e para agregar blocos inteiramente
+ * dentro dela sem descomprimi-los.
+ *
+ * O arquivo usa a ordem de bytes da máquina (little-endian no ARM e no x86).
+ */
+
+#ifndef TSDB_HPP
+#define TSDB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TsPoint
+ * @brief Um ponto da série.
+ */
+struct TsPoint {
+    std::int64_t tsMs;   /**< Instante da leitura, em ms desde a época Unix. */
+    double value;        /**< Valor da leitura. */
+};
+
+/** Identificação de um bloco ("TSC1"). */
+static const std::uint32_t TS_CHUNK_MAGIC = 0x31435354u;
+
+/**
+ * @struct TsChunkHeader
+ * @brief Cabeçalho de um bloco no arquivo (56 bytes), seguido de `payloadBytes` de dados.
+ *
+ * Os dados são completados com zeros até múltiplo de 8 bytes, para que o
+ * cabeçalho seguinte fique alinhado no mapeamento.
+ */
+struct TsChunkHeader {
+    std::uint32_t magic;          /**< `TS_CHUNK_MAGIC`. */
+    std::uint32_t count;          /**< Pontos no bloco. */
+    std::int64_t tMinMs;          /**< Menor instante. */
+    std::int64_t tMaxMs;          /**< Maior instante. */
+    double vMin;                  /**< Menor valor (ignorando NaN). */
+    double vMax;                  /**< Maior valor (ignorando NaN). */
+    double vSum;                  /**< Soma dos valores (ignorando NaN). */
+    std::uint32_t payloadBytes;   /**< Tamanho dos dados comprimidos, com o alinhamento. */
+    std::uint32_t validCount;     /**< Pontos com valor numérico (não NaN). */
+};
+
+/**
+ * @struct TsAggregate
+ * @brief Resultado de `TsSeriesReader::aggregate()`.
+ */
+struct TsAggregate {
+    std::uint64_t count = 0;                                   /**< Valores agregados (sem NaN). */
+    double min = std::numeric_limits<double>::infinity();      /**< Menor valor. */
+    double max = -std::numeric_limits<double>::infinity();     /**< Maior valor. */
+    double sum = 0.0;                                          /**< Soma dos valores. */
+    std::uint64_t chunksFromHeader = 0;                        /**< Blocos agregados só pelo cabeçalho. */
+    std::uint64_t chunksDecoded = 0;                           /**< Blocos descomprimidos (parcialmente na janela). */
+
+    /**
+     * @brief Média dos valores (NaN se não houver nenhum).
+     */
+    double mean() const { return count ? sum / count : std::numeric_limits<double>::quiet_NaN(); }
+};
+
+/**
+ * @class TsChunkEncoder
+ * @brief Comprime pontos em um bloco, em memória.
+ */
+class TsChunkEncoder {
+public:
+    TsChunkEncoder();
+
+    /**
+     * @brief Descarta o bloco atual e começa um novo.
+     */
+    void reset();
+
+    /**
+     * @brief Acrescenta um ponto ao bloco.
+     *
+     * Instantes fora de ordem são aceitos (custam mais bits).
+     */
+    void append(std::int64_t tsMs, double value);
+
+    /**
+     * @brief Número de pontos no bloco.
+     */
+    std::uint32_t count() const;
+
+    /**
+     * @brief Finaliza os dados e retorna o cabeçalho do bloco.
+     *
+     * @param payload Recebe os dados comprimidos, alinhados a 8 bytes.
+     */
+    TsChunkHeader finish(std::vector<std::uint8_t> &payload);
+
+private:
+    /**
+     * @brief Escreve os `n` bits menos significativos de `v` (n <= 64).
+     */
+    void put(std::uint64_t v, unsigned n);
+
+    std::vector<std::uint8_t> bytes;  /**< Bytes completos já escritos. */
+    std::uint64_t acc;                /**< Bits pendentes (nos bits menos significativos). */
+    unsigned accBits;                 /**< Número de bits em `acc`. */
+    TsChunkHeader header;             /**< Estatísticas do bloco. */
+    std::int64_t prevTs;              /**< Instante anterior. */
+    std::int64_t prevDelta;           /**< Delta anterior. */
+    std::uint64_t prevBits;           /**< Bits do valor anterior. */
+    unsigned prevLead;                /**< Zeros à esquerda do último XOR com janela explícita (64 = nenhum). */
+    unsigned prevTrail;               /**< Zeros à direita do último XOR com janela explícita. */
+};
+
+/**
+ * @brief Descomprime um bloco.
+ *
+ * @param h Cabeçalho do bloco.
+ * @param payload Dados comprimidos.
+ * @param out Destino, com ao menos `h.count` posições.
+ * @return Número de pontos decodificados (menor que `h.count` se os dados estiverem corrompidos).
+ */
+std::size_t decodeTsChunk(const TsChunkHeader &h, const std::uint8_t *payload, TsPoint *out);
+
+/**
+ * @class TsSeriesWriter
+ * @brief Acrescenta pontos ao arquivo de uma série.
+ *
+ * Os pontos ficam em memória até completar um bloco; `flush()` (chamado
+ * também no destrutor) grava o bloco incompleto.
+ */
+class TsSeriesWriter {
+public:
+    TsSeriesWriter();
+    ~TsSeriesWriter();
+
+    TsSeriesWriter(const TsSeriesWriter &) = delete;
+    TsSeriesWriter &operator=(const TsSeriesWriter &) = delete;
+
+    /**
+     * @brief Abre (ou cria) o arquivo da série para acréscimo.
+     *
+     * Um bloco final incompleto (gravação interrompida por uma queda do
+     * coletor) é cortado antes do primeiro acréscimo: sem isso, o leitor
+     * pararia nele e os blocos gravados depois ficariam inacessíveis.
+     *
+     * @param path Caminho do arquivo.
+     * @param pointsPerChunk Pontos por bloco (1 a 65535).
+     * @return `true` se o arquivo foi aberto.
+     */
+    bool open(const std::string &path, std::uint32_t pointsPerChunk = 1024);
+
+    /**
+     * @brief Grava o bloco pendente e fecha o arquivo.
+     */
+    void close();
+
+    /**
+     * @brief Acrescenta um ponto; grava o bloco quando ele completa.
+     *
+     * @return `false` se a gravação do bloco falhar.
+     */
+    bool append(std::int64_t tsMs, double value);
+
+    /**
+     * @brief Grava o bloco pendente, mesmo incompleto.
+     *
+     * @return `false` em caso de erro de escrita.
+     */
+    bool flush();
+
+    std::uint64_t pointsWritten() const { return points; }  /**< Pontos gravados em disco. */
+    std::uint64_t bytesWritten() const { return bytes; }    /**< Bytes gravados (cabeçalhos + dados). */
+
+private:
+    int fd;                               /**< Arquivo da série. */
+    std::uint32_t chunkPoints;            /**< Pontos por bloco. */
+    TsChunkEncoder encoder;               /**< Bloco em construção. */
+    std::vector<std::uint8_t> payload;    /**< Dados do bloco (reutilizado). */
+    std::vector<std::uint8_t> chunk;      /**< Cabeçalho + dados, como gravados (reutilizado). */
+    std::uint64_t points;                 /**< Pontos gravados. */
+    std::uint64_t bytes;                  /**< Bytes gravados. */
+};
+
+/**
+ * @class TsSeriesReader
+ * @brief Lê o arquivo de uma série mapeado em memória.
+ *
+ * Apenas os cabeçalhos são percorridos na abertura; os blocos só são
+ * descomprimidos quando uma consulta precisa de seus pontos.
+ */
+class TsSeriesReader {
+public:
+    TsSeriesReader();
+    ~TsSeriesReader();
+
+    TsSeriesReader(const TsSeriesReader &) = delete;
+    TsSeriesReader &operator=(const TsSeriesReader &) = delete;
+
+    /**
+     * @brief Mapeia o arquivo e indexa seus blocos.
+     *
+     * Um bloco final incompleto (gravação interrompida) é ignorado.
+     *
+     * @return `false` se o arquivo não puder ser aberto.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief Desmapeia o arquivo.
+     */
+    void close();
+
+    std::size_t chunkCount() const { return chunks.size(); } /**< Blocos válidos. */
+    std::uint64_t pointCount() const;                        /**< Total de pontos. */
+    std::size_t fileBytes() const { return mapSize; }        /**< Tamanho do arquivo mapeado. */
+
+    /**
+     * @brief Entrega os pontos em [t0Ms, t1Ms] em trechos contíguos.
+     *
+     * Blocos fora da janela não são descomprimidos. Os ponteiros recebidos
+     * por `fn` valem apenas durante a chamada.
+     *
+     * @param fn Função `fn(const TsPoint *pts, std::size_t n)`.
+     * @return Número de pontos entregues.
+     */
+    template <typename Fn>
+    std::size_t forEachSpan(std::int64_t t0Ms, std::int64_t t1Ms, Fn fn) {
+        std::size_t total = 0;
+        for (const Chunk &c : chunks) {
+            if (c.header->tMaxMs < t0Ms || c.header->tMinMs > t1Ms)
+                continue;
+
+            scratch.resize(c.header->count);
+            std::size_t n = decodeTsChunk(*c.header, c.payload, scratch.data());
+
+            std::size_t i = 0;
+            while (i < n) {
+                while (i < n && (scratch[i].tsMs < t0Ms || scratch[i].tsMs > t1Ms))
+                    ++i;
+                std::size_t start = i;
+                while (i < n && scratch[i].tsMs >= t0Ms && scratch[i].tsMs <= t1Ms)
+                    ++i;
+                if (i > start) {
+                    fn(scratch.data() + start, i - start);
+                    total += i - start;
+                }
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Acrescenta a `out` os pontos em [t0Ms, t1Ms].
+     *
+     * @return Número de pontos acrescentados.
+     */
+    std::size_t scan(std::int64_t t0Ms, std::int64_t t1Ms, std::vector<TsPoint> &out);
+
+    /**
+     * @brief Calcula mínimo, máximo e média dos valores em [t0Ms, t1Ms].
+     *
+     * Blocos inteiramente dentro da janela usam apenas o cabeçalho.
+     */
+    TsAggregate aggregate(std::int64_t t0Ms, std::int64_t t1Ms);
+
+private:
+    /**
+     * @struct Chunk
+     * @brief Posição de um bloco no mapeamento.
+     */
+    struct Chunk {
+        const TsChunkHeader *header;     /**< Cabeçalho. */
+        const std::uint8_t *payload;     /**< Dados comprimidos. */
+    };
+
+    int fd;                         /**< Arquivo da série. */
+    const std::uint8_t *map;        /**< Início do mapeamento. */
+    std::size_t mapSize;            /**< Tamanho mapeado. */
+    std::vector<Chunk> chunks;      /**< Índice dos blocos. */
+    std::vector<TsPoint> scratch;   /**< Bloco descomprimido (reutilizado). */
+};
+
+#endif // TSDB_HPP
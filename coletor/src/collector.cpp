@@ -0,0 +1,387 @@
+/**
+ * @file collector.cpp
+ * @brief Implementação da classe Collector.
+ */
+
+#include "../include/collector.hpp"
+#include "../include/tsdb.hpp"
+#include "../../embarcado/include/udp_protocol.hpp"
+#include "../../embarcado/include/binary_protocol.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/** Tamanho do buffer de cada datagrama (lotes do embarcado têm até 1400 bytes). */
+static const std::size_t DATAGRAM_BUFFER = 2048;
+
+/** Intervalos menores que este (leituras do mesmo lote) não entram na média. */
+static const double BURST_INTERVAL_NS = 1e6;
+
+/**
+ * @struct Collector::Worker
+ * @brief Socket, thread e tabela de sensores de uma thread de recepção.
+ */
+struct Collector::Worker {
+    int fd = -1;                                          /**< Socket UDP. */
+    unsigned cpu = 0;                                     /**< Núcleo preferido da thread. */
+    std::thread thread;                                   /**< Thread de recepção. */
+    mutable std::mutex lock;                              /**< Protege `sensors` durante `snapshot()`. */
+    std::unordered_map<std::string, SensorStats> sensors; /**< Estatísticas por sensor. */
+    std::string key;                                      /**< Chave reutilizada nas buscas (sem alocar). */
+    std::unordered_map<std::string, std::unique_ptr<TsSeriesWriter>> series; /**< Séries gravadas, por sensor. */
+    std::atomic<std::uint64_t> datagrams{0};              /**< Datagramas recebidos. */
+    std::atomic<std::uint64_t> packets{0};                /**< Leituras decodificadas. */
+    std::atomic<std::uint64_t> parseErrors{0};            /**< Datagramas malformados. */
+    std::atomic<std::uint64_t> truncated{0};              /**< Datagramas truncados. */
+    std::atomic<std::uint64_t> duplicates{0};             /**< Leituras repetidas. */
+    std::atomic<std::uint64_t> nacksSent{0};              /**< NACKs enviados. */
+};
+
+/**
+ * @brief Soma `n` a um contador escrito apenas pela própria thread.
+ */
+static void bump(std::atomic<std::uint64_t> &c, std::uint64_t n) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Instante atual do relógio monotônico, em ns.
+ */
+static std::int64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Escreve o endereço IP de origem de um datagrama (sem a porta) em `buf`.
+ *
+ * @return Tamanho do texto (0 se a família for desconhecida).
+ */
+static std::size_t formatPeerAddress(const sockaddr_storage &peer, char *buf, std::size_t cap) {
+    const void *addr = nullptr;
+    if (peer.ss_family == AF_INET)
+        addr = &reinterpret_cast<const sockaddr_in &>(peer).sin_addr;
+    else if (peer.ss_family == AF_INET6)
+        addr = &reinterpret_cast<const sockaddr_in6 &>(peer).sin6_addr;
+    if (!addr || !inet_ntop(peer.ss_family, addr, buf, static_cast<socklen_t>(cap)))
+        return 0;
+    return std::strlen(buf);
+}
+
+/**
+ * @brief Atualiza as estatísticas de um sensor com uma leitura.
+ *
+ * A perda é estimada pelas lacunas na chegada: um intervalo maior que 1,5x
+ * a média conta `intervalo / média - 1` leituras perdidas.
+ */
+static void record(SensorStats &st, double value, std::string_view unit,
+                   std::string_view ts, std::int64_t nowNs)
+{
+    if (st.packets == 0) {
+        st.firstArrivalNs = nowNs;
+    } else {
+        double gap = static_cast<double>(nowNs - st.lastArrivalNs);
+        if (st.meanIntervalNs > 0.0 && gap > 1.5 * st.meanIntervalNs) {
+            st.estimatedLost += static_cast<std::uint64_t>(gap / st.meanIntervalNs + 0.5) - 1;
+        } else if (gap >= BURST_INTERVAL_NS) {
+            st.meanIntervalNs = st.meanIntervalNs > 0.0 ? st.meanIntervalNs + 0.1 * (gap - st.meanIntervalNs) : gap;
+        }
+    }
+
+    ++st.packets;
+    st.lastArrivalNs = nowNs;
+    st.lastValue = value;
+    st.unit.assign(unit.data(), unit.size());
+    st.lastTimestamp.assign(ts.data(), ts.size());
+}
+
+/**
+ * @brief Acompanha a sequência de um pacote e, se `fd` for válido, pede com um NACK a lacuna que ele abriu.
+ *
+ * @param st Estatísticas do sensor.
+ * @param session Sessão do remetente.
+ * @param sensorNum Sensor no remetente.
+ * @param seq Número de sequência.
+ * @param fd Socket para o NACK (-1 = sem NACK).
+ * @param peer Endereço de origem do pacote.
+ * @param peerLen Tamanho de `peer`.
+ * @param nacks Contador de NACKs enviados.
+ * @return `false` se o pacote for repetido.
+ */
+static bool track(SensorStats &st, std::uint32_t session, std::uint16_t sensorNum, std::uint32_t seq,
+                  int fd, const sockaddr_storage &peer, socklen_t peerLen, std::uint64_t &nacks)
+{
+    NackRange gap;
+    if (!st.sequence.update(session, seq, fd >= 0 ? &gap : nullptr))
+        return false;
+    if (gap.count == 0)
+        return true;
+
+    std::uint8_t buf[NACK_MAX_SIZE];
+    const std::size_t len = encodeNack(session, sensorNum, &gap, 1, buf, sizeof(buf));
+    if (len && sendto(fd, buf, len, MSG_DONTWAIT, reinterpret_cast<const sockaddr *>(&peer), peerLen) > 0)
+        ++nacks;
+    return true;
+}
+
+/**
+ * @brief Acrescenta uma leitura à série do sensor `key`, abrindo o arquivo na primeira vez.
+ *
+ * Um sensor cujo arquivo não pode ser aberto fica sem série (o erro é
+ * mostrado uma vez).
+ */
+static void store(const CollectorConfig &cfg,
+                  std::unordered_map<std::string, std::unique_ptr<TsSeriesWriter>> &series,
+                  const std::string &key, std::int64_t epochNs, double value)
+{
+    auto it = series.find(key);
+    if (it == series.end()) {
+        std::string path = cfg.storageDir + "/";
+        for (char c : key)
+            path.push_back(c == '/' ? '_' : c);
+        path += ".tsc";
+
+        std::unique_ptr<TsSeriesWriter> writer(new TsSeriesWriter());
+        if (!writer->open(path, cfg.pointsPerChunk))
+            writer.reset();
+        it = series.emplace(key, std::move(writer)).first;
+    }
+    if (it->second)
+        it->second->append(epochNs / 1000000, value);
+}
+
+Collector::Collector(const CollectorConfig &cfg)
+: config(cfg), running(false)
+{
+}
+
+Collector::~Collector() {
+    stop();
+}
+
+/**
+ * @brief Abre um socket UDP com `SO_REUSEPORT` na porta configurada.
+ *
+ * @return Descritor do socket, ou -1 em caso de erro.
+ */
+static int openSocket(const CollectorConfig &cfg) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    int one = 1;
+    timeval tv{0, 200000}; // permite verificar `running` periodicamente
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &cfg.receiveBufferBytes, sizeof(cfg.receiveBufferBytes));
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg.port);
+    if (inet_pton(AF_INET, cfg.bindAddress.c_str(), &addr.sin_addr) != 1 ||
+        bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool Collector::start() {
+    if (running)
+        return true;
+
+    unsigned n = config.threads ? config.threads : std::thread::hardware_concurrency();
+    if (n == 0)
+        n = 1;
+
+    for (unsigned i = 0; i < n; ++i) {
+        std::unique_ptr<Worker> w(new Worker());
+        w->fd = openSocket(config);
+        if (w->fd < 0) {
+            std::cerr << "Erro: não foi possível abrir a porta UDP " << config.port
+                      << " (" << std::strerror(errno) << ")" << std::endl;
+            break;
+        }
+        w->cpu = i % (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1);
+        workers.push_back(std::move(w));
+    }
+
+    if (workers.empty())
+        return false;
+
+    running = true;
+    for (std::unique_ptr<Worker> &w : workers) {
+        Worker *wp = w.get();
+        w->thread = std::thread([this, wp] { run(*wp); });
+    }
+    return true;
+}
+
+void Collector::stop() {
+    running = false;
+    for (std::unique_ptr<Worker> &w : workers) {
+        if (w->thread.joinable())
+            w->thread.join();
+        if (w->fd >= 0)
+            close(w->fd);
+        w->series.clear(); // grava os blocos pendentes
+    }
+    workers.clear();
+}
+
+std::size_t Collector::threadCount() const {
+    return workers.size();
+}
+
+/**
+ * @brief Recebe datagramas em lote e atualiza a tabela da thread.
+ *
+ * O formato é reconhecido pelo primeiro byte: registro binário (leitura
+ * ou resumo, ver `isBinaryLeadByte()`), lote binário (`BINARY_BATCH_MAGIC`)
+ * ou JSON (objeto ou array). Leituras repetidas (mesma sequência) são
+ * descartadas.
+ *
+ * Registros binários não têm grupo nem nome: a chave do sensor é o
+ * endereço de origem com o número (`192.168.42.2#1`), para que placas com
+ * o mesmo `sensor_num` não se misturem.
+ */
+void Collector::run(Worker &w) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(w.cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+    const std::size_t batch = config.batch ? config.batch : 1;
+    const bool storing = !config.storageDir.empty();
+    std::vector<char> buffers(batch * DATAGRAM_BUFFER);
+    std::vector<iovec> iov(batch);
+    std::vector<mmsghdr> msgs(batch);
+    std::vector<sockaddr_storage> peers(batch); /**< Origem de cada datagrama (destino dos NACKs). */
+    const int nackFd = config.nack ? w.fd : -1;
+    for (std::size_t i = 0; i < batch; ++i) {
+        iov[i].iov_base = &buffers[i * DATAGRAM_BUFFER];
+        iov[i].iov_len = DATAGRAM_BUFFER;
+        std::memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (running.load(std::memory_order_relaxed)) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            msgs[i].msg_hdr.msg_name = &peers[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(peers[i]);
+        }
+        int n = recvmmsg(w.fd, msgs.data(), static_cast<unsigned>(batch), MSG_WAITFORONE, nullptr);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+            std::cerr << "Erro em recvmmsg: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        const std::int64_t now = monotonicNs();
+        std::uint64_t packets = 0, errors = 0, truncated = 0, duplicates = 0, nacks = 0;
+
+        std::lock_guard<std::mutex> guard(w.lock);
+        for (int i = 0; i < n; ++i) {
+            const char *data = static_cast<const char *>(iov[i].iov_base);
+            const std::size_t len = msgs[i].msg_len;
+
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                ++truncated;
+                continue;
+            }
+
+            const std::uint8_t first = len ? static_cast<std::uint8_t>(data[0]) : 0;
+            const sockaddr_storage &peer = peers[i];
+            const socklen_t peerLen = msgs[i].msg_hdr.msg_namelen;
+            bool ok;
+            if (isBinaryLeadByte(first)) {
+                char host[INET6_ADDRSTRLEN];
+                const std::size_t hostLen = formatPeerAddress(peer, host, sizeof(host));
+                auto onRecord = [&](const BinaryPacketView &v) {
+                    w.key.assign(host, hostLen);
+                    w.key.push_back('#');
+                    char num[8];
+                    std::to_chars_result r = std::to_chars(num, num + sizeof(num), v.sensorNum());
+                    w.key.append(num, r.ptr);
+                    SensorStats &st = w.sensors[w.key];
+                    if (v.hasSequence() && !track(st, v.session(), v.sensorNum(), v.seq(), nackFd, peer, peerLen, nacks)) {
+                        ++duplicates;
+                        return;
+                    }
+                    record(st, v.value(), binaryUnitName(v.unit()), std::string_view(), now);
+                    if (storing)
+                        store(config, w.series, w.key, v.epochNs(), v.value());
+                    ++packets;
+                };
+                BinaryPacketView single;
+                if (first == BINARY_BATCH_MAGIC) {
+                    ok = forEachBinaryRecord(data, len, onRecord);
+                } else if ((ok = single.parse(data, len))) {
+                    onRecord(single);
+                }
+            } else {
+                ok = forEachJsonPacket(data, len, [&](const UdpPacketView &v) {
+                    w.key.assign(v.group_id.data(), v.group_id.size());
+                    w.key.push_back('/');
+                    w.key.append(v.sensor_id.data(), v.sensor_id.size());
+                    SensorStats &st = w.sensors[w.key];
+                    if (v.hasSequence && !track(st, v.session, v.sensorNum, v.seq, nackFd, peer, peerLen, nacks)) {
+                        ++duplicates;
+                        return;
+                    }
+                    record(st, v.value, v.unit, v.timestamp, now);
+                    if (storing) {
+                        std::int64_t epochNs;
+                        if (!parseTimestamp(v.timestamp, epochNs))
+                            epochNs = currentEpochNs();
+                        store(config, w.series, w.key, epochNs, v.value);
+                    }
+                    ++packets;
+                });
+            }
+            if (!ok)
+                ++errors;
+        }
+
+        bump(w.datagrams, static_cast<std::uint64_t>(n));
+        bump(w.packets, packets);
+        bump(w.parseErrors, errors);
+        bump(w.truncated, truncated);
+        bump(w.duplicates, duplicates);
+        bump(w.nacksSent, nacks);
+    }
+}
+
+CollectorTotals Collector::totals() const {
+    CollectorTotals t;
+    for (const std::unique_ptr<Worker> &w : workers) {
+        t.datagrams += w->datagrams.load(std::memory_order_relaxed);
+        t.packets += w->packets.load(std::memory_order_relaxed);
+        t.parseErrors += w->parseErrors.load(std::memory_order_relaxed);
+        t.truncated += w->truncated.load(std::memory_order_relaxed);
+        t.duplicates += w->duplicates.load(std::memory_order_relaxed);
+        t.nacksSent += w->nacksSent.load(std::memory_order_relaxed);
+    }
+    return t;
+}
+
+void Collector::snapshot(std::vector<std::pair<std::string, SensorStats>> &out) const {
+    out.clear();
+    for (const std::unique_ptr<Worker> &w : workers) {
+        std::lock_guard<std::mutex> guard(w->lock);
+        for (const auto &entry : w->sensors)
+            out.push_back(entry);
+    }
+}
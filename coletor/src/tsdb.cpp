@@ -0,0 +1,497 @@
+/**
+ * @file tsdb.cpp
+ * @brief Implementação da compressão delta-de-delta/XOR e das classes de série.
+ *
+ * Codificação de cada ponto após o primeiro (o primeiro grava instante e
+ * valor com 64 bits cada):
+ *
+ * | Instante: delta-de-delta (dod) | Bits |
+ * | :--- | :--- |
+ * | `0` | dod = 0 |
+ * | `10` + 7 bits | dod em [-64, 63] |
+ * | `110` + 9 bits | dod em [-256, 255] |
+ * | `1110` + 12 bits | dod em [-2048, 2047] |
+ * | `1111` + 64 bits | demais |
+ *
+ * | Valor: x = bits(v) XOR bits(anterior) | Bits |
+ * | :--- | :--- |
+ * | `0` | x = 0 (valor repetido) |
+ * | `10` + bits significativos | cabe na janela (zeros à esquerda/direita) anterior |
+ * | `11` + 5 bits (zeros à esquerda) + 6 bits (tamanho - 1) + bits | nova janela |
+ */
+
+#include "../include/tsdb.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Bits de um `double`.
+ */
+static std::uint64_t doubleBits(double v) {
+    std::uint64_t b;
+    std::memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+/**
+ * @brief `double` a partir de seus bits.
+ */
+static double bitsDouble(std::uint64_t b) {
+    double v;
+    std::memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Estende o sinal de um inteiro de `n` bits.
+ */
+static std::int64_t signExtend(std::uint64_t v, unsigned n) {
+    const std::uint64_t sign = 1ULL << (n - 1);
+    return static_cast<std::int64_t>((v ^ sign) - sign);
+}
+
+TsChunkEncoder::TsChunkEncoder() {
+    reset();
+}
+
+void TsChunkEncoder::reset() {
+    bytes.clear();
+    acc = 0;
+    accBits = 0;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = TS_CHUNK_MAGIC;
+    prevTs = 0;
+    prevDelta = 0;
+    prevBits = 0;
+    prevLead = 64;
+    prevTrail = 0;
+}
+
+void TsChunkEncoder::put(std::uint64_t v, unsigned n) {
+    if (n == 0)
+        return;
+    if (n < 64)
+        v &= (1ULL << n) - 1;
+
+    if (accBits + n <= 64) {
+        acc = (n == 64) ? v : (acc << n) | v;
+        accBits += n;
+    } else {
+        const unsigned first = 64 - accBits;
+        acc = (acc << first) | (v >> (n - first));
+        accBits = 64;
+        n -= first;
+        v &= (1ULL << n) - 1;
+        for (int i = 56; i >= 0; i -= 8)
+            bytes.push_back(static_cast<std::uint8_t>(acc >> i));
+        acc = v;
+        accBits = n;
+        return;
+    }
+
+    if (accBits == 64) {
+        for (int i = 56; i >= 0; i -= 8)
+            bytes.push_back(static_cast<std::uint8_t>(acc >> i));
+        acc = 0;
+        accBits = 0;
+    }
+}
+
+void TsChunkEncoder::append(std::int64_t tsMs, double value) {
+    const std::uint64_t bits = doubleBits(value);
+
+    if (header.count == 0) {
+        put(static_cast<std::uint64_t>(tsMs), 64);
+        put(bits, 64);
+        header.tMinMs = header.tMaxMs = tsMs;
+    } else {
+        const std::int64_t delta = tsMs - prevTs;
+        const std::int64_t dod = delta - prevDelta;
+        if (dod == 0) {
+            put(0, 1);
+        } else if (dod >= -64 && dod <= 63) {
+            put(0x2, 2);
+            put(static_cast<std::uint64_t>(dod), 7);
+        } else if (dod >= -256 && dod <= 255) {
+            put(0x6, 3);
+            put(static_cast<std::uint64_t>(dod), 9);
+        } else if (dod >= -2048 && dod <= 2047) {
+            put(0xE, 4);
+            put(static_cast<std::uint64_t>(dod), 12);
+        } else {
+            put(0xF, 4);
+            put(static_cast<std::uint64_t>(dod), 64);
+        }
+        prevDelta = delta;
+
+        const std::uint64_t x = bits ^ prevBits;
+        if (x == 0) {
+            put(0, 1);
+        } else {
+            unsigned lead = static_cast<unsigned>(__builtin_clzll(x));
+            unsigned trail = static_cast<unsigned>(__builtin_ctzll(x));
+            if (lead > 31)
+                lead = 31;
+
+            if (prevLead < 64 && lead >= prevLead && trail >= prevTrail) {
+                put(0x2, 2);
+                put(x >> prevTrail, 64 - prevLead - prevTrail);
+            } else {
+                const unsigned len = 64 - lead - trail;
+                put(0x3, 2);
+                put(lead, 5);
+                put(len - 1, 6);
+                put(x >> trail, len);
+                prevLead = lead;
+                prevTrail = trail;
+            }
+        }
+
+        if (tsMs < header.tMinMs)
+            header.tMinMs = tsMs;
+        if (tsMs > header.tMaxMs)
+            header.tMaxMs = tsMs;
+    }
+
+    if (!std::isnan(value)) {
+        if (header.validCount == 0 || value < header.vMin)
+            header.vMin = value;
+        if (header.validCount == 0 || value > header.vMax)
+            header.vMax = value;
+        header.vSum += value;
+        ++header.validCount;
+    }
+
+    prevTs = tsMs;
+    prevBits = bits;
+    ++header.count;
+}
+
+std::uint32_t TsChunkEncoder::count() const {
+    return header.count;
+}
+
+TsChunkHeader TsChunkEncoder::finish(std::vector<std::uint8_t> &payload) {
+    payload = bytes;
+    if (accBits) {
+        std::uint64_t rest = acc << (64 - accBits);
+        for (unsigned i = 0; i < (accBits + 7) / 8; ++i)
+            payload.push_back(static_cast<std::uint8_t>(rest >> (56 - 8 * i)));
+    }
+    while (payload.size() % 8)
+        payload.push_back(0);
+
+    TsChunkHeader h = header;
+    h.payloadBytes = static_cast<std::uint32_t>(payload.size());
+    return h;
+}
+
+/**
+ * @class BitReader
+ * @brief Leitor de bits do mais significativo para o menos significativo.
+ */
+class BitReader {
+public:
+    BitReader(const std::uint8_t *data, std::size_t len)
+    : data(data), totalBits(len * 8), pos(0), overrun(false)
+    {
+    }
+
+    /**
+     * @brief Lê `n` bits (n <= 64).
+     */
+    std::uint64_t get(unsigned n) {
+        if (pos + n > totalBits) {
+            overrun = true;
+            return 0;
+        }
+        std::uint64_t r = 0;
+        while (n) {
+            const unsigned off = static_cast<unsigned>(pos & 7);
+            const unsigned avail = 8 - off;
+            const unsigned take = n < avail ? n : avail;
+            const unsigned b = data[pos >> 3];
+            r = (r << take) | ((b >> (avail - take)) & ((1u << take) - 1));
+            pos += take;
+            n -= take;
+        }
+        return r;
+    }
+
+    bool failed() const { return overrun; } /**< Leitura além do fim dos dados. */
+
+private:
+    const std::uint8_t *data;
+    std::size_t totalBits;
+    std::size_t pos;
+    bool overrun;
+};
+
+std::size_t decodeTsChunk(const TsChunkHeader &h, const std::uint8_t *payload, TsPoint *out) {
+    if (h.count == 0)
+        return 0;
+
+    BitReader in(payload, h.payloadBytes);
+    std::int64_t ts = static_cast<std::int64_t>(in.get(64));
+    std::uint64_t bits = in.get(64);
+    if (in.failed())
+        return 0;
+    out[0].tsMs = ts;
+    out[0].value = bitsDouble(bits);
+
+    std::int64_t delta = 0;
+    unsigned lead = 64, trail = 0;
+    for (std::uint32_t i = 1; i < h.count; ++i) {
+        std::int64_t dod;
+        if (in.get(1) == 0)
+            dod = 0;
+        else if (in.get(1) == 0)
+            dod = signExtend(in.get(7), 7);
+        else if (in.get(1) == 0)
+            dod = signExtend(in.get(9), 9);
+        else if (in.get(1) == 0)
+            dod = signExtend(in.get(12), 12);
+        else
+            dod = static_cast<std::int64_t>(in.get(64));
+        delta += dod;
+        ts += delta;
+
+        if (in.get(1) != 0) {
+            if (in.get(1) != 0) {
+                lead = static_cast<unsigned>(in.get(5));
+                const unsigned len = static_cast<unsigned>(in.get(6)) + 1;
+                if (lead + len > 64)
+                    return i;
+                trail = 64 - lead - len;
+            } else if (lead == 64) {
+                return i;
+            }
+            bits ^= in.get(64 - lead - trail) << trail;
+        }
+
+        if (in.failed())
+            return i;
+        out[i].tsMs = ts;
+        out[i].value = bitsDouble(bits);
+    }
+    return h.count;
+}
+
+/**
+ * @brief Indica se o cabeçalho em `off` abre um bloco inteiro dentro de `size` bytes.
+ */
+static bool chunkFits(const TsChunkHeader &h, std::size_t off, std::size_t size) {
+    return h.magic == TS_CHUNK_MAGIC && h.payloadBytes % 8 == 0 &&
+           off + sizeof(TsChunkHeader) + h.payloadBytes <= size;
+}
+
+TsSeriesWriter::TsSeriesWriter()
+: fd(-1), chunkPoints(1024), points(0), bytes(0)
+{
+}
+
+TsSeriesWriter::~TsSeriesWriter() {
+    close();
+}
+
+bool TsSeriesWriter::open(const std::string &path, std::uint32_t pointsPerChunk) {
+    close();
+    if (pointsPerChunk == 0 || pointsPerChunk > 65535)
+        return false;
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Erro: não foi possível abrir a série " << path << std::endl;
+        return false;
+    }
+
+    // Percorre os cabeçalhos até o último bloco inteiro e corta o resto
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close();
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    std::size_t off = 0;
+    TsChunkHeader h;
+    while (off + sizeof(h) <= size && pread(fd, &h, sizeof(h), static_cast<off_t>(off)) == sizeof(h) &&
+           chunkFits(h, off, size))
+        off += sizeof(h) + h.payloadBytes;
+    if (off < size) {
+        std::cerr << "Aviso: série " << path << " com bloco final incompleto; " << size - off
+                  << " bytes descartados" << std::endl;
+        if (ftruncate(fd, static_cast<off_t>(off)) != 0) {
+            std::cerr << "Erro: não foi possível cortar a série " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    chunkPoints = pointsPerChunk;
+    encoder.reset();
+    return true;
+}
+
+void TsSeriesWriter::close() {
+    if (fd < 0)
+        return;
+    flush();
+    ::close(fd);
+    fd = -1;
+}
+
+bool TsSeriesWriter::append(std::int64_t tsMs, double value) {
+    if (fd < 0)
+        return false;
+    encoder.append(tsMs, value);
+    return encoder.count() < chunkPoints || flush();
+}
+
+/**
+ * @brief Grava cabeçalho e dados do bloco.
+ *
+ * O bloco é montado em um buffer contíguo e escrito com um único `write()`,
+ * de modo que, com `O_APPEND`, blocos nunca se intercalam.
+ */
+bool TsSeriesWriter::flush() {
+    if (fd < 0 || encoder.count() == 0)
+        return true;
+
+    TsChunkHeader h = encoder.finish(payload);
+    chunk.resize(sizeof(h) + payload.size());
+    std::memcpy(chunk.data(), &h, sizeof(h));
+    std::memcpy(chunk.data() + sizeof(h), payload.data(), payload.size());
+
+    const std::uint8_t *p = chunk.data();
+    std::size_t left = chunk.size();
+    while (left) {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            std::cerr << "Erro: falha ao gravar bloco da série" << std::endl;
+            return false;
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+
+    points += h.count;
+    bytes += chunk.size();
+    encoder.reset();
+    return true;
+}
+
+TsSeriesReader::TsSeriesReader()
+: fd(-1), map(nullptr), mapSize(0)
+{
+}
+
+TsSeriesReader::~TsSeriesReader() {
+    close();
+}
+
+bool TsSeriesReader::open(const std::string &path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close();
+        return false;
+    }
+    mapSize = static_cast<std::size_t>(st.st_size);
+    if (mapSize == 0)
+        return true;
+
+    void *p = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        mapSize = 0;
+        close();
+        return false;
+    }
+    map = static_cast<const std::uint8_t *>(p);
+
+    std::size_t off = 0;
+    while (off + sizeof(TsChunkHeader) <= mapSize) {
+        const TsChunkHeader *h = reinterpret_cast<const TsChunkHeader *>(map + off);
+        if (!chunkFits(*h, off, mapSize))
+            break;
+        chunks.push_back(Chunk{h, map + off + sizeof(TsChunkHeader)});
+        off += sizeof(TsChunkHeader) + h->payloadBytes;
+    }
+    return true;
+}
+
+void TsSeriesReader::close() {
+    if (map) {
+        munmap(const_cast<std::uint8_t *>(map), mapSize);
+        map = nullptr;
+    }
+    mapSize = 0;
+    chunks.clear();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+std::uint64_t TsSeriesReader::pointCount() const {
+    std::uint64_t n = 0;
+    for (const Chunk &c : chunks)
+        n += c.header->count;
+    return n;
+}
+
+std::size_t TsSeriesReader::scan(std::int64_t t0Ms, std::int64_t t1Ms, std::vector<TsPoint> &out) {
+    return forEachSpan(t0Ms, t1Ms, [&out](const TsPoint *pts, std::size_t n) {
+        out.insert(out.end(), pts, pts + n);
+    });
+}
+
+TsAggregate TsSeriesReader::aggregate(std::int64_t t0Ms, std::int64_t t1Ms) {
+    TsAggregate a;
+
+    for (const Chunk &c : chunks) {
+        const TsChunkHeader &h = *c.header;
+        if (h.tMaxMs < t0Ms || h.tMinMs > t1Ms)
+            continue;
+
+        if (h.tMinMs >= t0Ms && h.tMaxMs <= t1Ms) {
+            ++a.chunksFromHeader;
+            if (h.validCount == 0)
+                continue;
+            a.count += h.validCount;
+            a.sum += h.vSum;
+            if (h.vMin < a.min)
+                a.min = h.vMin;
+            if (h.vMax > a.max)
+                a.max = h.vMax;
+            continue;
+        }
+
+        ++a.chunksDecoded;
+        scratch.resize(h.count);
+        std::size_t n = decodeTsChunk(h, c.payload, scratch.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            const TsPoint &p = scratch[i];
+            if (p.tsMs < t0Ms || p.tsMs > t1Ms || std::isnan(p.value))
+                continue;
+            ++a.count;
+            a.sum += p.value;
+            if (p.value < a.min)
+                a.min = p.value;
+            if (p.value > a.max)
+                a.max = p.value;
+        }
+    }
+    return a;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_conversion.cpp
+ * @brief Benchmark da conversão ADC → °C: escalar, em lote e por tabela.
+ *
+ * Verifica o limite de erro da conversão em lote nas 65536 entradas
+ * (`BATCH_CONVERSION_MAX_ERROR`) e que `Ky013Model` dá o mesmo resultado
+ * da calibração padrão, e mede a vazão (amostras/s) das implementações
+ * sobre o mesmo bloco, inclusive o modelo fixo em tempo de compilação.
+ * Termina com código 1 se uma das verificações falhar, depois das medidas.
+ *
+ * Compilação (a partir da raiz do projeto):
+ * @code
+ * g++ -std=c++17 -O3 embarcado/bench/bench_conversion.cpp embarcado/src/utils.cpp -o build/bench_conversion
+ * @endcode
+ */
+
+#include "../include/utils.hpp"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/**
+ * @brief Evita que o compilador descarte o resultado medido.
+ */
+static volatile float sink;
+
+/**
+ * @brief Executa `fn` `rounds` vezes e retorna o tempo por amostra em ns.
+ */
+template <typename Fn>
+static double measure(Fn fn, std::size_t samples, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (double(samples) * rounds);
+}
+
+int main() {
+    const ThermistorCalibration cal;
+    const std::size_t n = 65536;
+    const int rounds = 200;
+
+    std::vector<std::uint16_t> in(n);
+    std::vector<float> out(n);
+    for (std::size_t i = 0; i < n; ++i)
+        in[i] = static_cast<std::uint16_t>(i);
+
+    const double maxError = batchConversionMaxError(cal);
+    std::printf("erro maximo (lote vs double): %.6f C (limite %.6f C)\n", maxError, BATCH_CONVERSION_MAX_ERROR);
+
+    double scalarNs = measure([&] {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = convertRawToCelsius(in[i]);
+        sink = out[n / 2];
+    }, n, rounds);
+
+    double batchNs = measure([&] {
+        convertRawToCelsius(in.data(), out.data(), n, cal);
+        sink = out[n / 2];
+    }, n, rounds);
+
+    ConversionTable table(cal);
+    double tableNs = measure([&] {
+        table.convert(in.data(), out.data(), n);
+        sink = out[n / 2];
+    }, n, rounds);
+
+    int modelMismatches = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        if (Ky013Model::convert(static_cast<float>(i)) != convertRawToCelsius(static_cast<int>(i), cal) &&
+            i != 65535) // leitura máxima: o modelo rejeita R = 0, a equação dá -273.15 por outro caminho
+            ++modelMismatches;
+    std::printf("divergencias Ky013Model vs calibracao padrao: %d\n", modelMismatches);
+
+    double modelNs = measure([&] {
+        Ky013Model::convertBlock(in.data(), out.data(), n);
+        sink = out[n / 2];
+    }, n, rounds);
+
+    RawConverter converter = makeConverter<Ky013Model>();
+    double indirectNs = measure([&] {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = converter.convert(in[i]);
+        sink = out[n / 2];
+    }, n, rounds);
+
+    std::printf("%-10s %10s %14s\n", "metodo", "ns/amostra", "amostras/s");
+    std::printf("%-10s %10.2f %14.0f\n", "escalar", scalarNs, 1e9 / scalarNs);
+    std::printf("%-10s %10.2f %14.0f\n", "lote", batchNs, 1e9 / batchNs);
+    std::printf("%-10s %10.2f %14.0f\n", "tabela", tableNs, 1e9 / tableNs);
+    std::printf("%-10s %10.2f %14.0f\n", "modelo", modelNs, 1e9 / modelNs);
+    std::printf("%-10s %10.2f %14.0f\n", "modelo/ptr", indirectNs, 1e9 / indirectNs);
+
+    int status = 0;
+    if (!(maxError <= BATCH_CONVERSION_MAX_ERROR)) {
+        std::fprintf(stderr, "Erro: conversão em lote com erro %.6f C, acima do limite de %.6f C\n", maxError,
+                     BATCH_CONVERSION_MAX_ERROR);
+        status = 1;
+    }
+    if (modelMismatches != 0) {
+        std::fprintf(stderr, "Erro: Ky013Model diverge da calibração padrão em %d leituras\n", modelMismatches);
+        status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,404 @@
+/**
+ * @file bench_hotpath.cpp
+ * @brief Benchmark do caminho leitura → conversão → pacote → envio UDP.
+ *
+ * Mede, para cada etapa, o tempo por operação, as alocações de memória por
+ * operação (contadas pela substituição de `operator new`) e a vazão:
+ *
+ * | Caso | Operação medida |
+ * | :--- | :--- |
+ * | `readRaw` | `Sensor::readRaw()` sobre um arquivo sysfs falso em tmpfs (`/dev/shm`) |
+ * | `convertRawToCelsius` | conversão escalar de um valor do ADC |
+ * | `currentTimestamp` | relógio + formatação ISO8601 (string nova) |
+ * | `formatTimestampInto` | relógio + formatação com milissegundos em um buffer (prefixo em cache) |
+ * | `preparePacket` | `DataFormatter::preparePacket()` |
+ * | `serialize` | `serialize()` (string nova a cada pacote) |
+ * | `serializeInto` | `serializeInto()` com prefixo pré-calculado |
+ * | `windowAdd` | `WindowAggregator::add()` a 1 kHz, janela de 60 s deslizando a cada 10 s, com percentis |
+ * | `adaptiveRate` | `AdaptiveRateController::update()` a 1 kHz, com tendência e resíduos |
+ * | `sequencedStore` | `serializeInto()` com número de sequência + `RetransmitWindow::store()` |
+ * | `shmPublish` | `ShmPublisher::publish()` em um segmento de teste com histórico de 256 leituras |
+ * | `shmLatest` | `ShmReadingsReader::latest()` no mesmo segmento |
+ * | `logInfo` | `LOG_INFO()` com texto e dois números (saída em `/dev/null`; com a fila cheia, mede o descarte) |
+ * | `sendData` | `UDPClient::sendData()` para um receptor em 127.0.0.1 |
+ * | `sendToAll` | `UDPClient::sendToAll()` para 3 destinos no receptor (2 em JSON, 1 binário) |
+ * | `pipeline` | ciclo completo do `main.cpp`: leitura, conversão, pacote, JSON e envio |
+ *
+ * Nos casos com envio, `ops/s` é a taxa de datagramas aceitos pelo kernel;
+ * o número recebido pelo receptor é mostrado à parte.
+ *
+ * Uso:
+ * @code
+ * g++ -std=c++17 -O2 -pthread embarcado/bench/bench_hotpath.cpp embarcado/src/sensor.cpp \
+ *     embarcado/src/utils.cpp embarcado/src/iio_buffer.cpp embarcado/src/filters.cpp \
+ *     embarcado/src/raw_source.cpp embarcado/src/data_formatter.cpp embarcado/src/udp_client.cpp \
+ *     embarcado/src/window_aggregator.cpp embarcado/src/adaptive_rate.cpp \
+ *     embarcado/src/retransmit_window.cpp embarcado/src/logger.cpp embarcado/src/shm_publisher.cpp \
+ *     -o build/bench_hotpath
+ * ./build/bench_hotpath                       # tabela
+ * ./build/bench_hotpath --csv > atual.csv     # saída para comparação
+ * ./build/bench_hotpath --baseline anterior.csv
+ * @endcode
+ *
+ * Com `--baseline`, cada caso é comparado com o CSV de uma execução anterior;
+ * um caso mais de `REGRESSION_THRESHOLD` mais lento, ou com mais alocações
+ * por operação, é marcado e o programa termina com código 1.
+ */
+
+#include "../include/sensor.hpp"
+#include "../include/utils.hpp"
+#include "../include/data_formatter.hpp"
+#include "../include/udp_client.hpp"
+#include "../include/udp_protocol.hpp"
+#include "../include/window_aggregator.hpp"
+#include "../include/adaptive_rate.hpp"
+#include "../include/retransmit_window.hpp"
+#include "../include/logger.hpp"
+#include "../include/shm_publisher.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/** Aumento relativo de ns/op considerado regressão. */
+static const double REGRESSION_THRESHOLD = 0.15;
+
+/** Alocações feitas pelo programa (inclui as de outras threads, que aqui não alocam). */
+static std::atomic<std::uint64_t> allocations(0);
+
+void *operator new(std::size_t n) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief Evita que o compilador descarte o resultado medido.
+ */
+static volatile std::size_t sink;
+
+/**
+ * @struct BenchResult
+ * @brief Resultado de um caso.
+ */
+struct BenchResult {
+    std::string name;        /**< Nome do caso. */
+    double nsPerOp;          /**< Tempo por operação. */
+    double allocsPerOp;      /**< Alocações por operação. */
+    double opsPerSecond;     /**< Vazão. */
+};
+
+/**
+ * @brief Executa `fn(i)` para i em [0, iterations) e mede tempo e alocações.
+ */
+template <typename Fn>
+static BenchResult measure(const char *name, Fn fn, int iterations) {
+    for (int i = 0; i < iterations / 100; ++i) // aquecimento
+        fn(i);
+
+    const std::uint64_t alloc0 = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        fn(i);
+    auto end = std::chrono::steady_clock::now();
+    const std::uint64_t alloc1 = allocations.load();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    return BenchResult{name, ns, static_cast<double>(alloc1 - alloc0) / iterations, 1e9 / ns};
+}
+
+/**
+ * @class LoopbackReceiver
+ * @brief Socket UDP em 127.0.0.1 que descarta e conta os datagramas recebidos.
+ */
+class LoopbackReceiver {
+public:
+    LoopbackReceiver() : fd(-1), port(0), running(false), received(0) {
+        fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        int size = 8 << 20;
+        timeval tv{0, 100000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0 &&
+            getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) == 0)
+            port = ntohs(addr.sin_port);
+
+        running = true;
+        thread = std::thread([this] {
+            char buf[2048];
+            while (running.load(std::memory_order_relaxed))
+                if (recv(fd, buf, sizeof(buf), 0) > 0)
+                    received.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    ~LoopbackReceiver() {
+        running = false;
+        thread.join();
+        close(fd);
+    }
+
+    int getPort() const { return port; }                            /**< Porta local (0 = falha). */
+    std::uint64_t getReceived() const { return received.load(); }   /**< Datagramas recebidos. */
+
+private:
+    int fd;
+    int port;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> received;
+    std::thread thread;
+};
+
+/**
+ * @brief Lê o CSV de uma execução anterior (`nome,ns_op,allocs_op,ops_s`).
+ */
+static std::map<std::string, BenchResult> loadBaseline(const char *path) {
+    std::map<std::string, BenchResult> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        BenchResult r;
+        std::string ns, allocs, ops;
+        if (!std::getline(fields, r.name, ',') || !std::getline(fields, ns, ',') ||
+            !std::getline(fields, allocs, ',') || !std::getline(fields, ops, ','))
+            continue;
+        char *end;
+        r.nsPerOp = std::strtod(ns.c_str(), &end);
+        if (end == ns.c_str())
+            continue; // cabeçalho
+        r.allocsPerOp = std::strtod(allocs.c_str(), nullptr);
+        r.opsPerSecond = std::strtod(ops.c_str(), nullptr);
+        out[r.name] = r;
+    }
+    return out;
+}
+
+int main(int argc, char **argv) {
+    bool csv = false;
+    const char *baselinePath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)
+            baselinePath = argv[++i];
+    }
+
+    const int iterations = 200000;
+    std::vector<BenchResult> results;
+
+    // Arquivo sysfs falso: um valor do ADC em texto, como em in_voltageN_raw
+    std::string fakeSysfs = access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp";
+    fakeSysfs += "/bench_in_voltage13_raw";
+    {
+        std::ofstream f(fakeSysfs);
+        f << "2048\n";
+    }
+    SensorConfig cfg;
+    cfg.channelPath = fakeSysfs;
+    Sensor sensor(cfg);
+
+    results.push_back(measure("readRaw", [&](int) {
+        sink = static_cast<std::size_t>(sensor.readRaw());
+    }, iterations));
+
+    results.push_back(measure("convertRawToCelsius", [&](int i) {
+        sink = static_cast<std::size_t>(convertRawToCelsius(i & 0xFFFF));
+    }, iterations));
+
+    results.push_back(measure("currentTimestamp", [&](int) {
+        sink = currentTimestamp().size();
+    }, iterations));
+
+    char tsBuf[32];
+    results.push_back(measure("formatTimestampInto", [&](int) {
+        sink = formatTimestampInto(currentEpochNs(), TimestampPrecision::Milliseconds, tsBuf, sizeof(tsBuf));
+    }, iterations));
+
+    const std::string group = "grupo6", sensorId = "SensorDeTemperatura", unit = "°C";
+    results.push_back(measure("preparePacket", [&](int i) {
+        sink = DataFormatter::preparePacket(group, sensorId, 20.0 + i * 0.001, unit).timestamp.size();
+    }, iterations));
+
+    UdpPacket pkt = DataFormatter::preparePacket(group, sensorId, 25.0, unit);
+    const std::string prefix = jsonPrefix(group, sensorId);
+    char buf[512];
+
+    results.push_back(measure("serialize", [&](int i) {
+        pkt.value = 20.0 + i * 0.001;
+        sink = serialize(pkt).size();
+    }, iterations));
+
+    results.push_back(measure("serializeInto", [&](int i) {
+        pkt.value = 20.0 + i * 0.001;
+        sink = serializeInto(prefix, pkt, buf, sizeof(buf));
+    }, iterations));
+
+    AggregateConfig windowCfg;
+    windowCfg.windowS = 60.0;
+    windowCfg.slideS = 10.0;
+    windowCfg.percentiles = true;
+    WindowAggregator window(windowCfg);
+    const std::int64_t windowStart = currentEpochNs();
+    results.push_back(measure("windowAdd", [&](int i) {
+        sink = window.add(25.0 + (i % 100) * 0.01, windowStart + static_cast<std::int64_t>(i) * 1000000);
+    }, iterations));
+
+    AdaptiveRateConfig rateCfg;
+    rateCfg.minHz = 1.0;
+    rateCfg.maxHz = 1000.0;
+    rateCfg.slopeThreshold = 0.5;
+    rateCfg.residualThreshold = 0.5;
+    AdaptiveRateController rate(rateCfg, 1000.0);
+    results.push_back(measure("adaptiveRate", [&](int i) {
+        sink = rate.update(25.0 + (i % 100) * 0.01, static_cast<std::int64_t>(i) * 1000000) > 0.0;
+    }, iterations));
+
+    UdpPacket seqPkt = pkt;
+    seqPkt.session = 1;
+    RetransmitWindow retransmit(256, 1);
+    results.push_back(measure("sequencedStore", [&](int i) {
+        seqPkt.value = 20.0 + i * 0.001;
+        seqPkt.seq = static_cast<std::uint32_t>(i);
+        std::size_t n = serializeInto(prefix, seqPkt, buf, sizeof(buf));
+        retransmit.store(seqPkt.sensor_num, seqPkt.seq, buf, n);
+        sink = n;
+    }, iterations));
+
+    ShmConfig shmCfg;
+    shmCfg.name = "/bench_hotpath_readings";
+    ShmPublisher publisher;
+    ShmReadingsReader reader;
+    if (publisher.open(shmCfg, 1)) {
+        publisher.describe(0, sensorId, "°C", 1);
+        publisher.publish(0, 20.0, 0.0f, true, 0);
+        results.push_back(measure("shmPublish", [&](int i) {
+            publisher.publish(0, 20.0 + i * 0.001, static_cast<float>(i & 0xFFF), true,
+                              static_cast<std::int64_t>(i) * 1000000);
+        }, iterations));
+        if (reader.open(shmCfg.name.c_str())) {
+            ShmReading r;
+            results.push_back(measure("shmLatest", [&](int) {
+                sink = reader.latest(0, r) ? static_cast<std::size_t>(r.seq) : 0;
+            }, iterations));
+        }
+        reader.close();
+        publisher.close();
+    }
+
+    std::FILE *devNull = std::fopen("/dev/null", "w");
+    setLogOutput(devNull);
+    results.push_back(measure("logInfo", [&](int i) {
+        LOG_INFO("{}: {} leituras, {} prazos perdidos", sensorId, i, i & 7);
+    }, iterations));
+    flushLog();
+    setLogOutput(nullptr);
+    flushLog(); // nenhuma escrita em andamento usa mais o /dev/null
+    if (devNull)
+        std::fclose(devNull);
+
+    std::uint64_t sent = 0, delivered = 0;
+    {
+        LoopbackReceiver receiver;
+        if (receiver.getPort() == 0) {
+            std::fprintf(stderr, "Erro: não foi possível abrir o receptor em 127.0.0.1\n");
+            return 1;
+        }
+        UDPClient client("127.0.0.1", receiver.getPort());
+        const std::string json = serialize(pkt);
+
+        results.push_back(measure("sendData", [&](int) {
+            sink = client.sendData(json);
+        }, iterations));
+
+        results.push_back(measure("pipeline", [&](int) {
+            int raw = sensor.readRaw();
+            pkt.value = convertRawToCelsius(raw);
+            pkt.epoch_ns = currentEpochNs();
+            pkt.timestamp.assign(tsBuf, formatTimestampInto(pkt.epoch_ns, TimestampPrecision::Milliseconds,
+                                                             tsBuf, sizeof(tsBuf)));
+            std::size_t n = serializeInto(prefix, pkt, buf, sizeof(buf));
+            sink = client.sendData(buf, n);
+        }, iterations));
+
+        UDPClient fanout("127.0.0.1", receiver.getPort());
+        UdpDestination extra;
+        extra.address = "127.0.0.1";
+        extra.port = receiver.getPort();
+        fanout.addDestination(extra);
+        extra.encoding = WireEncoding::Binary;
+        fanout.addDestination(extra);
+        std::size_t jsonLen = serializeInto(prefix, pkt, buf, sizeof(buf));
+
+        results.push_back(measure("sendToAll", [&](int) {
+            sink = fanout.sendToAll(pkt, buf, jsonLen);
+        }, iterations));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        sent = client.getStats().datagrams + fanout.getStats().datagrams;
+        delivered = receiver.getReceived();
+    }
+    unlink(fakeSysfs.c_str());
+
+    if (csv) {
+        std::printf("nome,ns_op,allocs_op,ops_s\n");
+        for (const BenchResult &r : results)
+            std::printf("%s,%.2f,%.3f,%.0f\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.opsPerSecond);
+    } else {
+        std::printf("%-22s %10s %10s %12s\n", "caso", "ns/op", "allocs/op", "ops/s");
+        for (const BenchResult &r : results)
+            std::printf("%-22s %10.1f %10.2f %12.0f\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.opsPerSecond);
+        std::printf("datagramas enviados: %llu, recebidos no loopback: %llu\n",
+                    static_cast<unsigned long long>(sent), static_cast<unsigned long long>(delivered));
+    }
+
+    std::fflush(stdout);
+    if (!baselinePath)
+        return 0;
+
+    std::map<std::string, BenchResult> baseline = loadBaseline(baselinePath);
+    if (baseline.empty()) {
+        std::fprintf(stderr, "Erro: referência vazia ou ilegível: %s\n", baselinePath);
+        return 1;
+    }
+    int regressions = 0;
+    for (const BenchResult &r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end())
+            continue;
+        const double change = r.nsPerOp / it->second.nsPerOp - 1.0;
+        const bool slower = change > REGRESSION_THRESHOLD;
+        const bool moreAllocs = r.allocsPerOp > it->second.allocsPerOp + 0.01;
+        if (slower || moreAllocs)
+            ++regressions;
+        std::fprintf(stderr, "%-22s %+7.1f%% ns/op, allocs/op %.2f -> %.2f%s\n", r.name.c_str(),
+                     change * 100.0, it->second.allocsPerOp, r.allocsPerOp,
+                     slower || moreAllocs ? "  REGRESSAO" : "");
+    }
+    return regressions ? 1 : 0;
+}
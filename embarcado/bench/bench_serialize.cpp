@@ -0,0 +1,100 @@
+/**
+ * @file bench_serialize.cpp
+ * @brief Benchmark da serialização JSON de `UdpPacket`.
+ *
+ * Compara a implementação original (`std::ostringstream`) com `serialize()`
+ * e `serializeInto()` (com e sem prefixo pré-calculado) e confere que a
+ * saída é idêntica byte a byte.
+ *
+ * Compilação (a partir da raiz do projeto):
+ * @code
+ * g++ -std=c++17 -O2 embarcado/bench/bench_serialize.cpp -o build/bench_serialize
+ * @endcode
+ */
+
+#include "../include/udp_protocol.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * @brief Serialização original, baseada em `std::ostringstream`, usada como referência.
+ */
+static std::string serializeStream(const UdpPacket &p) {
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"group\":\"" << p.group_id << "\",";
+    oss << "\"sensor_id\":\"" << p.sensor_id << "\",";
+    oss << "\"value\":" << std::fixed << std::setprecision(2) << p.value << ",";
+    oss << "\"unit\":\"" << p.unit << "\",";
+    oss << "\"ts\":\"" << p.timestamp << "\"";
+    oss << "}";
+    return oss.str();
+}
+
+/**
+ * @brief Evita que o compilador descarte o resultado medido.
+ */
+static volatile std::size_t sink;
+
+/**
+ * @brief Executa `fn(i)` para i em [0, iterations) e retorna ns por chamada.
+ */
+template <typename Fn>
+static double measure(Fn fn, int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        fn(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int main() {
+    const int iterations = 1000000;
+
+    UdpPacket pkt;
+    pkt.group_id = "grupo6";
+    pkt.sensor_id = "SensorDeTemperatura";
+    pkt.unit = "°C";
+    pkt.timestamp = currentTimestamp();
+
+    const std::string prefix = jsonPrefix(pkt.group_id, pkt.sensor_id);
+    char buf[512];
+
+    int mismatches = 0;
+    for (int i = 0; i < iterations; ++i) {
+        pkt.value = -40.0 + i * 0.000173;
+        std::size_t n = serializeInto(prefix, pkt, buf, sizeof(buf));
+        if (serializeStream(pkt) != std::string(buf, n))
+            ++mismatches;
+    }
+    std::printf("divergencias com o formato original: %d de %d\n", mismatches, iterations);
+
+    double streamNs = measure([&](int i) {
+        pkt.value = 20.0 + i * 0.001;
+        sink = serializeStream(pkt).size();
+    }, iterations);
+
+    double stringNs = measure([&](int i) {
+        pkt.value = 20.0 + i * 0.001;
+        sink = serialize(pkt).size();
+    }, iterations);
+
+    double intoNs = measure([&](int i) {
+        pkt.value = 20.0 + i * 0.001;
+        sink = serializeInto(pkt, buf, sizeof(buf));
+    }, iterations);
+
+    double prefixNs = measure([&](int i) {
+        pkt.value = 20.0 + i * 0.001;
+        sink = serializeInto(prefix, pkt, buf, sizeof(buf));
+    }, iterations);
+
+    std::printf("%-22s %10s %10s\n", "metodo", "ns/pacote", "speedup");
+    std::printf("%-22s %10.1f %10.2f\n", "ostringstream", streamNs, 1.0);
+    std::printf("%-22s %10.1f %10.2f\n", "serialize()", stringNs, streamNs / stringNs);
+    std::printf("%-22s %10.1f %10.2f\n", "serializeInto()", intoNs, streamNs / intoNs);
+    std::printf("%-22s %10.1f %10.2f\n", "serializeInto(prefixo)", prefixNs, streamNs / prefixNs);
+    return mismatches == 0 ? 0 : 1;
+}
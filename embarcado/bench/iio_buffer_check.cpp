@@ -0,0 +1,236 @@
+/**
+ * @file iio_buffer_check.cpp
+ * @brief Verificação do `IioBuffer` sem a placa: sysfs falso, arquivo de amostras e FIFO.
+ *
+ * Monta em um diretório temporário um sysfs de mentira (`scan_elements`
+ * com `in_voltage13_type` e `in_timestamp_en` ligado, `buffer/`,
+ * `trigger/`) e confere:
+ *  - a decodificação de cada formato (ordem dos bytes, deslocamento e
+ *    máscara dos bits válidos, saturação de 32 bits em 16);
+ *  - que amostras com sinal negativas saem como 0 e são contadas;
+ *  - que `open()` desliga os outros elementos e liga só o canal;
+ *  - que uma amostra cortada entre duas leituras de um FIFO é remontada.
+ *
+ * Mostra cada verificação que falhou e, nesse caso, termina com código 1.
+ *
+ * Uso:
+ * @code
+ * ./build/iio_buffer_check
+ * @endcode
+ *
+ * Compilação: ver `run_benchmarks.sh`.
+ */
+
+#include "../include/iio_buffer.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Número de verificações que falharam. */
+static int failures = 0;
+
+/**
+ * @brief Registra uma verificação; mostra a mensagem se ela falhou.
+ */
+static void check(bool ok, const std::string &what) {
+    if (!ok) {
+        std::fprintf(stderr, "FALHA: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+static void writeFile(const std::string &path, const std::string &text) {
+    std::ofstream(path) << text;
+}
+
+static std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    std::string text;
+    std::getline(file, text);
+    return text;
+}
+
+static void writeBytes(const std::string &path, const std::vector<std::uint8_t> &bytes) {
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(bytes.data()),
+                                                static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ * @brief Acrescenta `word` em `bytes` com `size` bytes na ordem pedida.
+ */
+static void put(std::vector<std::uint8_t> &bytes, std::uint32_t word, unsigned size, bool bigEndian) {
+    for (unsigned b = 0; b < size; ++b) {
+        const unsigned byte = bigEndian ? size - 1 - b : b;
+        bytes.push_back(static_cast<std::uint8_t>(word >> (8 * byte)));
+    }
+}
+
+/**
+ * @brief Lê todas as amostras de um arquivo com o formato `type` e compara com `expected`.
+ */
+static void checkFormat(const std::string &dir, const std::string &type, const std::vector<std::uint8_t> &bytes,
+                        const std::vector<std::uint16_t> &expected, std::uint64_t expectedNegatives = 0) {
+    const std::string path = dir + "/amostras.bin";
+    writeBytes(path, bytes);
+
+    IioBufferConfig cfg;
+    cfg.devicePath = path;
+    cfg.sysfsDir.clear();
+    cfg.scanType = type;
+    IioBuffer buffer;
+    if (!buffer.open(cfg)) {
+        check(false, type + ": open()");
+        return;
+    }
+
+    std::vector<std::uint16_t> got(expected.size() + 4);
+    const int n = buffer.readBlock(got.data(), got.size());
+    check(n == static_cast<int>(expected.size()), type + ": número de amostras");
+    for (std::size_t i = 0; n > 0 && i < expected.size() && i < static_cast<std::size_t>(n); ++i)
+        check(got[i] == expected[i], type + ": amostra " + std::to_string(i) + " = " + std::to_string(got[i]) +
+                                         ", esperado " + std::to_string(expected[i]));
+    check(buffer.negativeSamples() == expectedNegatives, type + ": amostras negativas contadas");
+}
+
+int main() {
+    char tmpl[] = "/tmp/iio_check_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    const std::string dir = tmpl;
+
+    // Formatos: valores de teste com bits fora da máscara ligados
+    {
+        std::vector<std::uint8_t> b;
+        for (std::uint32_t v : {0u, 1u, 4095u, 65535u})
+            put(b, v, 2, false);
+        checkFormat(dir, "le:u16/16>>0", b, {0, 1, 4095, 65535});
+    }
+    {
+        std::vector<std::uint8_t> b;
+        for (std::uint32_t v : {0u, 0x123u, 0xFFFu})
+            put(b, (v << 4) | 0xFu, 2, true); // bits abaixo do deslocamento ligados
+        checkFormat(dir, "be:u12/16>>4", b, {0, 0x123, 0xFFF});
+    }
+    {
+        std::vector<std::uint8_t> b;
+        for (std::uint32_t v : {5u, 0x3FFu})
+            put(b, 0xF000u | (v << 2) | 0x3u, 2, false); // bits acima dos válidos ligados
+        checkFormat(dir, "le:u10/16>>2", b, {5, 0x3FF});
+    }
+    {
+        std::vector<std::uint8_t> b;
+        for (std::uint32_t v : {70000u, 1234u})
+            put(b, v, 4, true);
+        checkFormat(dir, "be:u32/32>>0", b, {65535, 1234});
+    }
+    {
+        // s12: 0x7FF é o maior positivo; 0x800 e 0xFFF (-2048 e -1) são negativos
+        std::vector<std::uint8_t> b;
+        for (std::uint32_t v : {0x7FFu, 0x800u, 0x10u, 0xFFFu})
+            put(b, v << 4, 2, false);
+        checkFormat(dir, "le:s12/16>>4", b, {0x7FF, 0, 0x10, 0}, 2);
+    }
+
+    // sysfs falso: o formato vem de in_voltage13_type e o timestamp precisa ser desligado
+    {
+        const std::string sysfs = dir + "/iio:device0";
+        for (const char *sub : {"", "/scan_elements", "/buffer", "/trigger"})
+            mkdir((sysfs + sub).c_str(), 0755);
+        writeFile(sysfs + "/scan_elements/in_voltage13_en", "0\n");
+        writeFile(sysfs + "/scan_elements/in_voltage13_type", "be:u12/16>>4\n");
+        writeFile(sysfs + "/scan_elements/in_voltage2_en", "1\n");
+        writeFile(sysfs + "/scan_elements/in_timestamp_en", "1\n");
+        writeFile(sysfs + "/buffer/enable", "0\n");
+        writeFile(sysfs + "/buffer/length", "0\n");
+        writeFile(sysfs + "/trigger/current_trigger", "\n");
+
+        std::vector<std::uint8_t> b;
+        put(b, 0xABCu << 4, 2, true);
+        const std::string device = dir + "/device";
+        writeBytes(device, b);
+
+        IioBufferConfig cfg;
+        cfg.devicePath = device;
+        cfg.sysfsDir = sysfs;
+        cfg.bufferLength = 32;
+        IioBuffer buffer;
+        check(buffer.open(cfg), "sysfs: open()");
+        check(readFile(sysfs + "/scan_elements/in_voltage13_en") == "1", "sysfs: canal habilitado");
+        check(readFile(sysfs + "/scan_elements/in_voltage2_en") == "0", "sysfs: outro canal desligado");
+        check(readFile(sysfs + "/scan_elements/in_timestamp_en") == "0", "sysfs: timestamp desligado");
+        check(readFile(sysfs + "/buffer/length") == "32", "sysfs: buffer/length");
+        check(readFile(sysfs + "/buffer/enable") == "1", "sysfs: buffer habilitado");
+        std::uint16_t v = 0;
+        check(buffer.readBlock(&v, 1) == 1 && v == 0xABC, "sysfs: formato lido de in_voltage13_type");
+        buffer.close();
+        check(readFile(sysfs + "/buffer/enable") == "0", "sysfs: buffer desabilitado ao fechar");
+    }
+
+    // FIFO: amostras de 4 bytes escritas em pedaços que as cortam ao meio
+    {
+        const std::string fifo = dir + "/fifo";
+        mkfifo(fifo.c_str(), 0600);
+        const std::size_t count = 200;
+        std::vector<std::uint8_t> b;
+        for (std::uint32_t i = 0; i < count; ++i)
+            put(b, i * 300u, 4, false);
+
+        std::thread writer([&] {
+            const int fd = ::open(fifo.c_str(), O_WRONLY);
+            const std::size_t pieces[] = {3, 5, 1, 7, 2, 11};
+            for (std::size_t off = 0, k = 0; off < b.size(); ++k) {
+                std::size_t n = pieces[k % 6];
+                if (n > b.size() - off)
+                    n = b.size() - off;
+                if (::write(fd, b.data() + off, n) != static_cast<ssize_t>(n))
+                    break;
+                off += n;
+                usleep(200); // cada pedaço chega em uma leitura diferente
+            }
+            ::close(fd);
+        });
+
+        IioBufferConfig cfg;
+        cfg.devicePath = fifo;
+        cfg.sysfsDir.clear();
+        cfg.scanType = "le:u32/32>>0";
+        cfg.bufferLength = 16;
+        IioBuffer buffer;
+        std::vector<std::uint16_t> got;
+        int calls = 0;
+        if (buffer.open(cfg)) {
+            // 0 tanto para um pedaço sem amostra completa quanto para o fim do FIFO: o limite encerra
+            std::uint16_t block[16];
+            for (int n; got.size() < count && calls < 100000; ++calls) {
+                if ((n = buffer.readBlock(block, 16)) < 0)
+                    break;
+                got.insert(got.end(), block, block + n);
+            }
+        } else {
+            check(false, "fifo: open()");
+        }
+        writer.join();
+
+        check(got.size() == count, "fifo: " + std::to_string(got.size()) + " amostras, esperado " + std::to_string(count));
+        for (std::size_t i = 0; i < got.size() && i < count; ++i)
+            check(got[i] == static_cast<std::uint16_t>(i * 300u > 65535u ? 65535u : i * 300u),
+                  "fifo: amostra " + std::to_string(i));
+        check(calls > static_cast<int>(count / 16), "fifo: leituras parciais (" + std::to_string(calls) + " chamadas)");
+    }
+
+    std::string cleanup = "rm -rf '" + dir + "'";
+    if (std::system(cleanup.c_str()) != 0)
+        std::fprintf(stderr, "Aviso: não foi possível remover %s\n", dir.c_str());
+
+    std::printf("iio_buffer_check: %s\n", failures ? "FALHOU" : "ok");
+    return failures ? 1 : 0;
+}
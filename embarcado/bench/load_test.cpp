@@ -0,0 +1,193 @@
+/**
+ * @file load_test.cpp
+ * @brief Teste de carga sem a placa: fonte sintética ou captura → conversão → JSON → UDP.
+ *
+ * Lê blocos de amostras de um `Sensor` com uma `RawSource` (sem espera
+ * entre blocos), converte em lote, serializa cada leitura com
+ * `serializeInto()` e envia os datagramas com `UDPClient::sendBatch()`
+ * para um receptor em 127.0.0.1. Mostra a vazão total e o tempo de cada
+ * etapa, e serve de alvo para `perf record`.
+ *
+ * Em seguida, envia registros binários de tamanho fixo com
+ * `UDPClient::sendSegmented()` (GSO, 64 segmentos por chamada) e confere
+ * que o receptor contou um datagrama por segmento; termina com código 1
+ * se não contou.
+ *
+ * Uso:
+ * @code
+ * ./build/load_test [fonte] [amostras]
+ * ./build/load_test synthetic:sine,noise=20,error=0.001 5000000
+ * ./build/load_test replay:captura.bin 1000000
+ * @endcode
+ *
+ * Compilação: ver `run_benchmarks.sh`.
+ */
+
+#include "../include/sensor.hpp"
+#include "../include/udp_client.hpp"
+#include "../include/udp_protocol.hpp"
+#include "../include/binary_protocol.hpp"
+#include "../include/utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/** Amostras por bloco lido da fonte (e datagramas por `sendBatch()`). */
+static const std::size_t BLOCK = 64;
+
+/** Espaço reservado para cada datagrama JSON. */
+static const std::size_t DATAGRAM_CAP = 256;
+
+/** Segmentos por chamada de `sendSegmented()` (o máximo do GSO no cliente). */
+static const std::size_t GSO_SEGMENTS = 64;
+
+/** Chamadas de `sendSegmented()` no caso GSO. */
+static const std::size_t GSO_ROUNDS = 2000;
+
+/**
+ * @brief Nanossegundos decorridos desde `start`.
+ */
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    const std::string spec = argc > 1 ? argv[1] : "synthetic:sine,noise=20";
+    const std::size_t total = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 2000000;
+
+    std::unique_ptr<RawSource> src = makeRawSource(spec);
+    if (!src)
+        return 1;
+    SensorConfig cfg;
+    Sensor sensor(cfg, std::move(src));
+
+    // Receptor em loopback que apenas conta os datagramas
+    int rx = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    int rcvbuf = 16 << 20;
+    timeval tv{0, 100000};
+    setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (bind(rx, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        getsockname(rx, reinterpret_cast<sockaddr *>(&addr), &addrLen) < 0) {
+        std::fprintf(stderr, "Erro: não foi possível abrir o receptor em 127.0.0.1\n");
+        return 1;
+    }
+    std::atomic<bool> running(true);
+    std::atomic<std::uint64_t> received(0);
+    std::thread receiver([&] {
+        char buf[2048];
+        while (running.load(std::memory_order_relaxed))
+            if (recv(rx, buf, sizeof(buf), 0) > 0)
+                received.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    UDPClient client("127.0.0.1", ntohs(addr.sin_port));
+    client.setNonBlocking(true); // mede o que o kernel aceita; o excesso é descartado e contado
+
+    UdpPacket pkt;
+    pkt.group_id = cfg.groupId;
+    pkt.sensor_id = cfg.sensorId;
+    pkt.unit = cfg.unit;
+    const std::string prefix = jsonPrefix(pkt.group_id, pkt.sensor_id);
+
+    std::uint16_t raw[BLOCK];
+    float celsius[BLOCK];
+    char tsBuf[32];
+    std::vector<char> datagrams(BLOCK * DATAGRAM_CAP);
+    iovec iov[BLOCK];
+
+    double readNs = 0, convertNs = 0, serializeNs = 0, sendNs = 0;
+    std::size_t done = 0, sent = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (done < total) {
+        auto t = std::chrono::steady_clock::now();
+        int n = sensor.readRawBlock(raw, total - done < BLOCK ? total - done : BLOCK);
+        readNs += elapsedNs(t);
+        if (n <= 0)
+            break; // captura terminou (modo `once`)
+
+        t = std::chrono::steady_clock::now();
+        sensor.convertBlock(raw, celsius, static_cast<std::size_t>(n));
+        convertNs += elapsedNs(t);
+
+        t = std::chrono::steady_clock::now();
+        pkt.epoch_ns = currentEpochNs();
+        pkt.timestamp.assign(tsBuf, formatTimestampInto(pkt.epoch_ns, TimestampPrecision::Milliseconds,
+                                                        tsBuf, sizeof(tsBuf)));
+        for (int i = 0; i < n; ++i) {
+            pkt.value = celsius[i];
+            iov[i].iov_base = &datagrams[i * DATAGRAM_CAP];
+            iov[i].iov_len = serializeInto(prefix, pkt, &datagrams[i * DATAGRAM_CAP], DATAGRAM_CAP);
+        }
+        serializeNs += elapsedNs(t);
+
+        t = std::chrono::steady_clock::now();
+        sent += client.sendBatch(iov, static_cast<std::size_t>(n));
+        sendNs += elapsedNs(t);
+
+        done += static_cast<std::size_t>(n);
+    }
+    const double totalNs = elapsedNs(start);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // GSO: um buffer de registros binários de tamanho fixo vira um datagrama por segmento
+    std::uint8_t records[GSO_SEGMENTS * BINARY_PACKET_SIZE];
+    for (std::size_t i = 0; i < GSO_SEGMENTS; ++i) {
+        pkt.value = celsius[i % BLOCK];
+        encodeBinary(pkt, records + i * BINARY_PACKET_SIZE, BINARY_PACKET_SIZE);
+    }
+    const UdpSendStats before = client.getStats();
+    const std::uint64_t receivedBefore = received.load();
+    std::size_t gsoSent = 0;
+    double gsoNs = 0;
+    for (std::size_t r = 0; r < GSO_ROUNDS; ++r) {
+        auto t = std::chrono::steady_clock::now();
+        gsoSent += client.sendSegmented(records, sizeof(records), static_cast<std::uint16_t>(BINARY_PACKET_SIZE));
+        gsoNs += elapsedNs(t);
+        // Espera o receptor: 64 datagramas pequenos de uma vez lotam o buffer dele, e a contagem deixaria de ser exata
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+        while (received.load(std::memory_order_relaxed) - receivedBefore < gsoSent &&
+               std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const std::uint64_t gsoReceived = received.load() - receivedBefore;
+
+    running = false;
+    receiver.join();
+    close(rx);
+
+    std::printf("fonte: %s\n", spec.c_str());
+    std::printf("amostras: %zu em %.3f s = %.2f M/s\n", done, totalNs / 1e9, done / totalNs * 1e3);
+    std::printf("%-12s %10s %12s\n", "etapa", "ns/amostra", "M amostras/s");
+    const char *names[] = {"leitura", "conversao", "serializacao", "envio"};
+    const double stages[] = {readNs, convertNs, serializeNs, sendNs};
+    for (int i = 0; i < 4; ++i)
+        std::printf("%-12s %10.1f %12.2f\n", names[i], stages[i] / done, done / stages[i] * 1e3);
+    std::printf("datagramas aceitos: %zu, descartados (EAGAIN): %llu, recebidos: %llu\n", sent,
+                static_cast<unsigned long long>(client.getStats().eagainDrops),
+                static_cast<unsigned long long>(receivedBefore));
+
+    const UdpSendStats &after = client.getStats();
+    std::printf("GSO: %zu datagramas em %llu chamadas (%.1f ns/datagrama), recebidos: %llu, refeitos sem GSO: %llu\n",
+                gsoSent, static_cast<unsigned long long>(after.calls - before.calls), gsoNs / GSO_SEGMENTS / GSO_ROUNDS,
+                static_cast<unsigned long long>(gsoReceived),
+                static_cast<unsigned long long>(after.gsoFallbacks - before.gsoFallbacks));
+    if (gsoReceived != gsoSent) {
+        std::fprintf(stderr, "Erro: o receptor contou %llu datagramas, mas %zu segmentos foram aceitos\n",
+                     static_cast<unsigned long long>(gsoReceived), gsoSent);
+        return 1;
+    }
+    return 0;
+}
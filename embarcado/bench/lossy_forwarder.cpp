@@ -0,0 +1,163 @@
+/**
+ * @file lossy_forwarder.cpp
+ * @brief Repassador UDP com perdas e reordenação, para testar sequência e NACK sem uma rede ruim.
+ *
+ * Fica entre os sensores e o coletor: recebe na porta local, descarta cada
+ * datagrama com probabilidade `perda`, troca a ordem de dois datagramas
+ * consecutivos com probabilidade `reordem` e repassa o resto ao destino.
+ * As respostas do destino (NACKs) voltam ao último remetente sem perdas.
+ *
+ * Uso:
+ * @code
+ * ./build/lossy_forwarder <porta local> <ip destino> <porta destino> [perda] [reordem] [semente]
+ * ./build/coletor --nack 5000 1 &
+ * ./build/lossy_forwarder 6000 127.0.0.1 5000 0.05 0.02 &
+ * SENSOR_SEQUENCE=1 UDP_SERVER=127.0.0.1:6000 ./build/sensor
+ * @endcode
+ *
+ * A cada 5 s (e ao encerrar com Ctrl+C), mostra os datagramas recebidos,
+ * repassados, descartados e reordenados, e as respostas devolvidas.
+ *
+ * Compilação: ver `run_benchmarks.sh`.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/** Intervalo entre relatórios, em segundos. */
+static const int REPORT_INTERVAL_S = 5;
+
+/** Tempo máximo que um datagrama fica retido para ser reordenado, em ms. */
+static const int HOLD_TIMEOUT_MS = 100;
+
+/** Pedido de encerramento (Ctrl+C ou SIGTERM). */
+static std::atomic<bool> stopRequested(false);
+
+static void onSignal(int) {
+    stopRequested = true;
+}
+
+/**
+ * @struct ForwarderStats
+ * @brief Contadores do repassador.
+ */
+struct ForwarderStats {
+    unsigned long long received = 0;   /**< Datagramas recebidos dos remetentes. */
+    unsigned long long forwarded = 0;  /**< Datagramas repassados ao destino. */
+    unsigned long long dropped = 0;    /**< Datagramas descartados. */
+    unsigned long long reordered = 0;  /**< Datagramas retidos e repassados depois do seguinte. */
+    unsigned long long replies = 0;    /**< Respostas do destino devolvidas ao remetente. */
+};
+
+static void report(const ForwarderStats &st) {
+    std::printf("recebidos: %llu, repassados: %llu, descartados: %llu, reordenados: %llu, respostas: %llu\n",
+                st.received, st.forwarded, st.dropped, st.reordered, st.replies);
+    std::fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 4) {
+        std::fprintf(stderr, "Uso: %s <porta local> <ip destino> <porta destino> [perda] [reordem] [semente]\n", argv[0]);
+        return 1;
+    }
+    const int localPort = std::atoi(argv[1]);
+    const double loss = argc > 4 ? std::atof(argv[4]) : 0.05;
+    const double reorder = argc > 5 ? std::atof(argv[5]) : 0.02;
+    std::mt19937 rng(argc > 6 ? static_cast<unsigned>(std::atoi(argv[6])) : 1u);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    int in = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(static_cast<std::uint16_t>(localPort));
+    if (in < 0 || bind(in, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0) {
+        std::fprintf(stderr, "Erro: não foi possível abrir a porta UDP %d\n", localPort);
+        return 1;
+    }
+
+    int out = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(static_cast<std::uint16_t>(std::atoi(argv[3])));
+    if (out < 0 || inet_pton(AF_INET, argv[2], &dest.sin_addr) != 1 ||
+        connect(out, reinterpret_cast<sockaddr *>(&dest), sizeof(dest)) < 0) {
+        std::fprintf(stderr, "Erro: destino inválido: %s:%s\n", argv[2], argv[3]);
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::printf("Repassando :%d -> %s:%s (perda %.3f, reordem %.3f)\n", localPort, argv[2], argv[3], loss, reorder);
+
+    ForwarderStats st;
+    sockaddr_storage peer{};
+    socklen_t peerLen = 0;
+    char buf[65536];
+    char held[65536];
+    ssize_t heldLen = -1;
+    time_t nextReport = time(nullptr) + REPORT_INTERVAL_S;
+
+    pollfd fds[2] = {{in, POLLIN, 0}, {out, POLLIN, 0}};
+    while (!stopRequested) {
+        int ready = poll(fds, 2, HOLD_TIMEOUT_MS);
+        if (ready == 0 && heldLen >= 0) {
+            // Nada chegou depois do datagrama retido: repassa-o mesmo assim
+            if (send(out, held, static_cast<std::size_t>(heldLen), 0) >= 0)
+                ++st.forwarded;
+            heldLen = -1;
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            sockaddr_storage from{};
+            socklen_t fromLen = sizeof(from);
+            ssize_t n = recvfrom(in, buf, sizeof(buf), 0, reinterpret_cast<sockaddr *>(&from), &fromLen);
+            if (n >= 0) {
+                ++st.received;
+                peer = from;
+                peerLen = fromLen;
+                if (coin(rng) < loss) {
+                    ++st.dropped;
+                } else if (heldLen < 0 && coin(rng) < reorder) {
+                    std::copy(buf, buf + n, held);
+                    heldLen = n;
+                    ++st.reordered;
+                } else {
+                    if (send(out, buf, static_cast<std::size_t>(n), 0) >= 0)
+                        ++st.forwarded;
+                    if (heldLen >= 0 && send(out, held, static_cast<std::size_t>(heldLen), 0) >= 0)
+                        ++st.forwarded;
+                    heldLen = -1;
+                }
+            }
+        }
+
+        if (ready > 0 && (fds[1].revents & POLLIN)) {
+            ssize_t n = recv(out, buf, sizeof(buf), 0);
+            if (n >= 0 && peerLen > 0 &&
+                sendto(in, buf, static_cast<std::size_t>(n), 0, reinterpret_cast<sockaddr *>(&peer), peerLen) >= 0)
+                ++st.replies;
+        }
+
+        if (time(nullptr) >= nextReport) {
+            nextReport += REPORT_INTERVAL_S;
+            report(st);
+        }
+    }
+
+    report(st);
+    close(in);
+    close(out);
+    return 0;
+}
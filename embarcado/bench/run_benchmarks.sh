@@ -0,0 +1,41 @@
+#!/bin/sh
+# Compila e executa os benchmarks do lado embarcado (a partir da raiz do projeto).
+#
+# Uso: embarcado/bench/run_benchmarks.sh [argumentos do bench_hotpath]
+#   ex: embarcado/bench/run_benchmarks.sh --csv > bench_atual.csv
+#       embarcado/bench/run_benchmarks.sh --baseline bench_anterior.csv
+#
+# CXX pode apontar para outro compilador (ex: CXX=arm-linux-g++ para gerar na placa).
+set -e
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++17 -O2"}
+SRC=embarcado/src
+OUT=build
+
+mkdir -p "$OUT"
+$CXX $CXXFLAGS -pthread embarcado/bench/bench_hotpath.cpp $SRC/sensor.cpp $SRC/utils.cpp \
+    $SRC/iio_buffer.cpp $SRC/filters.cpp $SRC/raw_source.cpp $SRC/data_formatter.cpp $SRC/udp_client.cpp \
+    $SRC/window_aggregator.cpp $SRC/adaptive_rate.cpp $SRC/retransmit_window.cpp $SRC/logger.cpp \
+    $SRC/shm_publisher.cpp -o "$OUT/bench_hotpath"
+$CXX $CXXFLAGS -pthread embarcado/bench/load_test.cpp $SRC/sensor.cpp $SRC/utils.cpp $SRC/iio_buffer.cpp \
+    $SRC/filters.cpp $SRC/raw_source.cpp $SRC/udp_client.cpp $SRC/logger.cpp -o "$OUT/load_test"
+$CXX $CXXFLAGS embarcado/bench/bench_conversion.cpp $SRC/utils.cpp -o "$OUT/bench_conversion"
+$CXX $CXXFLAGS embarcado/bench/bench_serialize.cpp -o "$OUT/bench_serialize"
+$CXX $CXXFLAGS embarcado/bench/lossy_forwarder.cpp -o "$OUT/lossy_forwarder"
+$CXX $CXXFLAGS -pthread embarcado/bench/iio_buffer_check.cpp $SRC/iio_buffer.cpp $SRC/logger.cpp \
+    -o "$OUT/iio_buffer_check"
+
+# Com --csv, apenas o CSV do caminho principal vai para a saída padrão
+case " $* " in
+    *" --csv "*)
+        "$OUT/bench_hotpath" "$@"
+        ;;
+    *)
+        "$OUT/iio_buffer_check"
+        "$OUT/bench_conversion"
+        "$OUT/bench_serialize"
+        "$OUT/bench_hotpath" "$@"
+        "$OUT/load_test"
+        ;;
+esac
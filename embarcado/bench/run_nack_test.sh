@@ -0,0 +1,66 @@
+#!/bin/sh
+# Teste de ponta a ponta da sequência e dos NACKs (a partir da raiz do projeto).
+#
+# Sobe o coletor com --nack, o lossy_forwarder no meio e o sensor com uma
+# fonte sintética, uma vez com o servidor principal em JSON e outra em
+# binário (UDP_SERVER=...,binary). Falha se o coletor não recuperar lacunas
+# por retransmissão ou se as leituras do sensor aparecerem sob mais de uma
+# chave (um reenvio em outro formato vira um sensor fantasma).
+#
+# Uso: embarcado/bench/run_nack_test.sh [segundos por modo]
+set -e
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++17 -O2"}
+OUT=build
+DURATION=${1:-6}
+COLLECTOR_PORT=5700
+FORWARDER_PORT=6700
+
+mkdir -p "$OUT"
+$CXX $CXXFLAGS -pthread embarcado/src/*.cpp -o "$OUT/sensor"
+$CXX $CXXFLAGS -pthread coletor/src/*.cpp -o "$OUT/coletor"
+$CXX $CXXFLAGS embarcado/bench/lossy_forwarder.cpp -o "$OUT/lossy_forwarder"
+
+collector=
+forwarder=
+trap 'kill $collector $forwarder 2>/dev/null || true' EXIT
+
+status=0
+for encoding in json binary; do
+    suffix=
+    [ "$encoding" = binary ] && suffix=",binary"
+    log="$OUT/nack_test_$encoding.log"
+
+    "$OUT/coletor" --nack $COLLECTOR_PORT 1 > "$log" 2>&1 &
+    collector=$!
+    "$OUT/lossy_forwarder" $FORWARDER_PORT 127.0.0.1 $COLLECTOR_PORT 0.05 0.02 1 > /dev/null 2>&1 &
+    forwarder=$!
+    sleep 1
+
+    SENSOR_SEQUENCE=1 UDP_SERVER="127.0.0.1:$FORWARDER_PORT$suffix" SENSOR_SOURCE=synthetic:sine SENSOR_RATE_HZ=200 \
+        timeout "$DURATION" "$OUT/sensor" > /dev/null 2>&1 || true
+
+    # Ctrl+C faz o coletor mostrar o relatório final
+    kill -INT $collector
+    wait $collector || true
+    kill $forwarder
+    wait $forwarder 2>/dev/null || true
+    collector=
+    forwarder=
+
+    keys=$(grep '^  ' "$log" | sed 's/: .*//' | sort -u)
+    recovered=$(sed -n 's/.* \([0-9]*\)\/[0-9]* retransmitidas.*/\1/p' "$log" | tail -n 1)
+    echo "$encoding: chaves [$(echo $keys)], retransmitidas recuperadas: ${recovered:-0}"
+
+    if [ "$(echo "$keys" | grep -c .)" -ne 1 ]; then
+        echo "FALHA ($encoding): leituras de um sensor sob mais de uma chave" >&2
+        status=1
+    fi
+    if [ "${recovered:-0}" -eq 0 ]; then
+        echo "FALHA ($encoding): nenhuma lacuna recuperada por NACK" >&2
+        status=1
+    fi
+done
+
+exit $status
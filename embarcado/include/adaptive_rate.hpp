@@ -0,0 +1,124 @@
+/**
+ * @file adaptive_rate.hpp
+ * @brief Frequência de amostragem adaptativa: lê mais rápido quando o sinal muda.
+ *
+ * Com temperatura estável, ler a 1 Hz gasta CPU, ADC e rede à toa; num
+ * transiente rápido, 1 Hz é pouco. O controlador acompanha, para cada
+ * sensor, o nível suavizado, a tendência (taxa de variação, em unidades
+ * por segundo) e a variância dos resíduos em torno do nível. Se a
+ * tendência ou o desvio dos resíduos passar do limiar, a frequência é
+ * multiplicada por `upFactor` (até `maxHz`); se ambos ficarem abaixo de
+ * `hysteresis` × limiar por `holdS` segundos, ela é multiplicada por
+ * `downFactor` (até `minHz`), um passo a cada `holdS`.
+ *
+ * As estimativas usam médias exponenciais com constante de tempo
+ * `smoothingS` (e não de amostras), para que o ruído visto na tendência
+ * não cresça com a própria frequência de amostragem.
+ */
+
+#ifndef ADAPTIVE_RATE_HPP
+#define ADAPTIVE_RATE_HPP
+
+#include <cstdint>
+
+/**
+ * @struct AdaptiveRateConfig
+ * @brief Parâmetros da frequência adaptativa de um sensor.
+ *
+ * Com `minHz` em zero (padrão), a frequência fica fixa em
+ * `SensorConfig::sampleRateHz`. Um limiar em zero desativa o critério
+ * correspondente.
+ */
+struct AdaptiveRateConfig {
+    double minHz = 0.0;              /**< Frequência mínima, com o sinal estável (0 = desativado). */
+    double maxHz = 0.0;              /**< Frequência máxima, durante transientes. */
+    double slopeThreshold = 0.0;     /**< Tendência, em unidades por segundo, que dispara o aumento. */
+    double residualThreshold = 0.0;  /**< Desvio padrão dos resíduos, na unidade do sensor, que dispara o aumento. */
+    double smoothingS = 5.0;         /**< Constante de tempo das médias exponenciais, em segundos. */
+    double hysteresis = 0.5;         /**< Fração dos limiares abaixo da qual o sinal é considerado estável. */
+    double holdS = 30.0;             /**< Tempo estável antes de cada redução, em segundos. */
+    double upFactor = 2.0;           /**< Multiplicador da frequência a cada aumento (> 1). */
+    double downFactor = 0.5;         /**< Multiplicador da frequência a cada redução (< 1). */
+};
+
+/**
+ * @struct AdaptiveRateStats
+ * @brief Contadores das mudanças de frequência.
+ */
+struct AdaptiveRateStats {
+    std::uint64_t increases = 0;  /**< Aumentos de frequência. */
+    std::uint64_t decreases = 0;  /**< Reduções de frequência. */
+};
+
+/**
+ * @class AdaptiveRateController
+ * @brief Escolhe a frequência de amostragem de um sensor a partir das leituras.
+ *
+ * Não aloca memória e não é thread-safe: deve ser usado pela thread que lê
+ * o sensor, que aplica a nova frequência com `Scheduler::setRate()`.
+ */
+class AdaptiveRateController {
+public:
+    /**
+     * @brief Cria o controlador; com `cfg.minHz` em zero, `enabled()` é falso.
+     *
+     * @param cfg Limites, limiares e histerese.
+     * @param initialHz Frequência inicial (limitada a `[minHz, maxHz]`).
+     */
+    explicit AdaptiveRateController(const AdaptiveRateConfig &cfg = AdaptiveRateConfig(), double initialHz = 1.0);
+
+    /**
+     * @brief Indica se a frequência adaptativa está ativa.
+     */
+    bool enabled() const { return config.minHz > 0.0; }
+
+    /**
+     * @brief Acrescenta uma leitura e decide se a frequência deve mudar.
+     *
+     * Leituras inválidas (NaN) são ignoradas.
+     *
+     * @param value Valor convertido.
+     * @param nowNs Instante da leitura (relógio monotônico, ns).
+     * @return Nova frequência, em Hz, ou 0 se ela não mudou.
+     */
+    double update(double value, std::int64_t nowNs);
+
+    /**
+     * @brief Frequência atual, em Hz.
+     */
+    double rate() const { return currentHz; }
+
+    /**
+     * @brief Tendência suavizada, em unidades por segundo.
+     */
+    double slope() const { return trend; }
+
+    /**
+     * @brief Desvio padrão suavizado dos resíduos.
+     */
+    double residualStddev() const;
+
+    /**
+     * @brief Retorna os contadores acumulados.
+     */
+    const AdaptiveRateStats &getStats() const { return stats; }
+
+    /**
+     * @brief Zera os contadores.
+     */
+    void resetStats() { stats = AdaptiveRateStats(); }
+
+private:
+    AdaptiveRateConfig config;  /**< Parâmetros. */
+    AdaptiveRateStats stats;    /**< Contadores. */
+    double currentHz;           /**< Frequência atual. */
+    bool primed;                /**< Já houve uma leitura válida. */
+    std::int64_t lastNs;        /**< Instante da leitura anterior. */
+    double level;               /**< Nível suavizado. */
+    double trend;               /**< Tendência suavizada (unidades/s). */
+    double residualMean;        /**< Média suavizada dos resíduos. */
+    double residualVar;         /**< Variância suavizada dos resíduos. */
+    std::int64_t stableSinceNs; /**< Início do período estável atual (0 = não estável). */
+};
+
+#endif // ADAPTIVE_RATE_HPP
@@ -0,0 +1,364 @@
+/**
+ * @file binary_protocol.hpp
+ * @brief Codificação binária compacta de pacotes `UdpPacket`.
+ *
+ * Alternativa ao JSON de `serialize()` (~110 bytes por leitura): cada
+ * leitura ocupa 14 bytes em um registro de tamanho fixo, com identificador
+ * numérico do sensor, timestamp inteiro e valor em ponto fixo.
+ *
+ * Layout (versão 1, inteiros little-endian):
+ * @code
+ * offset  tam  campo
+ *  0      1    versão (BINARY_PROTOCOL_VERSION)
+ *  1      1    código da unidade (BinaryUnit)
+ *  2      2    sensor_num
+ *  4      4    segundos desde 1970-01-01 UTC
+ *  8      2    milissegundos (0-999)
+ * 10      4    valor em centésimos (int32, INT32_MIN = sem valor)
+ * @endcode
+ *
+ * O resumo de uma janela (`UdpSummaryPacket`, versão 2) começa com os
+ * mesmos 14 bytes (média e fim da janela) e acrescenta:
+ * @code
+ * 14      4    duração da janela, em ms
+ * 18      4    número de leituras
+ * 22      4    mínimo, em centésimos
+ * 26      4    máximo, em centésimos
+ * 30      4    desvio padrão, em milésimos
+ * 34      12   p50, p90 e p99, em centésimos (INT32_MIN = não calculado)
+ * @endcode
+ *
+ * Um pacote com número de sequência (`UdpPacket::session` diferente de
+ * zero) tem o bit `BINARY_SEQUENCE_FLAG` no byte de versão e 8 bytes a
+ * mais no fim do registro (22 bytes na versão 1, 54 no resumo). A
+ * numeração é opcional no remetente: os 14 bytes do registro simples só
+ * crescem para quem precisa da contagem exata de perdas.
+ * @code
+ * +0      4    sessão do remetente
+ * +4      4    número de sequência
+ * @endcode
+ *
+ * Codificação e decodificação não alocam memória.
+ */
+
+#ifndef BINARY_PROTOCOL_HPP
+#define BINARY_PROTOCOL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "udp_protocol.hpp"
+
+/** Versão atual do formato binário. */
+constexpr std::uint8_t BINARY_PROTOCOL_VERSION = 1;
+
+/** Tamanho, em bytes, de um pacote binário versão 1. */
+constexpr std::size_t BINARY_PACKET_SIZE = 14;
+
+/** Valor em ponto fixo reservado para leituras sem valor (NaN). */
+constexpr std::int32_t BINARY_NO_VALUE = INT32_MIN;
+
+/** Versão do registro de resumo de janela. */
+constexpr std::uint8_t BINARY_SUMMARY_VERSION = 2;
+
+/** Tamanho, em bytes, de um resumo de janela. */
+constexpr std::size_t BINARY_SUMMARY_SIZE = 46;
+
+/** Bit do byte de versão que indica sessão e número de sequência no fim do registro. */
+constexpr std::uint8_t BINARY_SEQUENCE_FLAG = 0x80;
+
+/** Bytes acrescentados ao registro por `BINARY_SEQUENCE_FLAG` (14 → 22 na leitura, 46 → 54 no resumo). */
+constexpr std::size_t BINARY_SEQUENCE_SIZE = 8;
+
+/** Maior registro possível (resumo com sequência), para dimensionar buffers. */
+constexpr std::size_t BINARY_MAX_RECORD_SIZE = BINARY_SUMMARY_SIZE + BINARY_SEQUENCE_SIZE;
+
+/**
+ * @enum BinaryUnit
+ * @brief Códigos das unidades de medida no formato binário.
+ */
+enum class BinaryUnit : std::uint8_t {
+    Unknown = 0,   /**< Unidade não mapeada. */
+    Celsius = 1,   /**< "°C" */
+    Volt = 2,      /**< "V" */
+    Percent = 3,   /**< "%" */
+    Accel = 4,     /**< "m/s²" */
+};
+
+/**
+ * @brief Converte a unidade textual em código binário.
+ *
+ * @param unit Unidade (ex: "°C").
+ * @return Código correspondente, ou `BinaryUnit::Unknown`.
+ */
+inline BinaryUnit binaryUnitFromString(const std::string &unit) {
+    if (unit == "°C") return BinaryUnit::Celsius;
+    if (unit == "V") return BinaryUnit::Volt;
+    if (unit == "%") return BinaryUnit::Percent;
+    if (unit == "m/s²") return BinaryUnit::Accel;
+    return BinaryUnit::Unknown;
+}
+
+/**
+ * @brief Retorna a unidade textual de um código binário.
+ *
+ * @param unit Código da unidade.
+ * @return String estática com a unidade (vazia se desconhecida).
+ */
+inline const char *binaryUnitName(BinaryUnit unit) {
+    switch (unit) {
+    case BinaryUnit::Celsius: return "°C";
+    case BinaryUnit::Volt:    return "V";
+    case BinaryUnit::Percent: return "%";
+    case BinaryUnit::Accel:   return "m/s²";
+    default:                  return "";
+    }
+}
+
+/**
+ * @brief Funções auxiliares de leitura/escrita little-endian.
+ */
+namespace BinaryWire {
+    inline void put16(std::uint8_t *p, std::uint16_t v) {
+        p[0] = static_cast<std::uint8_t>(v);
+        p[1] = static_cast<std::uint8_t>(v >> 8);
+    }
+    inline void put32(std::uint8_t *p, std::uint32_t v) {
+        put16(p, static_cast<std::uint16_t>(v));
+        put16(p + 2, static_cast<std::uint16_t>(v >> 16));
+    }
+    inline std::uint16_t get16(const std::uint8_t *p) {
+        return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+    }
+    inline std::uint32_t get32(const std::uint8_t *p) {
+        return get16(p) | (static_cast<std::uint32_t>(get16(p + 2)) << 16);
+    }
+}
+
+/**
+ * @brief Converte um valor para ponto fixo com `scale` unidades por unidade, saturando no `int32_t`.
+ *
+ * NaN vira `BINARY_NO_VALUE`.
+ */
+inline std::int32_t toBinaryFixed(double value, double scale) {
+    if (std::isnan(value))
+        return BINARY_NO_VALUE;
+    double scaled = std::round(value * scale);
+    if (scaled <= -2147483647.0)
+        return -2147483647;
+    if (scaled >= 2147483647.0)
+        return 2147483647;
+    return static_cast<std::int32_t>(scaled);
+}
+
+/**
+ * @brief Acrescenta sessão e número de sequência a um registro de `size` bytes, se `p` os tiver.
+ *
+ * @return Tamanho final do registro, ou 0 se `cap` for insuficiente.
+ */
+inline std::size_t appendBinarySequence(const UdpPacket &p, std::uint8_t *buf, std::size_t size, std::size_t cap) {
+    if (p.session == 0)
+        return size;
+    if (cap < size + BINARY_SEQUENCE_SIZE)
+        return 0;
+    buf[0] |= BINARY_SEQUENCE_FLAG;
+    BinaryWire::put32(buf + size, p.session);
+    BinaryWire::put32(buf + size + 4, p.seq);
+    return size + BINARY_SEQUENCE_SIZE;
+}
+
+/**
+ * @brief Codifica um `UdpPacket` no formato binário versão 1.
+ *
+ * Utiliza `sensor_num`, `epoch_ns`, `value` e `unit`; os campos textuais
+ * `group_id`, `sensor_id` e `timestamp` não são transmitidos. O valor é
+ * arredondado para centésimos e saturado na faixa do `int32_t`. Com
+ * `session` diferente de zero, o registro leva também a sequência.
+ *
+ * @param p Pacote a ser codificado.
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`, em bytes.
+ * @return Número de bytes escritos (`BINARY_PACKET_SIZE`, mais `BINARY_SEQUENCE_SIZE`
+ *         com sequência), ou 0 se `cap` for insuficiente.
+ */
+inline std::size_t encodeBinary(const UdpPacket &p, std::uint8_t *buf, std::size_t cap) {
+    if (cap < BINARY_PACKET_SIZE)
+        return 0;
+
+    std::int64_t ms = p.epoch_ns / 1000000LL;
+    std::int32_t fixed = toBinaryFixed(p.value, 100.0);
+
+    buf[0] = BINARY_PROTOCOL_VERSION;
+    buf[1] = static_cast<std::uint8_t>(binaryUnitFromString(p.unit));
+    BinaryWire::put16(buf + 2, p.sensor_num);
+    BinaryWire::put32(buf + 4, static_cast<std::uint32_t>(ms / 1000));
+    BinaryWire::put16(buf + 8, static_cast<std::uint16_t>(ms % 1000));
+    BinaryWire::put32(buf + 10, static_cast<std::uint32_t>(fixed));
+    return appendBinarySequence(p, buf, BINARY_PACKET_SIZE, cap);
+}
+
+/**
+ * @brief Codifica o resumo de uma janela (versão 2).
+ *
+ * @param p Resumo a ser codificado.
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`, em bytes.
+ * @return Número de bytes escritos (`BINARY_SUMMARY_SIZE`, mais `BINARY_SEQUENCE_SIZE`
+ *         com sequência), ou 0 se `cap` for insuficiente.
+ */
+inline std::size_t encodeBinarySummary(const UdpSummaryPacket &p, std::uint8_t *buf, std::size_t cap) {
+    if (cap < BINARY_SUMMARY_SIZE || encodeBinary(p, buf, cap) == 0)
+        return 0;
+
+    buf[0] = BINARY_SUMMARY_VERSION; // a sequência, se houver, é reescrita depois do resumo
+    const std::int64_t durationMs = (p.epoch_ns - p.window_start_ns) / 1000000LL;
+    BinaryWire::put32(buf + 14, static_cast<std::uint32_t>(durationMs));
+    BinaryWire::put32(buf + 18, p.count);
+    BinaryWire::put32(buf + 22, static_cast<std::uint32_t>(toBinaryFixed(p.min, 100.0)));
+    BinaryWire::put32(buf + 26, static_cast<std::uint32_t>(toBinaryFixed(p.max, 100.0)));
+    BinaryWire::put32(buf + 30, static_cast<std::uint32_t>(toBinaryFixed(p.stddev, 1000.0)));
+    BinaryWire::put32(buf + 34, static_cast<std::uint32_t>(toBinaryFixed(p.p50, 100.0)));
+    BinaryWire::put32(buf + 38, static_cast<std::uint32_t>(toBinaryFixed(p.p90, 100.0)));
+    BinaryWire::put32(buf + 42, static_cast<std::uint32_t>(toBinaryFixed(p.p99, 100.0)));
+    return appendBinarySequence(p, buf, BINARY_SUMMARY_SIZE, cap);
+}
+
+/**
+ * @class BinaryPacketView
+ * @brief Decodificador sem cópia de um pacote binário.
+ *
+ * A visão apenas referencia o buffer recebido; os campos são decodificados
+ * sob demanda. O buffer deve permanecer válido enquanto a visão for usada.
+ *
+ * Um resumo de janela (versão 2) também é aceito: os campos comuns trazem
+ * a média e o fim da janela, e os acessores de janela valem com `isSummary()`.
+ * `session()` e `seq()` valem com `hasSequence()`.
+ */
+class BinaryPacketView {
+public:
+    /**
+     * @brief Valida o cabeçalho e associa a visão ao buffer.
+     *
+     * @param data Início do pacote recebido.
+     * @param len Tamanho recebido, em bytes.
+     * @return `true` se o pacote tiver versão e tamanho suportados.
+     */
+    bool parse(const void *data, std::size_t len) {
+        const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+        const std::uint8_t v = len ? bytes[0] & ~BINARY_SEQUENCE_FLAG : 0;
+        std::size_t size = v == BINARY_PROTOCOL_VERSION ? BINARY_PACKET_SIZE
+                         : v == BINARY_SUMMARY_VERSION ? BINARY_SUMMARY_SIZE : 0;
+        if (size && (bytes[0] & BINARY_SEQUENCE_FLAG))
+            size += BINARY_SEQUENCE_SIZE;
+        if (size == 0 || len < size) {
+            p = nullptr;
+            return false;
+        }
+        p = bytes;
+        return true;
+    }
+
+    std::uint8_t version() const { return p[0] & ~BINARY_SEQUENCE_FLAG; }      /**< Versão do formato (sem `BINARY_SEQUENCE_FLAG`). */
+    BinaryUnit unit() const { return static_cast<BinaryUnit>(p[1]); }          /**< Código da unidade. */
+    std::uint16_t sensorNum() const { return BinaryWire::get16(p + 2); }       /**< ID numérico do sensor. */
+    std::uint32_t epochSeconds() const { return BinaryWire::get32(p + 4); }    /**< Segundos desde a época Unix. */
+    std::uint16_t milliseconds() const { return BinaryWire::get16(p + 8); }    /**< Milissegundos do segundo. */
+    std::int32_t fixedValue() const { return static_cast<std::int32_t>(BinaryWire::get32(p + 10)); } /**< Valor em centésimos. */
+
+    /**
+     * @brief Instante da leitura em ns desde a época Unix (resolução de ms).
+     */
+    std::int64_t epochNs() const {
+        return (static_cast<std::int64_t>(epochSeconds()) * 1000 + milliseconds()) * 1000000LL;
+    }
+
+    /**
+     * @brief Valor da leitura; NaN se o pacote indicar ausência de valor.
+     */
+    double value() const {
+        std::int32_t v = fixedValue();
+        return v == BINARY_NO_VALUE ? std::nan("") : v / 100.0;
+    }
+
+    bool isSummary() const { return version() == BINARY_SUMMARY_VERSION; }     /**< Resumo de janela. */
+    std::uint32_t windowMs() const { return BinaryWire::get32(p + 14); }       /**< Duração da janela, em ms. */
+    std::uint32_t count() const { return BinaryWire::get32(p + 18); }          /**< Leituras na janela. */
+    double min() const { return fixedAt(22, 100.0); }                          /**< Menor leitura. */
+    double max() const { return fixedAt(26, 100.0); }                          /**< Maior leitura. */
+    double stddev() const { return fixedAt(30, 1000.0); }                      /**< Desvio padrão. */
+    double p50() const { return fixedAt(34, 100.0); }                          /**< Mediana (NaN = não calculada). */
+    double p90() const { return fixedAt(38, 100.0); }                          /**< Percentil 90. */
+    double p99() const { return fixedAt(42, 100.0); }                          /**< Percentil 99. */
+
+    bool hasSequence() const { return (p[0] & BINARY_SEQUENCE_FLAG) != 0; }    /**< Sessão e sequência presentes. */
+    std::uint32_t session() const { return BinaryWire::get32(p + bodySize()); }     /**< Sessão do remetente. */
+    std::uint32_t seq() const { return BinaryWire::get32(p + bodySize() + 4); }     /**< Número de sequência. */
+
+private:
+    /**
+     * @brief Tamanho do registro sem a sequência.
+     */
+    std::size_t bodySize() const { return isSummary() ? BINARY_SUMMARY_SIZE : BINARY_PACKET_SIZE; }
+
+    /**
+     * @brief Valor em ponto fixo na posição `off`, dividido por `scale`.
+     */
+    double fixedAt(std::size_t off, double scale) const {
+        std::int32_t v = static_cast<std::int32_t>(BinaryWire::get32(p + off));
+        return v == BINARY_NO_VALUE ? std::nan("") : v / scale;
+    }
+
+    const std::uint8_t *p = nullptr; /**< Início do pacote no buffer recebido. */
+};
+
+/** Primeiro byte de um datagrama com vários registros binários. */
+constexpr std::uint8_t BINARY_BATCH_MAGIC = 0xB1;
+
+/** Tamanho do cabeçalho de lote: magic (1) + número de registros (1). */
+constexpr std::size_t BINARY_BATCH_HEADER_SIZE = 2;
+
+/**
+ * @brief Indica se um datagrama que começa com `first` é binário (registro ou lote).
+ *
+ * Um datagrama JSON começa com `{`, `[` ou espaço.
+ */
+inline bool isBinaryLeadByte(std::uint8_t first) {
+    const std::uint8_t v = first & ~BINARY_SEQUENCE_FLAG;
+    return first == BINARY_BATCH_MAGIC || v == BINARY_PROTOCOL_VERSION || v == BINARY_SUMMARY_VERSION;
+}
+
+/**
+ * @brief Percorre os registros de um datagrama de lote binário.
+ *
+ * Layout: `BINARY_BATCH_MAGIC`, número de registros (u8) e, para cada
+ * registro, seu tamanho (u8) seguido dos bytes do registro. O prefixo de
+ * tamanho permite pular registros de versões desconhecidas.
+ *
+ * @param data Início do datagrama.
+ * @param len Tamanho do datagrama.
+ * @param fn Função chamada com um `BinaryPacketView` para cada registro válido.
+ * @return `true` se o datagrama estiver bem formado.
+ */
+template <typename Fn>
+inline bool forEachBinaryRecord(const void *data, std::size_t len, Fn fn) {
+    const std::uint8_t *p = static_cast<const std::uint8_t *>(data);
+    if (len < BINARY_BATCH_HEADER_SIZE || p[0] != BINARY_BATCH_MAGIC)
+        return false;
+
+    std::size_t count = p[1];
+    std::size_t off = BINARY_BATCH_HEADER_SIZE;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (off >= len || off + 1 + p[off] > len)
+            return false;
+
+        BinaryPacketView view;
+        if (view.parse(p + off + 1, p[off]))
+            fn(view);
+        off += 1 + p[off];
+    }
+    return off == len;
+}
+
+#endif // BINARY_PROTOCOL_HPP
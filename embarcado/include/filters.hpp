@@ -0,0 +1,172 @@
+/**
+ * @file filters.hpp
+ * @brief Filtros digitais aplicados às leituras brutas do ADC antes da conversão.
+ *
+ * Cada sensor pode ter uma cadeia de até `FILTER_MAX_STAGES` estágios
+ * (sobreamostragem com decimação, média móvel, mediana, média exponencial
+ * e passa-baixas IIR). O estado de cada estágio tem tamanho fixo: após a
+ * configuração, nenhuma amostra aloca memória.
+ */
+
+#ifndef FILTERS_HPP
+#define FILTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Número máximo de estágios em uma `FilterChain`. */
+static const std::size_t FILTER_MAX_STAGES = 4;
+
+/** Maior janela aceita por decimação, média móvel e mediana. */
+static const unsigned FILTER_MAX_LENGTH = 32;
+
+/**
+ * @enum FilterType
+ * @brief Tipo de um estágio de filtragem.
+ */
+enum class FilterType {
+    Decimate,       /**< Média de `length` amostras, uma saída a cada `length` entradas. */
+    MovingAverage,  /**< Média das últimas `length` amostras. */
+    Median,         /**< Mediana das últimas `length` amostras (remove picos isolados). */
+    Ema,            /**< Média exponencial: y += alpha * (x - y). */
+    LowPass,        /**< Passa-baixas Butterworth de 2ª ordem (biquad) em `cutoffHz`. */
+};
+
+/**
+ * @struct FilterStage
+ * @brief Configuração de um estágio; cada tipo usa apenas os campos indicados.
+ */
+struct FilterStage {
+    FilterType type = FilterType::MovingAverage; /**< Tipo do estágio. */
+    unsigned length = 4;                         /**< Janela (Decimate, MovingAverage, Median). */
+    float alpha = 0.2f;                          /**< Peso da amostra nova (Ema), em (0, 1]. */
+    double cutoffHz = 0.1;                       /**< Frequência de corte (LowPass). */
+};
+
+/**
+ * @class FilterChain
+ * @brief Sequência de estágios de filtragem com estado de tamanho fixo.
+ *
+ * A decimação reduz a taxa de saída: com um estágio `Decimate` de 16,
+ * amostrar a 16 Hz produz um valor por segundo, com a média de 16 leituras
+ * (cerca de 2 bits a mais de resolução efetiva sobre ruído branco). Os
+ * estágios seguintes operam na taxa já decimada.
+ */
+class FilterChain {
+public:
+    /**
+     * @brief Cria uma cadeia vazia (sem filtragem).
+     */
+    FilterChain();
+
+    /**
+     * @brief Configura a cadeia e zera seu estado.
+     *
+     * @param stages Estágios, na ordem de aplicação.
+     * @param sampleRateHz Taxa das amostras de entrada (usada pelo `LowPass`).
+     * @return `false` se houver mais de `FILTER_MAX_STAGES` estágios ou algum
+     *         parâmetro inválido; nesse caso a cadeia fica vazia.
+     */
+    bool configure(const std::vector<FilterStage> &stages, double sampleRateHz);
+
+    /**
+     * @brief Ajusta a cadeia a uma nova taxa de entrada, sem descartar o histórico.
+     *
+     * Os parâmetros de `configure()` valem para a taxa configurada; nas
+     * outras, os estágios mantêm a mesma duração:
+     * - `LowPass`: coeficientes recalculados para `cutoffHz` na nova taxa
+     *   (com o corte acima de metade da taxa, o estágio deixa o sinal passar).
+     * - `Ema`: `alpha` recalculado para a mesma constante de tempo.
+     * - `MovingAverage` e `Median`: janela de `length × nova/configurada`
+     *   amostras (entre 1 e `FILTER_MAX_LENGTH`), com as amostras mais recentes.
+     * - `Decimate`: `length` mantido; a taxa de saída acompanha a entrada.
+     *
+     * @param sampleRateHz Nova taxa das amostras de entrada.
+     * @return `false` se a taxa for inválida (a cadeia não muda).
+     */
+    bool setSampleRate(double sampleRateHz);
+
+    /**
+     * @brief Descarta o histórico de todos os estágios.
+     */
+    void reset();
+
+    /**
+     * @brief Aplica a cadeia a uma amostra.
+     *
+     * @param in Amostra de entrada.
+     * @param out Amostra filtrada, válida apenas quando o retorno é `true`.
+     * @return `false` se um estágio de decimação ainda estiver acumulando.
+     */
+    bool process(float in, float &out);
+
+    /**
+     * @brief Aplica a cadeia a um bloco de amostras.
+     *
+     * Cada estágio percorre o bloco inteiro antes do próximo, o que mantém os
+     * laços curtos e sem desvios para o compilador. Equivale a chamar
+     * `process()` amostra a amostra. `out` pode ser igual a `in`.
+     *
+     * @param in Amostras de entrada.
+     * @param out Amostras filtradas (ao menos `n` posições).
+     * @param n Número de amostras de entrada.
+     * @return Número de amostras escritas em `out`.
+     */
+    std::size_t processBlock(const float *in, float *out, std::size_t n);
+
+    /**
+     * @brief Aplica a cadeia a um bloco lido do buffer IIO.
+     *
+     * @param in Amostras brutas do ADC.
+     * @param out Amostras filtradas (ao menos `n` posições).
+     * @param n Número de amostras de entrada.
+     * @return Número de amostras escritas em `out`.
+     */
+    std::size_t processBlock(const std::uint16_t *in, float *out, std::size_t n);
+
+    /**
+     * @brief Número de estágios configurados.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Taxa de saída da cadeia, em Hz (entrada dividida pelas decimações).
+     */
+    double outputRate() const;
+
+private:
+    /**
+     * @struct State
+     * @brief Estado de um estágio.
+     */
+    struct State {
+        FilterStage base;                  /**< Configuração para a taxa de `configure()`. */
+        FilterStage cfg;                   /**< Configuração em uso (ajustada por `setSampleRate()`). */
+        float window[FILTER_MAX_LENGTH];   /**< Últimas amostras (MovingAverage, Median). */
+        unsigned count;                    /**< Amostras acumuladas (até `length`). */
+        unsigned pos;                      /**< Próxima posição de escrita em `window`. */
+        double sum;                        /**< Soma da janela ou do grupo de decimação. */
+        float b0, b1, b2, a1, a2;          /**< Coeficientes do biquad (a0 normalizado). */
+        float x1, x2, y1, y2;              /**< Histórico do biquad; `y1` também guarda a EMA. */
+    };
+
+    /**
+     * @brief Aplica um estágio a uma amostra.
+     *
+     * @return `false` se o estágio não produziu saída.
+     */
+    static bool step(State &s, float in, float &out);
+
+    /**
+     * @brief Muda a janela de um estágio `MovingAverage` ou `Median`, mantendo as amostras mais recentes.
+     */
+    static void resizeWindow(State &s, unsigned length);
+
+    State stages[FILTER_MAX_STAGES];  /**< Estados dos estágios configurados. */
+    std::size_t count;                /**< Número de estágios em uso. */
+    double rateBase;                  /**< Taxa de entrada de `configure()`, em Hz. */
+    double rateOut;                   /**< Taxa de saída, em Hz. */
+};
+
+#endif // FILTERS_HPP
@@ -0,0 +1,131 @@
+/**
+ * @file iio_buffer.hpp
+ * @brief Declaração da classe IioBuffer para captura em bloco via buffer IIO.
+ *
+ * O modo bufferizado do subsistema IIO do Linux permite que o driver do ADC
+ * preencha um buffer no kernel a cada disparo do trigger. As amostras são
+ * lidas em bloco, em formato binário, a partir de `/dev/iio:deviceN`,
+ * evitando a abertura do arquivo sysfs e a conversão de texto a cada leitura.
+ *
+ * Para testes sem a placa, o dispositivo pode ser substituído por um arquivo
+ * comum ou FIFO contendo amostras binárias no mesmo formato.
+ */
+
+#ifndef IIO_BUFFER_HPP
+#define IIO_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct IioBufferConfig
+ * @brief Parâmetros de configuração do buffer IIO.
+ *
+ * Se `sysfsDir` estiver vazio, nenhuma configuração de sysfs é feita e
+ * `devicePath` é apenas aberto para leitura (arquivo comum ou FIFO).
+ */
+struct IioBufferConfig {
+    std::string devicePath = "/dev/iio:device0";                 /**< Dispositivo de caracteres (ou arquivo/FIFO). */
+    std::string sysfsDir = "/sys/bus/iio/devices/iio:device0";   /**< Diretório sysfs do dispositivo IIO. */
+    int channel = 13;                                            /**< Canal do ADC (in_voltageN). */
+    std::size_t bufferLength = 256;                              /**< Tamanho do buffer do kernel, em amostras. */
+    std::string trigger;                                         /**< Trigger a associar (vazio = mantém o atual). */
+    std::string scanType;                                        /**< Formato da amostra (ex: "le:u16/16>>0"); vazio = lê do sysfs. */
+};
+
+/**
+ * @class IioBuffer
+ * @brief Leitor de amostras brutas em bloco a partir de um buffer IIO.
+ *
+ * Configura `scan_elements` (só o canal habilitado), `buffer/length` e
+ * `buffer/enable`, abre o dispositivo de caracteres e decodifica as
+ * amostras binárias de um único canal para valores inteiros do ADC.
+ */
+class IioBuffer {
+public:
+    /**
+     * @brief Construtor padrão. O buffer permanece fechado até `open()`.
+     */
+    IioBuffer();
+
+    /**
+     * @brief Destrutor. Desabilita o buffer e fecha o dispositivo, se abertos.
+     */
+    ~IioBuffer();
+
+    IioBuffer(const IioBuffer &) = delete;
+    IioBuffer &operator=(const IioBuffer &) = delete;
+
+    /**
+     * @brief Configura o buffer IIO e abre o dispositivo para leitura.
+     *
+     * @param cfg Parâmetros de configuração.
+     * @return `true` se o buffer estiver pronto para leitura, `false` em caso de erro.
+     */
+    bool open(const IioBufferConfig &cfg);
+
+    /**
+     * @brief Desabilita o buffer (se configurado via sysfs) e fecha o dispositivo.
+     */
+    void close();
+
+    /**
+     * @brief Indica se o dispositivo está aberto.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Lê um bloco de amostras brutas do dispositivo.
+     *
+     * Executa uma única chamada `read()` e decodifica as amostras completas
+     * recebidas. Bytes de uma amostra incompleta (possível em FIFO) são
+     * guardados para a próxima leitura.
+     *
+     * Em formatos com sinal, uma amostra negativa é um erro de leitura, como
+     * um valor negativo em `Sensor::readRaw()`: sai como 0 (que a conversão
+     * já trata como erro, -273.15), é contada em `negativeSamples()` e gera
+     * um aviso, em vez de passar por uma leitura válida.
+     *
+     * @param out Vetor de saída para as amostras.
+     * @param maxSamples Capacidade de `out`, em amostras.
+     * @return Número de amostras lidas, 0 em fim de arquivo ou -1 em caso de erro.
+     */
+    int readBlock(std::uint16_t *out, std::size_t maxSamples);
+
+    /**
+     * @brief Amostras negativas recebidas desde `open()` (entregues como 0).
+     */
+    std::uint64_t negativeSamples() const;
+
+private:
+    /**
+     * @brief Interpreta uma descrição de formato no padrão `[bl]e:[su]R/S>>N`.
+     */
+    bool parseScanType(const std::string &type);
+
+    /**
+     * @brief Desabilita os elementos de `scan_elements` habilitados, exceto `keep`.
+     */
+    bool disableOtherScanElements(const std::string &keep);
+
+    /**
+     * @brief Escreve um valor em um atributo sysfs relativo a `sysfsDir`.
+     */
+    bool writeAttr(const std::string &attr, const std::string &value);
+
+    int fd;                              /**< Descritor do dispositivo de caracteres. */
+    std::string sysfsDir;                /**< Diretório sysfs configurado (vazio = sem sysfs). */
+    int channel;                         /**< Canal habilitado em `scan_elements`. */
+    bool bigEndian;                      /**< Ordem dos bytes da amostra. */
+    bool isSigned;                       /**< Amostra com sinal. */
+    unsigned realBits;                   /**< Bits válidos da amostra. */
+    unsigned storageBytes;               /**< Bytes ocupados por amostra no buffer. */
+    unsigned shift;                      /**< Deslocamento à direita dos bits válidos. */
+    std::vector<std::uint8_t> scratch;   /**< Área de leitura, alocada uma vez em `open()`. */
+    std::size_t pending;                 /**< Bytes de amostra incompleta no início de `scratch`. */
+    std::uint64_t negative;              /**< Amostras negativas desde `open()`. */
+};
+
+#endif // IIO_BUFFER_HPP
@@ -0,0 +1,273 @@
+/**
+ * @file logger.hpp
+ * @brief Log assíncrono por níveis, com custo baixo para a thread que registra.
+ *
+ * Quem registra uma mensagem não formata nem escreve nada: copia o formato
+ * (um literal com `{}` no lugar de cada argumento), os argumentos e o
+ * instante para um `LogRecord` de tamanho fixo e o enfileira na
+ * `SpscRing` da própria thread, sem travas. Uma thread de fundo esvazia as
+ * filas a cada `LOG_FLUSH_INTERVAL_MS`, formata as linhas e as escreve de
+ * uma vez (info e debug em `stdout`, avisos e erros em `stderr`):
+ * @code
+ * LOG_INFO("{}: {} leituras, {} prazos perdidos", sensorId, runs, missed);
+ * LOG_ERROR("falha ao ler valor de {}", path);
+ * LOG_DEBUG("Enviado: {}", std::string_view(jsonBuf, len));
+ * @endcode
+ * saída:
+ * @code
+ * 2025-01-01T12:00:00.123Z [INFO] sensor1: 60 leituras, 0 prazos perdidos
+ * @endcode
+ *
+ * - Níveis abaixo de `LOG_MIN_LEVEL` (definido na compilação, ex:
+ *   `-DLOG_MIN_LEVEL=0` para incluir o debug) são removidos pelo
+ *   compilador; os argumentos nem são avaliados.
+ * - `LOG_WARN` e `LOG_ERROR` têm limite por ponto de chamada: no máximo
+ *   `LOG_RATE_BURST` linhas a cada `LOG_RATE_WINDOW_NS`; a próxima linha
+ *   emitida informa quantas foram suprimidas.
+ * - Com a fila da thread cheia, a mensagem é descartada e contada
+ *   (`logDroppedCount()`); a thread de fundo avisa os descartes.
+ */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <time.h>
+
+/**
+ * Nível mínimo compilado: 0 = debug, 1 = info, 2 = aviso, 3 = erro.
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 1
+#endif
+
+/**
+ * @enum LogLevel
+ * @brief Nível de uma mensagem.
+ */
+enum class LogLevel : std::uint8_t {
+    Debug,    /**< Detalhes do caminho de cada pacote (removido por padrão). */
+    Info,     /**< Eventos e relatórios periódicos. */
+    Warning,  /**< Situações recuperáveis. */
+    Error     /**< Falhas. */
+};
+
+/** Argumentos por mensagem. */
+constexpr std::size_t LOG_MAX_ARGS = 12;
+
+/** Bytes de texto (argumentos string) por mensagem; o excedente é cortado. */
+constexpr std::size_t LOG_TEXT_BYTES = 256;
+
+/** Mensagens na fila de cada thread. */
+constexpr std::size_t LOG_RING_RECORDS = 128;
+
+/** Intervalo entre as escritas da thread de fundo, em ms. */
+constexpr int LOG_FLUSH_INTERVAL_MS = 50;
+
+/** Linhas de aviso/erro por ponto de chamada em cada janela de limite. */
+constexpr std::uint32_t LOG_RATE_BURST = 5;
+
+/** Janela do limite de avisos/erros, em ns. */
+constexpr std::int64_t LOG_RATE_WINDOW_NS = 10000000000LL;
+
+/**
+ * @enum LogArgType
+ * @brief Tipo de um argumento guardado em um `LogRecord`.
+ */
+enum class LogArgType : std::uint8_t {
+    Int,     /**< Inteiro com sinal. */
+    Uint,    /**< Inteiro sem sinal. */
+    Double,  /**< Ponto flutuante. */
+    Text     /**< Texto copiado para `LogRecord::text`. */
+};
+
+/**
+ * @struct LogRecord
+ * @brief Uma mensagem ainda não formatada.
+ *
+ * Trivialmente copiável, para ir pela `SpscRing` da thread. Os argumentos
+ * de texto são copiados para `text`; `values[i]` guarda então o início
+ * (32 bits mais baixos) e o tamanho (32 bits mais altos).
+ */
+struct LogRecord {
+    std::int64_t epochNs;                /**< Instante do registro (ns desde 1970, UTC). */
+    const char *format;                  /**< Literal com `{}` no lugar dos argumentos. */
+    std::uint32_t suppressed;            /**< Linhas suprimidas neste ponto desde a anterior. */
+    std::uint16_t textLen;               /**< Bytes usados em `text`. */
+    LogLevel level;                      /**< Nível. */
+    std::uint8_t argc;                   /**< Número de argumentos. */
+    LogArgType types[LOG_MAX_ARGS];      /**< Tipo de cada argumento. */
+    std::uint64_t values[LOG_MAX_ARGS];  /**< Valor de cada argumento. */
+    char text[LOG_TEXT_BYTES];           /**< Argumentos de texto. */
+
+    /**
+     * @brief Acrescenta um argumento (inteiro, ponto flutuante ou texto).
+     */
+    template <typename T>
+    void append(const T &v) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same<U, bool>::value) {
+            appendText(v ? "true" : "false");
+        } else if constexpr (std::is_integral<U>::value && std::is_signed<U>::value) {
+            types[argc] = LogArgType::Int;
+            values[argc++] = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+        } else if constexpr (std::is_integral<U>::value) {
+            types[argc] = LogArgType::Uint;
+            values[argc++] = static_cast<std::uint64_t>(v);
+        } else if constexpr (std::is_floating_point<U>::value) {
+            const double d = static_cast<double>(v);
+            types[argc] = LogArgType::Double;
+            std::memcpy(&values[argc++], &d, sizeof(d));
+        } else if constexpr (std::is_pointer<T>::value && (std::is_same<U, const char *>::value ||
+                                                           std::is_same<U, char *>::value)) {
+            appendText(v ? std::string_view(v) : std::string_view("(null)"));
+        } else {
+            static_assert(std::is_convertible<const T &, std::string_view>::value,
+                          "argumento de log sem conversão para texto");
+            appendText(std::string_view(v));
+        }
+    }
+
+private:
+    void appendText(std::string_view s) {
+        const std::size_t room = LOG_TEXT_BYTES - textLen;
+        const std::size_t n = s.size() < room ? s.size() : room;
+        std::memcpy(text + textLen, s.data(), n);
+        types[argc] = LogArgType::Text;
+        values[argc++] = static_cast<std::uint64_t>(textLen) | static_cast<std::uint64_t>(n) << 32;
+        textLen = static_cast<std::uint16_t>(textLen + n);
+    }
+};
+
+/**
+ * @struct LogRateLimit
+ * @brief Limite de linhas de um ponto de chamada (uma instância por thread).
+ */
+struct LogRateLimit {
+    std::int64_t windowStartNs = 0;  /**< Início da janela atual. */
+    std::uint32_t emitted = 0;       /**< Linhas emitidas na janela. */
+    std::uint32_t suppressed = 0;    /**< Linhas suprimidas desde a última emitida. */
+
+    /**
+     * @brief Decide se a linha é emitida.
+     *
+     * @param nowNs Instante atual.
+     * @param suppressedBefore Recebe as linhas suprimidas desde a anterior.
+     * @return `true` se a linha deve ser emitida.
+     */
+    bool allow(std::int64_t nowNs, std::uint32_t &suppressedBefore) {
+        if (nowNs - windowStartNs >= LOG_RATE_WINDOW_NS) {
+            windowStartNs = nowNs;
+            emitted = 0;
+        }
+        if (emitted >= LOG_RATE_BURST) {
+            ++suppressed;
+            return false;
+        }
+        ++emitted;
+        suppressedBefore = suppressed;
+        suppressed = 0;
+        return true;
+    }
+};
+
+/**
+ * @brief Indica se o nível (valor de `LogLevel`) é compilado.
+ */
+constexpr bool logLevelEnabled(int level) {
+    return level >= LOG_MIN_LEVEL;
+}
+
+/**
+ * @brief Instante atual para o log (ns desde 1970, UTC).
+ */
+inline std::int64_t logNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Enfileira uma mensagem na fila da thread atual.
+ *
+ * Na primeira chamada de cada thread, cria e registra a fila (sob uma
+ * trava) e, na primeira de todas, inicia a thread de fundo.
+ *
+ * @return `false` se a fila estava cheia (mensagem descartada).
+ */
+bool logSubmit(const LogRecord &r);
+
+/**
+ * @brief Monta e enfileira uma mensagem; use as macros `LOG_*`.
+ */
+template <typename... Args>
+inline void logWrite(LogLevel level, std::int64_t nowNs, std::uint32_t suppressed, const char *format,
+                     const Args &... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "argumentos de log demais");
+    LogRecord r;
+    r.epochNs = nowNs;
+    r.format = format;
+    r.suppressed = suppressed;
+    r.textLen = 0;
+    r.level = level;
+    r.argc = 0;
+    (r.append(args), ...);
+    logSubmit(r);
+}
+
+/**
+ * @brief Formata uma mensagem como uma linha (com `\n`).
+ *
+ * @param r Mensagem.
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`.
+ * @return Bytes escritos (a linha é cortada se não couber).
+ */
+std::size_t formatLogRecord(const LogRecord &r, char *buf, std::size_t cap);
+
+/**
+ * @brief Mensagens descartadas com a fila de alguma thread cheia.
+ */
+std::uint64_t logDroppedCount();
+
+/**
+ * @brief Escreve todas as mensagens em `out` (`nullptr` = padrão: `stdout` e `stderr`).
+ */
+void setLogOutput(std::FILE *out);
+
+/**
+ * @brief Escreve as mensagens pendentes e espera a escrita terminar.
+ */
+void flushLog();
+
+/** Mensagem no nível `level`, sem limite de linhas. */
+#define LOG_AT(level, ...)                                                               \
+    do {                                                                                 \
+        if constexpr (logLevelEnabled(static_cast<int>(level)))                          \
+            logWrite(level, logNowNs(), 0, __VA_ARGS__);                                 \
+    } while (0)
+
+/** Mensagem no nível `level`, limitada a `LOG_RATE_BURST` linhas por janela neste ponto. */
+#define LOG_LIMITED(level, ...)                                                          \
+    do {                                                                                 \
+        if constexpr (logLevelEnabled(static_cast<int>(level))) {                        \
+            static thread_local LogRateLimit logLimit_;                                  \
+            const std::int64_t logNow_ = logNowNs();                                     \
+            std::uint32_t logSuppressed_;                                                \
+            if (logLimit_.allow(logNow_, logSuppressed_))                                \
+                logWrite(level, logNow_, logSuppressed_, __VA_ARGS__);                   \
+        }                                                                                \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LogLevel::Debug, __VA_ARGS__)        /**< Mensagem de debug. */
+#define LOG_INFO(...) LOG_AT(LogLevel::Info, __VA_ARGS__)          /**< Mensagem informativa. */
+#define LOG_WARN(...) LOG_LIMITED(LogLevel::Warning, __VA_ARGS__)  /**< Aviso (com limite). */
+#define LOG_ERROR(...) LOG_LIMITED(LogLevel::Error, __VA_ARGS__)   /**< Erro (com limite). */
+
+#endif // LOGGER_HPP
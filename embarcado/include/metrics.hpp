@@ -0,0 +1,258 @@
+/**
+ * @file metrics.hpp
+ * @brief Histogramas de latência e contadores do caminho de cada amostra.
+ *
+ * Cada thread registra em sua própria instância (`threadMetrics()`), sem
+ * travas nem operações atômicas: gravar uma latência é calcular o índice do
+ * intervalo e incrementar um contador. Periodicamente (`publishIfDue()`) a
+ * thread soma seus valores ao acumulador global, sob uma trava, e zera os
+ * locais; `collectMetrics()` lê esse acumulador.
+ *
+ * Os histogramas seguem a ideia do HdrHistogram: 16 subintervalos lineares
+ * por potência de 2, ou seja, erro relativo de no máximo 1/16 (~6%) de
+ * 1 ns a ~18 min, em 592 contadores.
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <time.h>
+
+/**
+ * @enum MetricStage
+ * @brief Etapas com histograma de latência.
+ */
+enum class MetricStage : unsigned {
+    AdcRead,     /**< Leitura (e filtragem) do ADC. */
+    Conversion,  /**< Conversão do valor bruto para a unidade física. */
+    Serialize,   /**< Montagem e serialização do pacote. */
+    Send,        /**< Envio UDP (ou gravação no spool). */
+    LoopJitter,  /**< Atraso do início da leitura em relação ao prazo do agendador. */
+    Count        /**< Número de etapas. */
+};
+
+/**
+ * @enum MetricCounter
+ * @brief Contadores de eventos.
+ */
+enum class MetricCounter : unsigned {
+    ReadErrors,       /**< Leituras do ADC com erro (-1). */
+    ErrorSentinels,   /**< Conversões que resultaram em -273.15 (valor de erro). */
+    SendFailures,     /**< Envios UDP que falharam com o enlace fora do ar (vão para o spool). */
+    SendDrops,        /**< Envios UDP descartados com o buffer do socket cheio (EAGAIN/ENOBUFS). */
+    RateIncreases,    /**< Aumentos da frequência de amostragem adaptativa. */
+    RateDecreases,    /**< Reduções da frequência de amostragem adaptativa. */
+    Retransmits,      /**< Datagramas reenviados a pedido de um NACK. */
+    RetransmitMisses, /**< Números pedidos em NACKs que já tinham saído da janela de retransmissão. */
+    Count             /**< Número de contadores. */
+};
+
+/** Número de etapas com histograma. */
+static const std::size_t METRIC_STAGES = static_cast<std::size_t>(MetricStage::Count);
+
+/** Número de contadores. */
+static const std::size_t METRIC_COUNTERS = static_cast<std::size_t>(MetricCounter::Count);
+
+/**
+ * @brief Nome de uma etapa (ex: "adc_read"), usado na exportação.
+ */
+const char *metricStageName(MetricStage s);
+
+/**
+ * @brief Nome de um contador (ex: "read_errors"), usado na exportação.
+ */
+const char *metricCounterName(MetricCounter c);
+
+/**
+ * @brief Instante atual do relógio monotônico, em ns.
+ */
+inline std::int64_t metricsNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief Histograma log-linear de latências em ns.
+ *
+ * Não é thread-safe.
+ */
+class LatencyHistogram {
+public:
+    static const unsigned SUB_BITS = 4;                                /**< log2 dos subintervalos por potência de 2. */
+    static const unsigned SUB_COUNT = 1u << SUB_BITS;                  /**< Subintervalos por potência de 2. */
+    static const unsigned MAX_EXPONENT = 39;                           /**< Maior potência de 2 representada (~9 min). */
+    static const unsigned BUCKETS = (MAX_EXPONENT - SUB_BITS + 2) * SUB_COUNT; /**< Número de intervalos. */
+
+    LatencyHistogram();
+
+    /**
+     * @brief Registra uma latência; valores negativos contam como 0 e os acima do limite, no último intervalo.
+     */
+    void record(std::int64_t ns) {
+        const std::uint64_t v = ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+        ++counts[bucketOf(v)];
+        ++total;
+        sum += v;
+        if (v < minValue)
+            minValue = v;
+        if (v > maxValue)
+            maxValue = v;
+    }
+
+    /**
+     * @brief Soma outro histograma a este.
+     */
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Zera o histograma.
+     */
+    void reset();
+
+    std::uint64_t count() const { return total; }                      /**< Latências registradas. */
+    std::uint64_t min() const { return total ? minValue : 0; }         /**< Menor latência (ns). */
+    std::uint64_t max() const { return maxValue; }                     /**< Maior latência (ns). */
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; } /**< Média (ns). */
+
+    /**
+     * @brief Latência no quantil `q` (0 a 1), com o erro relativo do intervalo.
+     *
+     * @return Ponto médio do intervalo do quantil, limitado a [min(), max()]; 0 se vazio.
+     */
+    std::uint64_t percentile(double q) const;
+
+    /**
+     * @brief Índice do intervalo de um valor.
+     */
+    static unsigned bucketOf(std::uint64_t v) {
+        if (v < SUB_COUNT)
+            return static_cast<unsigned>(v);
+        unsigned e = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        if (e > MAX_EXPONENT)
+            return BUCKETS - 1;
+        const unsigned sub = static_cast<unsigned>(v >> (e - SUB_BITS)) & (SUB_COUNT - 1);
+        return (e - SUB_BITS + 1) * SUB_COUNT + sub;
+    }
+
+    /**
+     * @brief Menor valor do intervalo `b`.
+     */
+    static std::uint64_t bucketLow(unsigned b);
+
+private:
+    std::uint64_t counts[BUCKETS];   /**< Contagem por intervalo. */
+    std::uint64_t total;             /**< Soma das contagens. */
+    std::uint64_t sum;               /**< Soma das latências, para a média. */
+    std::uint64_t minValue;          /**< Menor latência. */
+    std::uint64_t maxValue;          /**< Maior latência. */
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Métricas acumuladas de todas as threads em um intervalo.
+ */
+struct MetricsSnapshot {
+    LatencyHistogram stages[METRIC_STAGES];   /**< Histograma de cada `MetricStage`. */
+    std::uint64_t counters[METRIC_COUNTERS];  /**< Valor de cada `MetricCounter`. */
+    std::int64_t startNs;                     /**< Início do intervalo (relógio monotônico). */
+    std::int64_t endNs;                       /**< Fim do intervalo. */
+
+    MetricsSnapshot();
+
+    /**
+     * @brief Histograma de uma etapa.
+     */
+    const LatencyHistogram &stage(MetricStage s) const { return stages[static_cast<unsigned>(s)]; }
+
+    /**
+     * @brief Valor de um contador.
+     */
+    std::uint64_t counter(MetricCounter c) const { return counters[static_cast<unsigned>(c)]; }
+};
+
+/**
+ * @class ThreadMetrics
+ * @brief Métricas locais de uma thread (obtidas com `threadMetrics()`).
+ *
+ * `record()` e `add()` só tocam memória da própria thread. Os valores
+ * chegam a `collectMetrics()` após `publish()`, chamado por
+ * `publishIfDue()` e na saída da thread.
+ */
+class ThreadMetrics {
+public:
+    ThreadMetrics();
+    ~ThreadMetrics();
+
+    ThreadMetrics(const ThreadMetrics &) = delete;
+    ThreadMetrics &operator=(const ThreadMetrics &) = delete;
+
+    /**
+     * @brief Registra a latência de uma etapa.
+     */
+    void record(MetricStage s, std::int64_t ns) { local.stages[static_cast<unsigned>(s)].record(ns); }
+
+    /**
+     * @brief Incrementa um contador.
+     */
+    void add(MetricCounter c, std::uint64_t n = 1) { local.counters[static_cast<unsigned>(c)] += n; }
+
+    /**
+     * @brief Publica os valores locais se o último `publish()` foi há mais de `intervalNs`.
+     *
+     * @param nowNs Instante atual (`metricsNowNs()`).
+     * @param intervalNs Intervalo mínimo entre publicações (padrão 1 s).
+     */
+    void publishIfDue(std::int64_t nowNs, std::int64_t intervalNs = 1000000000LL) {
+        if (nowNs - lastPublishNs >= intervalNs)
+            publish(nowNs);
+    }
+
+    /**
+     * @brief Soma os valores locais ao acumulador global e os zera.
+     */
+    void publish(std::int64_t nowNs);
+
+private:
+    MetricsSnapshot local;        /**< Valores desde o último `publish()`. */
+    std::int64_t lastPublishNs;   /**< Instante do último `publish()`. */
+};
+
+/**
+ * @brief Métricas da thread chamadora (criadas no primeiro uso).
+ */
+ThreadMetrics &threadMetrics();
+
+/**
+ * @brief Copia o acumulador global.
+ *
+ * @param out Destino; `startNs`/`endNs` delimitam o intervalo coberto.
+ * @param reset Zera o acumulador, iniciando um novo intervalo.
+ */
+void collectMetrics(MetricsSnapshot &out, bool reset);
+
+/**
+ * @brief Formata as métricas em JSON em um buffer do chamador.
+ *
+ * Formato: `{"metrics":{"interval_s":…,"stages":{"adc_read":{"n":…,"min":…,
+ * "p50":…,"p90":…,"p99":…,"max":…,"mean":…},…},"counters":{"read_errors":…,…}}}`,
+ * com latências em ns.
+ *
+ * @return Tamanho escrito, ou 0 se não couber.
+ */
+std::size_t formatMetrics(const MetricsSnapshot &m, char *buf, std::size_t cap);
+
+/**
+ * @brief Instala o tratador de SIGUSR1, que apenas marca um pedido de relatório.
+ */
+void installMetricsSignal();
+
+/**
+ * @brief Indica (e consome) um pedido de relatório feito por SIGUSR1.
+ */
+bool metricsDumpRequested();
+
+#endif // METRICS_HPP
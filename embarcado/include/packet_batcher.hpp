@@ -0,0 +1,133 @@
+/**
+ * @file packet_batcher.hpp
+ * @brief Declaração da classe PacketBatcher, que agrupa leituras em datagramas.
+ *
+ * Em vez de um `sendto()` por leitura, as leituras são acumuladas até um
+ * limite de bytes (padrão 1400, abaixo do MTU típico) ou um prazo máximo
+ * de espera, e então enviadas em um único datagrama. Cada datagrama é
+ * completo por si só (array JSON ou lote binário com cabeçalho), de modo
+ * que a perda de um não afeta a decodificação dos demais.
+ */
+
+#ifndef PACKET_BATCHER_HPP
+#define PACKET_BATCHER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "udp_client.hpp"
+#include "udp_protocol.hpp"
+
+/**
+ * @enum BatchFormat
+ * @brief Formato dos datagramas de lote.
+ */
+enum class BatchFormat {
+    JsonArray,       /**< `[{...},{...}]`, com os objetos de `serialize()`. */
+    BinaryRecords,   /**< Cabeçalho `BINARY_BATCH_MAGIC` + registros binários prefixados pelo tamanho. */
+};
+
+/** Menor `maxBytes` aceito: os cabeçalhos do lote e ao menos um registro binário. */
+static const std::size_t BATCH_MIN_BYTES = 64;
+
+/** Maior `maxBytes` aceito: a maior carga de um datagrama UDP sobre IPv4. */
+static const std::size_t BATCH_MAX_BYTES = 65507;
+
+/**
+ * @struct BatchConfig
+ * @brief Parâmetros de agrupamento.
+ */
+struct BatchConfig {
+    std::size_t maxBytes = 1400;                                 /**< Tamanho máximo do datagrama (limitado a `BATCH_MIN_BYTES`..`BATCH_MAX_BYTES`). */
+    std::chrono::milliseconds maxLatency{1000};                  /**< Espera máxima da leitura mais antiga. */
+    BatchFormat format = BatchFormat::JsonArray;                 /**< Formato do datagrama. */
+};
+
+/**
+ * @class PacketBatcher
+ * @brief Acumula leituras e as envia em datagramas de até `maxBytes`.
+ *
+ * O buffer é alocado uma vez no construtor; `add()` e `flush()` não alocam.
+ */
+class PacketBatcher {
+public:
+    /**
+     * @brief Cria um agrupador que envia pelos métodos de `client`.
+     *
+     * `cfg.maxBytes` fora de [`BATCH_MIN_BYTES`, `BATCH_MAX_BYTES`] é
+     * trazido para o limite mais próximo.
+     *
+     * @param client Cliente UDP de destino (deve sobreviver ao agrupador).
+     * @param cfg Parâmetros de agrupamento.
+     */
+    explicit PacketBatcher(UDPClient &client, const BatchConfig &cfg = BatchConfig());
+
+    /**
+     * @brief Envia o que estiver pendente.
+     */
+    ~PacketBatcher();
+
+    /**
+     * @brief Adiciona uma leitura ao lote atual.
+     *
+     * Se a leitura não couber, o lote atual é enviado antes. Uma leitura
+     * que sozinha exceda `maxBytes` é descartada.
+     *
+     * @param p Pacote a ser adicionado.
+     * @param prefix Prefixo JSON do sensor (`jsonPrefix()`), ou `nullptr` para montá-lo.
+     * @return `false` se um envio necessário falhou ou a leitura foi descartada.
+     */
+    bool add(const UdpPacket &p, const std::string *prefix = nullptr);
+
+    /**
+     * @brief Envia o lote se o prazo da leitura mais antiga tiver vencido.
+     *
+     * Deve ser chamado periodicamente pelo laço principal.
+     *
+     * @return `false` se o envio falhou.
+     */
+    bool poll();
+
+    /**
+     * @brief Envia imediatamente o lote pendente, se houver.
+     *
+     * @return `false` se o envio falhou.
+     */
+    bool flush();
+
+    /**
+     * @brief Número de leituras aguardando envio.
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Número de datagramas enviados com sucesso.
+     */
+    std::uint64_t datagramsSent() const;
+
+    /**
+     * @brief Número de leituras enviadas com sucesso.
+     */
+    std::uint64_t readingsSent() const;
+
+private:
+    /**
+     * @brief Escreve uma leitura em `buf + used`, sem separadores.
+     *
+     * @return Bytes escritos, ou 0 se não couber até `buf + limit`.
+     */
+    std::size_t encode(const UdpPacket &p, const std::string *prefix, std::size_t limit);
+
+    UDPClient &client;                                      /**< Destino dos datagramas. */
+    BatchConfig config;                                     /**< Parâmetros de agrupamento. */
+    std::vector<char> buf;                                  /**< Datagrama em montagem. */
+    std::size_t used;                                       /**< Bytes ocupados em `buf`. */
+    std::size_t count;                                      /**< Leituras no lote atual. */
+    std::chrono::steady_clock::time_point deadline;         /**< Prazo de envio do lote atual. */
+    std::uint64_t datagrams;                                /**< Datagramas enviados. */
+    std::uint64_t readings;                                 /**< Leituras enviadas. */
+};
+
+#endif // PACKET_BATCHER_HPP
@@ -0,0 +1,176 @@
+/**
+ * @file raw_source.hpp
+ * @brief Fontes alternativas de amostras brutas do ADC, para testes sem a placa.
+ *
+ * Um `Sensor` com uma `RawSource` não acessa o sysfs nem o buffer IIO:
+ * `readRaw()` e `readRawBlock()` vêm da fonte. Há duas fontes:
+ *
+ * - `SyntheticSource`: gerador determinístico (rampa, senoide, ruído,
+ *   degrau, valor travado), com injeção de erros;
+ * - `ReplaySource`: reproduz uma captura gravada em arquivo.
+ *
+ * As fontes não têm relógio próprio: cada chamada produz a próxima amostra.
+ * O ritmo é o de quem as lê — o `Scheduler` (`SensorConfig::sampleRateHz`)
+ * ou um laço sem espera, para testes de carga.
+ */
+
+#ifndef RAW_SOURCE_HPP
+#define RAW_SOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class RawSource
+ * @brief Interface de uma fonte de amostras brutas.
+ */
+class RawSource {
+public:
+    virtual ~RawSource() {}
+
+    /**
+     * @brief Produz a próxima amostra.
+     *
+     * @return Valor bruto do ADC (0 a 65535), ou -1 para uma leitura com erro.
+     */
+    virtual int read() = 0;
+
+    /**
+     * @brief Produz um bloco de amostras; leituras com erro são descartadas.
+     *
+     * @param out Destino, com `maxSamples` posições.
+     * @param maxSamples Capacidade de `out`.
+     * @return Número de amostras escritas (0 se a fonte terminou).
+     */
+    virtual std::size_t readBlock(std::uint16_t *out, std::size_t maxSamples);
+};
+
+/**
+ * @enum SyntheticWaveform
+ * @brief Forma de onda da `SyntheticSource`.
+ */
+enum class SyntheticWaveform {
+    Ramp,    /**< Dente de serra de `base` a `base + amplitude`, com período `period`. */
+    Sine,    /**< `base + amplitude * sin(2π n / period)`. */
+    Noise,   /**< `base` mais ruído (use `noise` > 0). */
+    Step,    /**< `base` até a amostra `period`, depois `base + amplitude`. */
+    Stuck    /**< Sempre `base`, sem ruído (ADC travado). */
+};
+
+/**
+ * @struct SyntheticConfig
+ * @brief Parâmetros da `SyntheticSource`, em unidades do ADC e em amostras.
+ */
+struct SyntheticConfig {
+    SyntheticWaveform waveform = SyntheticWaveform::Sine;  /**< Forma de onda. */
+    double base = 32768.0;       /**< Nível central (32768 ≈ 25 °C no KY-013). */
+    double amplitude = 2000.0;   /**< Amplitude da forma de onda. */
+    double period = 600.0;       /**< Período (ou posição do degrau), em amostras. */
+    double noise = 0.0;          /**< Desvio padrão do ruído gaussiano somado. */
+    double errorRate = 0.0;      /**< Probabilidade de uma leitura com erro (-1), de 0 a 1. */
+    std::uint64_t seed = 1;      /**< Semente do gerador (mesma semente = mesma sequência). */
+};
+
+/**
+ * @class SyntheticSource
+ * @brief Gerador determinístico de amostras.
+ *
+ * A amostra `n` depende apenas da configuração e de `n`, não do tempo.
+ * Os valores são limitados a [0, 65535].
+ */
+class SyntheticSource : public RawSource {
+public:
+    explicit SyntheticSource(const SyntheticConfig &cfg = SyntheticConfig());
+
+    int read() override;
+    std::size_t readBlock(std::uint16_t *out, std::size_t maxSamples) override;
+
+    /**
+     * @brief Volta à primeira amostra (e à semente inicial).
+     */
+    void rewind();
+
+    std::uint64_t position() const { return index; } /**< Amostras produzidas desde o início. */
+
+private:
+    /**
+     * @brief Valor da amostra atual, sem erro injetado.
+     */
+    int sample();
+
+    /**
+     * @brief Próximo número pseudoaleatório (xorshift64*).
+     */
+    std::uint64_t next();
+
+    /**
+     * @brief Número uniforme em [0, 1).
+     */
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    SyntheticConfig config;     /**< Parâmetros do gerador. */
+    std::uint64_t index;        /**< Número da próxima amostra. */
+    std::uint64_t state;        /**< Estado do gerador pseudoaleatório. */
+    double sineStep;            /**< 2π / período. */
+    std::uint64_t errorThreshold; /**< `errorRate` em escala de 2^64 (0 = sem erros). */
+};
+
+/**
+ * @enum ReplayFormat
+ * @brief Formato do arquivo lido pela `ReplaySource`.
+ */
+enum class ReplayFormat {
+    Binary,  /**< `uint16_t` little-endian, como o buffer IIO (`le:u16/16>>0`). */
+    Text     /**< Um valor por linha, como `in_voltageN_raw`; `-1` marca uma leitura com erro. */
+};
+
+/**
+ * @class ReplaySource
+ * @brief Reproduz uma captura de amostras brutas gravada em arquivo.
+ *
+ * O arquivo é carregado inteiro na abertura; a reprodução não faz E/S.
+ */
+class ReplaySource : public RawSource {
+public:
+    ReplaySource();
+
+    /**
+     * @brief Carrega a captura.
+     *
+     * @param path Arquivo da captura.
+     * @param format Formato do arquivo.
+     * @param loop Recomeça do início ao chegar ao fim (senão, `read()` retorna -1).
+     * @return `false` se o arquivo não puder ser lido ou estiver vazio.
+     */
+    bool open(const std::string &path, ReplayFormat format, bool loop = true);
+
+    int read() override;
+    std::size_t readBlock(std::uint16_t *out, std::size_t maxSamples) override;
+
+    std::size_t size() const { return samples.size(); }       /**< Amostras na captura. */
+    bool finished() const { return !loop && pos >= samples.size(); } /**< Captura reproduzida até o fim (sem repetição). */
+
+private:
+    std::vector<std::int32_t> samples;  /**< Captura (-1 = leitura com erro). */
+    std::size_t pos;                    /**< Próxima amostra. */
+    bool loop;                          /**< Repetir ao chegar ao fim. */
+};
+
+/**
+ * @brief Cria uma fonte a partir de uma descrição textual.
+ *
+ * Formatos aceitos:
+ * - `synthetic[:forma][,chave=valor…]`, com forma `ramp`, `sine`, `noise`,
+ *   `step` ou `stuck` e chaves `base`, `amplitude`, `period`, `noise`,
+ *   `error` e `seed` (ex: `synthetic:sine,noise=20,error=0.001`);
+ * - `replay:arquivo[,text][,once]` (binário e em repetição por padrão).
+ *
+ * @param spec Descrição da fonte.
+ * @return A fonte, ou nulo se a descrição for inválida (o erro é mostrado).
+ */
+std::unique_ptr<RawSource> makeRawSource(const std::string &spec);
+
+#endif // RAW_SOURCE_HPP
@@ -0,0 +1,95 @@
+/**
+ * @file report_policy.hpp
+ * @brief Envio por exceção: decide se uma leitura precisa ser transmitida.
+ *
+ * A temperatura ambiente muda pouco; enviar a mesma leitura a cada segundo
+ * só ocupa a rede e o coletor. Com uma banda morta (deadband), a leitura é
+ * enviada apenas quando se afasta do último valor *enviado*, e um pacote de
+ * "batimento" (heartbeat) é forçado após um silêncio máximo, para que o
+ * coletor saiba que o sensor continua ativo.
+ */
+
+#ifndef REPORT_POLICY_HPP
+#define REPORT_POLICY_HPP
+
+#include <cstdint>
+
+/**
+ * @struct ReportConfig
+ * @brief Parâmetros do envio por exceção de um sensor.
+ *
+ * O limiar é `max(absDeadband, relDeadband * |último enviado|)`. Com ambos
+ * em zero (padrão), todas as leituras são enviadas.
+ */
+struct ReportConfig {
+    double absDeadband = 0.0;     /**< Variação absoluta mínima, na unidade do sensor. */
+    double relDeadband = 0.0;     /**< Variação relativa mínima (ex: 0.01 = 1%). */
+    double maxSilenceS = 60.0;    /**< Intervalo máximo sem envio, em segundos (0 = sem heartbeat). */
+};
+
+/**
+ * @struct ReportStats
+ * @brief Contadores do envio por exceção.
+ */
+struct ReportStats {
+    std::uint64_t evaluated = 0;   /**< Leituras avaliadas. */
+    std::uint64_t sent = 0;        /**< Leituras enviadas (inclui heartbeats). */
+    std::uint64_t heartbeats = 0;  /**< Envios forçados por silêncio máximo. */
+    std::uint64_t suppressed = 0;  /**< Leituras dentro da banda morta, não enviadas. */
+
+    /**
+     * @brief Fração das leituras suprimidas (0 a 1).
+     */
+    double suppressionRatio() const { return evaluated ? static_cast<double>(suppressed) / evaluated : 0.0; }
+};
+
+/**
+ * @class ReportPolicy
+ * @brief Banda morta com heartbeat para um sensor.
+ *
+ * Não é thread-safe: deve ser usada pela thread que monta os pacotes.
+ */
+class ReportPolicy {
+public:
+    /**
+     * @brief Cria a política; a primeira leitura é sempre enviada.
+     *
+     * @param cfg Parâmetros de banda morta e silêncio máximo.
+     */
+    explicit ReportPolicy(const ReportConfig &cfg = ReportConfig());
+
+    /**
+     * @brief Avalia uma leitura e, se ela deve ser enviada, a registra como último valor enviado.
+     *
+     * Valores não numéricos (NaN) são sempre enviados.
+     *
+     * @param value Valor convertido da leitura.
+     * @param nowNs Instante da leitura, em ns (mesma base de tempo em todas as chamadas).
+     * @return `true` se a leitura deve ser enviada.
+     */
+    bool shouldSend(double value, std::int64_t nowNs);
+
+    /**
+     * @brief Esquece o último valor enviado; a próxima leitura será enviada.
+     */
+    void reset();
+
+    /**
+     * @brief Retorna os contadores acumulados.
+     */
+    const ReportStats &getStats() const;
+
+    /**
+     * @brief Zera os contadores (o último valor enviado é mantido).
+     */
+    void resetStats();
+
+private:
+    ReportConfig config;          /**< Parâmetros da política. */
+    ReportStats stats;            /**< Contadores. */
+    bool hasLast;                 /**< Já houve algum envio. */
+    double lastSent;              /**< Último valor enviado. */
+    std::int64_t lastSentNs;      /**< Instante do último envio. */
+};
+
+#endif // REPORT_POLICY_HPP
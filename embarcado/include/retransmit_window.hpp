@@ -0,0 +1,143 @@
+/**
+ * @file retransmit_window.hpp
+ * @brief Janela de retransmissão: os últimos datagramas enviados, para atender NACKs.
+ *
+ * Cada datagrama enviado com número de sequência é copiado para o anel do
+ * seu sensor, na posição `seq % slots`; um NACK do receptor
+ * (`sequence.hpp`) é atendido com as cópias que ainda estiverem no anel.
+ * A gravação custa uma cópia de memória e a busca, um acesso direto.
+ */
+
+#ifndef RETRANSMIT_WINDOW_HPP
+#define RETRANSMIT_WINDOW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Maior datagrama guardado na janela (o `jsonBuf` do `main.cpp`). */
+static const std::size_t RETRANSMIT_SLOT_BYTES = 512;
+
+/**
+ * @struct RetransmitStats
+ * @brief Contadores da janela de retransmissão.
+ */
+struct RetransmitStats {
+    std::uint64_t stored = 0;     /**< Datagramas guardados. */
+    std::uint64_t requested = 0;  /**< Números pedidos em NACKs. */
+    std::uint64_t resent = 0;     /**< Datagramas reenviados. */
+    std::uint64_t expired = 0;    /**< Números pedidos fora da janela (antigos ou ainda não enviados). */
+};
+
+/**
+ * @class RetransmitWindow
+ * @brief Anéis com os últimos `slots` datagramas enviados de cada sensor.
+ *
+ * A memória (`sensors` × `slots` × `RETRANSMIT_SLOT_BYTES`) é alocada no
+ * construtor; cada `sensor_num` ocupa um anel no seu primeiro `store()`.
+ * Não é thread-safe: deve ser usada pela thread que envia os pacotes.
+ */
+class RetransmitWindow {
+public:
+    /**
+     * @brief Cria a janela.
+     *
+     * @param slots Datagramas guardados por sensor (0 = desativada).
+     * @param sensors Número de sensores (anéis).
+     */
+    explicit RetransmitWindow(std::size_t slots = 256, std::size_t sensors = 1);
+
+    /**
+     * @brief Guarda uma cópia de um datagrama enviado, sobrescrevendo o de `seq - slots`.
+     *
+     * Datagramas maiores que `RETRANSMIT_SLOT_BYTES`, ou de um sensor a mais
+     * que os anéis, não são guardados.
+     *
+     * @param sensorNum Sensor do pacote.
+     * @param seq Número de sequência do pacote.
+     * @param data Datagrama.
+     * @param len Tamanho do datagrama.
+     */
+    void store(std::uint16_t sensorNum, std::uint32_t seq, const void *data, std::size_t len);
+
+    /**
+     * @brief Procura um datagrama guardado e o conta como pedido.
+     *
+     * @param sensorNum Sensor pedido.
+     * @param seq Número pedido.
+     * @param len Recebe o tamanho do datagrama.
+     * @return Datagrama, ou `nullptr` se já tiver saído da janela.
+     */
+    const char *find(std::uint16_t sensorNum, std::uint32_t seq, std::size_t &len);
+
+    /**
+     * @brief Corta uma faixa pedida aos números que ainda podem estar na janela.
+     *
+     * Os números cortados (anteriores aos últimos `slots` enviados do sensor,
+     * ou ainda não enviados) são contados como pedidos e expirados, sem
+     * busca: um NACK com faixas enormes custa o mesmo que um com faixas
+     * dentro da janela.
+     *
+     * @param sensorNum Sensor pedido.
+     * @param first Primeiro número da faixa; recebe o primeiro ainda na janela.
+     * @param count Quantidade de números; recebe a quantidade na janela.
+     * @return Números cortados.
+     */
+    std::uint32_t clampRange(std::uint16_t sensorNum, std::uint32_t &first, std::uint32_t &count);
+
+    /**
+     * @brief Conta um datagrama como reenviado.
+     */
+    void markResent() { ++stats.resent; }
+
+    /**
+     * @brief Retorna os contadores acumulados.
+     */
+    const RetransmitStats &getStats() const { return stats; }
+
+    /**
+     * @brief Zera os contadores.
+     */
+    void resetStats() { stats = RetransmitStats(); }
+
+private:
+    /**
+     * @struct Slot
+     * @brief Um datagrama guardado.
+     */
+    struct Slot {
+        std::uint16_t len;                  /**< Tamanho (0 = vazio). */
+        std::uint32_t seq;                  /**< Número de sequência. */
+        char data[RETRANSMIT_SLOT_BYTES];   /**< Datagrama. */
+    };
+
+    /**
+     * @struct Lane
+     * @brief Anel de um sensor.
+     */
+    struct Lane {
+        std::uint16_t sensorNum = 0;  /**< Sensor do anel. */
+        bool used = false;            /**< Anel já atribuído a um sensor. */
+        std::uint32_t newest = 0;     /**< Maior número guardado. */
+    };
+
+    /**
+     * @brief Anel do sensor, ou -1; com `create`, atribui um anel livre.
+     */
+    int laneOf(std::uint16_t sensorNum, bool create);
+
+    std::vector<Slot> ring;   /**< Datagramas guardados, `perLane` por anel. */
+    std::vector<Lane> lanes;  /**< Anéis dos sensores. */
+    std::size_t perLane;      /**< Datagramas por anel. */
+    RetransmitStats stats;    /**< Contadores. */
+};
+
+/**
+ * @brief Sorteia o identificador de sessão deste início do programa.
+ *
+ * Usa `getrandom()`; na falta dele, o relógio e o PID. Nunca retorna 0
+ * (que indica pacote sem sequência).
+ */
+std::uint32_t newSessionId();
+
+#endif // RETRANSMIT_WINDOW_HPP
@@ -0,0 +1,140 @@
+/**
+ * @file scheduler.hpp
+ * @brief Declaração da classe Scheduler, um agendador por prazos absolutos.
+ *
+ * Cada tarefa tem seu próprio período; o próximo prazo é sempre calculado
+ * a partir do prazo anterior (e não do fim da execução), de modo que o
+ * tempo gasto na leitura, serialização e envio não acumula deriva. A espera
+ * usa `clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)`.
+ */
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @struct TaskStats
+ * @brief Estatísticas de pontualidade de uma tarefa.
+ *
+ * O atraso (jitter) é medido entre o prazo e o início efetivo da execução.
+ */
+struct TaskStats {
+    std::uint64_t runs = 0;          /**< Execuções realizadas. */
+    std::uint64_t missed = 0;        /**< Prazos perdidos (períodos pulados). */
+    std::int64_t jitterMinNs = 0;    /**< Menor atraso observado (ns). */
+    std::int64_t jitterMaxNs = 0;    /**< Maior atraso observado (ns). */
+    double jitterSumNs = 0.0;        /**< Soma dos atrasos, para a média. */
+
+    /**
+     * @brief Atraso médio em ns.
+     */
+    double jitterMeanNs() const { return runs ? jitterSumNs / runs : 0.0; }
+};
+
+/**
+ * @class Scheduler
+ * @brief Executa tarefas periódicas de taxas independentes em uma única thread.
+ *
+ * As taxas podem ir de frações de Hz a alguns kHz. Quando uma tarefa se
+ * atrasa mais de um período, os prazos perdidos são contados e pulados,
+ * sem execuções em rajada para "recuperar" o atraso.
+ */
+class Scheduler {
+public:
+    using Task = std::function<void()>; /**< Função executada a cada período. */
+
+    /**
+     * @brief Registra uma tarefa periódica.
+     *
+     * O primeiro prazo é o instante do registro. Não deve ser chamado de
+     * dentro de uma tarefa em execução.
+     *
+     * @param rateHz Frequência de execução, em Hz (> 0).
+     * @param fn Função a executar.
+     * @return Identificador da tarefa, ou -1 se `rateHz` for inválida.
+     */
+    int addTask(double rateHz, Task fn);
+
+    /**
+     * @brief Altera a frequência de uma tarefa.
+     *
+     * O novo período passa a valer a partir do próximo prazo.
+     *
+     * @param id Identificador retornado por `addTask()`.
+     * @param rateHz Nova frequência, em Hz (> 0).
+     * @return `true` se a tarefa existir e a taxa for válida.
+     */
+    bool setRate(int id, double rateHz);
+
+    /**
+     * @brief Retorna a frequência atual de uma tarefa, em Hz.
+     */
+    double getRate(int id) const;
+
+    /**
+     * @brief Aguarda o próximo prazo e executa as tarefas vencidas.
+     *
+     * @return `false` se não houver tarefas registradas.
+     */
+    bool runOnce();
+
+    /**
+     * @brief Executa `runOnce()` até que `stop()` seja chamado.
+     */
+    void run();
+
+    /**
+     * @brief Solicita o fim de `run()` (pode ser chamado de outra thread ou de uma tarefa).
+     */
+    void stop();
+
+    /**
+     * @brief Retorna as estatísticas de uma tarefa.
+     */
+    const TaskStats &getStats(int id) const;
+
+    /**
+     * @brief Atraso, em ns, do início da tarefa em execução em relação ao seu prazo.
+     *
+     * Válido apenas dentro de uma tarefa.
+     */
+    std::int64_t currentLatenessNs() const;
+
+    /**
+     * @brief Zera as estatísticas de todas as tarefas.
+     */
+    void resetStats();
+
+    /**
+     * @brief Número de tarefas registradas.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Instante atual do relógio monotônico, em ns.
+     */
+    static std::int64_t nowNs();
+
+private:
+    /**
+     * @struct Entry
+     * @brief Estado interno de uma tarefa.
+     */
+    struct Entry {
+        Task fn;                 /**< Função da tarefa. */
+        std::int64_t periodNs;   /**< Período, em ns. */
+        std::int64_t deadline;   /**< Próximo prazo (CLOCK_MONOTONIC, ns). */
+        TaskStats stats;         /**< Estatísticas acumuladas. */
+    };
+
+    std::vector<Entry> tasks;               /**< Tarefas registradas. */
+    std::atomic<bool> stopRequested{false}; /**< Pedido de parada de `run()`. */
+    std::int64_t lateness = 0;              /**< Atraso da tarefa em execução. */
+};
+
+#endif // SCHEDULER_HPP
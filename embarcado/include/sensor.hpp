@@ -11,6 +11,36 @@
 #define SENSOR_HPP
 
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "adaptive_rate.hpp"
+#include "filters.hpp"
+#include "iio_buffer.hpp"
+#include "raw_source.hpp"
+#include "report_policy.hpp"
+#include "utils.hpp"
+#include "window_aggregator.hpp"
+
+/**
+ * @struct SensorConfig
+ * @brief Parâmetros de um canal de ADC monitorado por um `Sensor`.
+ */
+struct SensorConfig {
+    std::string channelPath = "/sys/bus/iio/devices/iio:device0/in_voltage13_raw"; /**< Arquivo sysfs do canal. */
+    std::string groupId = "grupo6";                 /**< Identificador do grupo enviado no pacote. */
+    std::string sensorId = "SensorDeTemperatura";   /**< Identificador do sensor enviado no pacote. */
+    std::uint16_t sensorNum = 1;                    /**< Identificador numérico (formato binário). */
+    std::string unit = "°C";                        /**< Unidade de medida. */
+    double sampleRateHz = 1.0;                      /**< Frequência de amostragem e envio (inicial, com `adaptiveRate`). */
+    AdaptiveRateConfig adaptiveRate;                /**< Frequência conforme a dinâmica do sinal (padrão: fixa). */
+    std::vector<FilterStage> filters;               /**< Filtros aplicados ao valor bruto (vazio = nenhum). */
+    ReportConfig report;                            /**< Envio por exceção (padrão: envia todas as leituras). */
+    AggregateConfig aggregate;                      /**< Resumos por janela em vez de leituras (padrão: desativado). */
+    ThermistorCalibration calibration;              /**< Constantes de conversão do canal (ajustáveis em campo). */
+    RawConverter converter;                         /**< Modelo fixo (`makeConverter<M>()`); vazio = usa `calibration`. */
+};
 
 /**
  * @class Sensor
@@ -22,58 +52,226 @@
 class Sensor {
 private:
     float lastValue;      /**< Último valor lido e convertido do sensor. */
-    std::string unit;     /**< Unidade de medida do sensor (ex: "°C"). */
+    int lastRaw;          /**< Último valor bruto lido por `readValue()`. */
+    SensorConfig config;  /**< Canal, identificadores, unidade e calibração. */
+    int fd;               /**< Descritor persistente do arquivo sysfs do canal. */
+    IioBuffer buffer;     /**< Buffer IIO usado no modo de captura em bloco. */
+    FilterChain filter;   /**< Filtros do valor bruto, configurados a partir de `config.filters`. */
+    std::unique_ptr<RawSource> source; /**< Fonte alternativa ao ADC (nulo = sysfs/IIO). */
 
     /**
-     * @name Constantes de calibração
-     * @brief Parâmetros utilizados para conversão do valor do ADC em temperatura.
-     * @{
+     * @brief Abre o arquivo sysfs do canal, se ainda não estiver aberto.
+     *
+     * @return `true` se o descritor estiver disponível.
      */
-    float seriesResistor = 10000.0f;      /**< Resistência em série com o sensor (ohms). */
-    float adcMaxValue = 65535.0f;          /**< Valor máximo do ADC (resolução de 12 bits). */
-    float steinhartA = 1.009249522e-03f;  /**< Coeficiente A da equação de Steinhart-Hart. */
-    float steinhartB = 2.378405444e-04f;  /**< Coeficiente B da equação de Steinhart-Hart. */
-    float steinhartC = 2.019202697e-07f;  /**< Coeficiente C da equação de Steinhart-Hart. */
-    /** @} */
+    bool openChannel();
 
     public:
         /**
          * @brief Construtor padrão da classe Sensor.
          *
-         * Inicializa o sensor e define valores padrão para as constantes de calibração.
+         * Utiliza o canal 13 do ADC e a calibração padrão do KY-013.
          */
         Sensor();
 
+        /**
+         * @brief Constrói um sensor para o canal descrito em `cfg`.
+         *
+         * O arquivo sysfs do canal é aberto uma única vez e mantido aberto.
+         *
+         * @param cfg Configuração do canal.
+         */
+        explicit Sensor(const SensorConfig &cfg);
+
+        /**
+         * @brief Constrói um sensor cujas amostras vêm de `src` em vez do ADC.
+         *
+         * O canal sysfs não é aberto; `readRaw()` e `readRawBlock()` leem da
+         * fonte. Filtros, calibração e identificadores de `cfg` valem
+         * normalmente.
+         *
+         * @param cfg Configuração do canal.
+         * @param src Fonte das amostras brutas (nulo = ADC).
+         */
+        Sensor(const SensorConfig &cfg, std::unique_ptr<RawSource> src);
+
         /**
          * @brief Destrutor da classe Sensor.
          *
-         * Libera recursos, se necessário.
+         * Fecha o descritor do canal e o buffer IIO, se abertos.
          */
         ~Sensor();
 
+        Sensor(const Sensor &) = delete;
+        Sensor &operator=(const Sensor &) = delete;
+
         /**
          * @brief Lê o valor bruto do sensor (ADC).
          *
-         * @return Valor inteiro correspondente à leitura do ADC.
+         * Relê o descritor persistente com `pread(fd, ..., 0)`, sem reabrir o
+         * arquivo e sem alocação; com uma `RawSource`, lê a próxima amostra dela.
+         *
+         * @return Valor inteiro correspondente à leitura do ADC, ou -1 em caso de erro.
          */
         int readRaw();
 
+        /**
+         * @brief Habilita o modo de captura em bloco via buffer IIO.
+         *
+         * Configura o buffer do kernel e abre o dispositivo de caracteres
+         * (ou o arquivo/FIFO que o substitui) indicado em `cfg`.
+         *
+         * @param cfg Configuração do buffer IIO.
+         * @return `true` se o modo bufferizado estiver ativo.
+         */
+        bool enableBufferedCapture(const IioBufferConfig &cfg);
+
+        /**
+         * @brief Desabilita o modo de captura em bloco.
+         */
+        void disableBufferedCapture();
+
+        /**
+         * @brief Lê um bloco de amostras brutas do buffer IIO.
+         *
+         * Requer `enableBufferedCapture()`. Cada chamada executa uma única
+         * leitura no dispositivo. Com uma `RawSource`, o bloco vem da fonte
+         * (sem as leituras com erro).
+         *
+         * @param out Vetor de saída para as amostras do ADC.
+         * @param maxSamples Capacidade de `out`, em amostras.
+         * @return Número de amostras lidas, 0 se não houver dados ou -1 em caso de erro.
+         */
+        int readRawBlock(std::uint16_t *out, std::size_t maxSamples);
+
+        /**
+         * @brief Lê o ADC e aplica os filtros configurados.
+         *
+         * Leituras com erro (-1) não passam pelos filtros e são devolvidas
+         * como estão, para que a falha continue visível no destino.
+         *
+         * @param raw Valor bruto filtrado (pode ter parte fracionária).
+         * @return `false` se um estágio de decimação ainda estiver acumulando
+         *         (nenhum valor novo nesta leitura).
+         */
+        bool readFiltered(float &raw);
+
+        /**
+         * @brief Aplica os filtros do sensor a um bloco lido com `readRawBlock()`.
+         *
+         * Compartilha o estado com `readFiltered()`; não misture os dois modos
+         * sem chamar `resetFilter()`.
+         *
+         * @param in Amostras brutas do ADC.
+         * @param out Amostras filtradas (ao menos `n` posições).
+         * @param n Número de amostras de entrada.
+         * @return Número de amostras escritas em `out`.
+         */
+        std::size_t filterBlock(const std::uint16_t *in, float *out, std::size_t n);
+
+        /**
+         * @brief Descarta o histórico dos filtros.
+         */
+        void resetFilter();
+
+        /**
+         * @brief Ajusta os filtros à frequência de leitura atual (ex: da frequência adaptativa).
+         *
+         * Mantém o histórico; os estágios conservam a duração configurada para
+         * `SensorConfig::sampleRateHz` (ver `FilterChain::setSampleRate()`).
+         * Deve ser chamada pela thread que lê o sensor.
+         *
+         * @param hz Nova frequência de leitura.
+         */
+        void setSampleRate(double hz);
+
         /**
          * @brief Lê e converte o valor analógico para a unidade física configurada.
          *
-         * Realiza a leitura do ADC, calcula a resistência equivalente e aplica
-         * a equação de Steinhart-Hart para obter a temperatura (ou outra grandeza).
+         * Realiza a leitura do ADC (filtrada por `readFiltered()`), calcula a
+         * resistência equivalente e aplica a equação de Steinhart-Hart para obter
+         * a temperatura (ou outra grandeza). Se a decimação ainda não produziu
+         * um valor novo, devolve o último valor convertido.
          *
          * @return Valor convertido em unidade física (ex: temperatura em °C).
          */
         float readValue();
 
+        /**
+         * @brief Converte um valor bruto (filtrado) para a unidade do sensor.
+         *
+         * Usa `SensorConfig::converter` se definido; senão, a equação de
+         * Steinhart-Hart com `SensorConfig::calibration`.
+         *
+         * @param raw Valor bruto do ADC (-1 = erro).
+         * @return Valor convertido, ou -273.15 se `raw` for inválido.
+         */
+        float convert(float raw) const {
+            return config.converter.convert ? config.converter.convert(raw)
+                                            : convertRawToCelsius(raw, config.calibration);
+        }
+
+        /**
+         * @brief Converte um bloco lido com `readRawBlock()` (ver `convert()`).
+         */
+        void convertBlock(const std::uint16_t *in, float *out, std::size_t n) const;
+
         /**
          * @brief Retorna a unidade de medida atual do sensor.
          *
          * @return Unidade de medida como string (ex: "°C", "V").
          */
         std::string getUnit();
+
+        /**
+         * @brief Retorna o identificador do grupo do sensor.
+         */
+        const std::string &getGroupId() const;
+
+        /**
+         * @brief Retorna o identificador do sensor.
+         */
+        const std::string &getSensorId() const;
+
+        /**
+         * @brief Retorna o identificador numérico do sensor.
+         */
+        std::uint16_t getSensorNum() const;
+
+        /**
+         * @brief Retorna a frequência de amostragem configurada, em Hz.
+         */
+        double getSampleRate() const;
+
+        /**
+         * @brief Retorna o último valor convertido por `readValue()`.
+         */
+        float getLastValue() const;
+
+        /**
+         * @brief Retorna o último valor bruto lido por `readValue()`.
+         */
+        int getLastRaw() const;
+
+        /**
+         * @brief Retorna a calibração usada na conversão.
+         */
+        const ThermistorCalibration &getCalibration() const;
+
+        /**
+         * @brief Retorna os parâmetros de envio por exceção do sensor.
+         */
+        const ReportConfig &getReportConfig() const;
+
+        /**
+         * @brief Retorna os parâmetros de agregação em janelas do sensor.
+         */
+        const AggregateConfig &getAggregateConfig() const;
+
+        /**
+         * @brief Retorna os parâmetros da frequência de amostragem adaptativa.
+         */
+        const AdaptiveRateConfig &getAdaptiveRateConfig() const;
 };
 
 #endif // SENSOR_HPP
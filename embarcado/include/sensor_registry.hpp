@@ -0,0 +1,94 @@
+/**
+ * @file sensor_registry.hpp
+ * @brief Declaração da classe SensorRegistry, que gerencia vários canais de ADC.
+ *
+ * O registro mantém um `Sensor` por canal, cada um com seu próprio arquivo
+ * sysfs, identificadores e calibração, e permite ler todos os canais em uma
+ * única passada.
+ */
+
+#ifndef SENSOR_REGISTRY_HPP
+#define SENSOR_REGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "sensor.hpp"
+
+/**
+ * @struct SensorReading
+ * @brief Resultado da leitura de um canal durante `SensorRegistry::pollAll()`.
+ */
+struct SensorReading {
+    const Sensor *sensor;   /**< Sensor de origem (identificadores e unidade). */
+    int raw;                /**< Valor bruto do ADC (-1 em caso de erro). */
+    float value;            /**< Valor convertido na unidade do sensor. */
+};
+
+/**
+ * @struct RawSample
+ * @brief Amostra bruta passada da thread de aquisição à thread de rede.
+ *
+ * A conversão, a serialização e o envio ficam com o consumidor; a
+ * aquisição apenas lê o ADC e registra o instante da amostra. A exceção é
+ * a frequência adaptativa, que precisa do valor convertido na aquisição:
+ * ele segue em `value`, para não ser convertido de novo.
+ */
+struct RawSample {
+    std::uint32_t sensorIndex;  /**< Índice do sensor no `SensorRegistry`. */
+    float raw;                  /**< Valor bruto filtrado do ADC (-1 em caso de erro). */
+    float value;                /**< Valor já convertido pela aquisição, ou NaN (a rede converte). */
+    std::int64_t epochNs;       /**< Instante da leitura (CLOCK_REALTIME, ns). */
+};
+
+/**
+ * @class SensorRegistry
+ * @brief Conjunto de sensores lidos em conjunto.
+ *
+ * Os sensores são criados em `add()`; a leitura de todos os canais em
+ * `pollAll()` faz um `pread()` por canal e não aloca memória.
+ */
+class SensorRegistry {
+public:
+    /**
+     * @brief Adiciona um sensor ao registro.
+     *
+     * @param cfg Configuração do canal.
+     * @return Índice do sensor no registro.
+     */
+    std::size_t add(const SensorConfig &cfg);
+
+    /**
+     * @brief Adiciona um sensor cujas amostras vêm de `src` (ver `raw_source.hpp`).
+     *
+     * @param cfg Configuração do canal.
+     * @param src Fonte das amostras brutas (nulo = ADC).
+     * @return Índice do sensor no registro.
+     */
+    std::size_t add(const SensorConfig &cfg, std::unique_ptr<RawSource> src);
+
+    /**
+     * @brief Retorna o número de sensores registrados.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Acessa o sensor de índice `index`.
+     */
+    Sensor &at(std::size_t index);
+
+    /**
+     * @brief Lê e converte todos os canais.
+     *
+     * @param out Vetor de saída com uma entrada por sensor.
+     * @param capacity Capacidade de `out`.
+     * @return Número de leituras escritas em `out` (mínimo entre `size()` e `capacity`).
+     */
+    std::size_t pollAll(SensorReading *out, std::size_t capacity);
+
+private:
+    std::vector<std::unique_ptr<Sensor>> sensors; /**< Sensores registrados. */
+};
+
+#endif // SENSOR_REGISTRY_HPP
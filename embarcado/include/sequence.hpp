@@ -0,0 +1,438 @@
+/**
+ * @file sequence.hpp
+ * @brief Números de sequência: contagem de perdas no receptor e pedidos de retransmissão (NACK).
+ *
+ * Cada pacote com sequência leva a sessão do remetente (sorteada a cada
+ * início do programa), o `sensor_num` e um número crescente por sensor
+ * (ver `UdpPacket::session`). O receptor acompanha cada fluxo
+ * `(sessão, sensor)` com um `SequenceTracker`: lacunas são perdas, e
+ * pacotes que chegam depois de uma lacuna são reordenações (ou
+ * retransmissões, se tiverem sido pedidas).
+ *
+ * Opcionalmente, o receptor pede as lacunas de volta com um datagrama
+ * NACK, enviado ao endereço de origem dos pacotes (inteiros little-endian):
+ * @code
+ * offset  tam  campo
+ *  0      1    NACK_MAGIC
+ *  1      1    número de faixas (1 a NACK_MAX_RANGES)
+ *  2      4    sessão
+ *  6      2    sensor_num
+ *  8      6·n  faixas: primeiro número (u32) e quantidade (u16)
+ * @endcode
+ * O remetente responde com os pacotes que ainda estiverem na sua janela de
+ * retransmissão (`RetransmitWindow`). O NACK é de melhor esforço: não é
+ * confirmado nem repetido.
+ *
+ * Apenas cabeçalho, sem alocação: usado pelos dois lados.
+ */
+
+#ifndef SEQUENCE_HPP
+#define SEQUENCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "binary_protocol.hpp"
+
+/** Primeiro byte de um datagrama NACK. */
+constexpr std::uint8_t NACK_MAGIC = 0xAC;
+
+/** Número máximo de faixas em um NACK. */
+constexpr std::size_t NACK_MAX_RANGES = 16;
+
+/** Tamanho do cabeçalho de um NACK. */
+constexpr std::size_t NACK_HEADER_SIZE = 8;
+
+/** Tamanho de cada faixa de um NACK. */
+constexpr std::size_t NACK_RANGE_SIZE = 6;
+
+/** Tamanho máximo de um NACK. */
+constexpr std::size_t NACK_MAX_SIZE = NACK_HEADER_SIZE + NACK_MAX_RANGES * NACK_RANGE_SIZE;
+
+/** Lacunas abertas acompanhadas por fluxo; com mais, a mais antiga é dada como perdida. */
+constexpr std::size_t SEQUENCE_MAX_GAPS = 32;
+
+/** Sessões acompanhadas por sensor (a atual e as anteriores ainda no spool do remetente). */
+constexpr std::size_t SEQUENCE_SESSIONS = 4;
+
+/** Maior lacuna pedida em um NACK (a janela de retransmissão do remetente). */
+constexpr std::uint32_t SEQUENCE_NACK_MAX = 256;
+
+/**
+ * @struct NackRange
+ * @brief Faixa de números de sequência pedida de volta.
+ */
+struct NackRange {
+    std::uint32_t first = 0;  /**< Primeiro número da faixa. */
+    std::uint16_t count = 0;  /**< Quantidade de números (0 = faixa vazia). */
+};
+
+/**
+ * @brief Codifica um NACK com `n` faixas.
+ *
+ * @param session Sessão do remetente dos pacotes.
+ * @param sensorNum Sensor dos pacotes.
+ * @param ranges Faixas pedidas.
+ * @param n Número de faixas (1 a `NACK_MAX_RANGES`).
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`.
+ * @return Bytes escritos, ou 0 se `n` for inválido ou não couber.
+ */
+inline std::size_t encodeNack(std::uint32_t session, std::uint16_t sensorNum, const NackRange *ranges,
+                              std::size_t n, std::uint8_t *buf, std::size_t cap) {
+    const std::size_t size = NACK_HEADER_SIZE + n * NACK_RANGE_SIZE;
+    if (n == 0 || n > NACK_MAX_RANGES || cap < size)
+        return 0;
+
+    buf[0] = NACK_MAGIC;
+    buf[1] = static_cast<std::uint8_t>(n);
+    BinaryWire::put32(buf + 2, session);
+    BinaryWire::put16(buf + 6, sensorNum);
+    for (std::size_t i = 0; i < n; ++i) {
+        BinaryWire::put32(buf + NACK_HEADER_SIZE + i * NACK_RANGE_SIZE, ranges[i].first);
+        BinaryWire::put16(buf + NACK_HEADER_SIZE + i * NACK_RANGE_SIZE + 4, ranges[i].count);
+    }
+    return size;
+}
+
+/**
+ * @class NackView
+ * @brief Decodificador sem cópia de um NACK.
+ */
+class NackView {
+public:
+    /**
+     * @brief Valida o datagrama e associa a visão ao buffer.
+     *
+     * @return `true` se for um NACK bem formado.
+     */
+    bool parse(const void *data, std::size_t len) {
+        const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+        p = nullptr;
+        if (len < NACK_HEADER_SIZE || bytes[0] != NACK_MAGIC || bytes[1] == 0 || bytes[1] > NACK_MAX_RANGES ||
+            len != NACK_HEADER_SIZE + bytes[1] * NACK_RANGE_SIZE)
+            return false;
+        p = bytes;
+        return true;
+    }
+
+    std::size_t rangeCount() const { return p[1]; }                            /**< Número de faixas. */
+    std::uint32_t session() const { return BinaryWire::get32(p + 2); }         /**< Sessão pedida. */
+    std::uint16_t sensorNum() const { return BinaryWire::get16(p + 6); }       /**< Sensor pedido. */
+
+    /**
+     * @brief Faixa `i` (0 a `rangeCount() - 1`).
+     */
+    NackRange range(std::size_t i) const {
+        NackRange r;
+        r.first = BinaryWire::get32(p + NACK_HEADER_SIZE + i * NACK_RANGE_SIZE);
+        r.count = BinaryWire::get16(p + NACK_HEADER_SIZE + i * NACK_RANGE_SIZE + 4);
+        return r;
+    }
+
+private:
+    const std::uint8_t *p = nullptr; /**< Início do NACK no buffer recebido. */
+};
+
+/**
+ * @struct SequenceStats
+ * @brief Contadores de um fluxo com números de sequência.
+ */
+struct SequenceStats {
+    std::uint64_t received = 0;    /**< Pacotes distintos recebidos. */
+    std::uint64_t lost = 0;        /**< Números não recebidos (lacunas abertas e abandonadas). */
+    std::uint64_t reordered = 0;   /**< Pacotes não pedidos que fecharam uma lacuna. */
+    std::uint64_t duplicates = 0;  /**< Pacotes repetidos. */
+    std::uint64_t stale = 0;       /**< Pacotes anteriores à lacuna mais antiga acompanhada, descartados. */
+    std::uint64_t requested = 0;   /**< Números pedidos em NACKs. */
+    std::uint64_t recovered = 0;   /**< Números pedidos que chegaram depois (retransmissões). */
+    std::uint64_t restarts = 0;    /**< Mudanças de sessão (reinício do remetente). */
+
+    /**
+     * @brief Soma os contadores de outro fluxo.
+     */
+    void add(const SequenceStats &o) {
+        received += o.received;
+        lost += o.lost;
+        reordered += o.reordered;
+        duplicates += o.duplicates;
+        stale += o.stale;
+        requested += o.requested;
+        recovered += o.recovered;
+        restarts += o.restarts;
+    }
+};
+
+/**
+ * @class SequenceFlow
+ * @brief Acompanha os números de sequência de um fluxo `(sessão, sensor)`.
+ *
+ * Abaixo do maior número recebido, tudo foi recebido, exceto as lacunas
+ * abertas (até `SEQUENCE_MAX_GAPS` faixas). Um pacote atrasado que cai em
+ * uma lacuna a fecha (`lost` diminui), por mais antigo que seja: as
+ * leituras reenviadas do spool depois de uma queda longa são contadas.
+ * Fora das lacunas, é repetido. Quando as faixas acabam, a mais antiga é
+ * abandonada e o limite inferior (`low`) sobe até o seu fim: pacotes
+ * abaixo dele não podem mais ser distinguidos de repetições e são
+ * descartados como antigos (`stale`).
+ *
+ * Não aloca memória nem é thread-safe.
+ */
+class SequenceFlow {
+public:
+    /**
+     * @brief Registra um pacote.
+     *
+     * @param seq Número de sequência.
+     * @param gap Se não for nulo, recebe a lacuna aberta por este pacote para
+     *            um NACK (até `SEQUENCE_NACK_MAX` números, os mais recentes), que
+     *            fica marcada como pedida; `count` 0 = nenhuma.
+     * @return `false` se o pacote for repetido ou antigo demais (não deve ser gravado).
+     */
+    bool update(std::uint32_t seq, NackRange *gap = nullptr) {
+        if (gap)
+            *gap = NackRange();
+
+        if (!started) {
+            started = true;
+            highest = seq;
+            low = seq;
+            ++counters.received;
+            return true;
+        }
+
+        const std::int32_t d = static_cast<std::int32_t>(seq - highest);
+        if (d > 0) {
+            const std::uint32_t missing = static_cast<std::uint32_t>(d) - 1;
+            if (missing) {
+                counters.lost += missing;
+                const std::uint32_t n = gap ? (missing < SEQUENCE_NACK_MAX ? missing : SEQUENCE_NACK_MAX) : 0;
+                if (missing > n)
+                    addGap(highest + 1, missing - n, false);
+                if (n) {
+                    addGap(seq - n, n, true);
+                    gap->first = seq - n;
+                    gap->count = static_cast<std::uint16_t>(n);
+                    counters.requested += n;
+                }
+            }
+            highest = seq;
+            ++counters.received;
+            return true;
+        }
+
+        for (std::size_t i = 0; i < gapCount; ++i) {
+            if (seq - gaps[i].first < gaps[i].count) {
+                const bool asked = gaps[i].asked;
+                closeInGap(i, seq);
+                ++counters.received;
+                --counters.lost;
+                if (asked)
+                    ++counters.recovered;
+                else
+                    ++counters.reordered;
+                return true;
+            }
+        }
+
+        if (static_cast<std::int32_t>(seq - low) >= 0)
+            ++counters.duplicates;
+        else
+            ++counters.stale;
+        return false;
+    }
+
+    /**
+     * @brief Indica se o fluxo já recebeu algum pacote.
+     */
+    bool active() const { return started; }
+
+    /**
+     * @brief Maior número de sequência recebido.
+     */
+    std::uint32_t highestSeq() const { return highest; }
+
+    /**
+     * @brief Número de lacunas abertas.
+     */
+    std::size_t openGaps() const { return gapCount; }
+
+    /**
+     * @brief Retorna os contadores acumulados.
+     */
+    const SequenceStats &stats() const { return counters; }
+
+private:
+    /**
+     * @struct Gap
+     * @brief Faixa de números ainda não recebidos.
+     */
+    struct Gap {
+        std::uint32_t first;  /**< Primeiro número. */
+        std::uint32_t count;  /**< Quantidade (> 0). */
+        bool asked;           /**< Pedida em NACK. */
+    };
+
+    /**
+     * @brief Abandona a lacuna mais antiga: os seus números ficam perdidos e `low` passa do seu fim.
+     */
+    void dropOldestGap() {
+        low = gaps[0].first + gaps[0].count;
+        for (std::size_t i = 1; i < gapCount; ++i)
+            gaps[i - 1] = gaps[i];
+        --gapCount;
+    }
+
+    /**
+     * @brief Acrescenta uma lacuna acima de todas as abertas.
+     */
+    void addGap(std::uint32_t first, std::uint32_t count, bool asked) {
+        if (gapCount) {
+            Gap &last = gaps[gapCount - 1];
+            if (last.first + last.count == first && last.asked == asked) {
+                last.count += count;
+                return;
+            }
+        }
+        if (gapCount == SEQUENCE_MAX_GAPS)
+            dropOldestGap();
+        gaps[gapCount++] = Gap{first, count, asked};
+    }
+
+    /**
+     * @brief Remove `seq` da lacuna `i`, dividindo-a se ficar no meio.
+     */
+    void closeInGap(std::size_t i, std::uint32_t seq) {
+        Gap &g = gaps[i];
+        const std::uint32_t offset = seq - g.first;
+        if (g.count == 1) {
+            for (std::size_t k = i + 1; k < gapCount; ++k)
+                gaps[k - 1] = gaps[k];
+            --gapCount;
+        } else if (offset == 0) {
+            ++g.first;
+            --g.count;
+        } else if (offset == g.count - 1) {
+            --g.count;
+        } else {
+            const Gap upper{seq + 1, g.count - offset - 1, g.asked};
+            g.count = offset;
+            if (gapCount == SEQUENCE_MAX_GAPS) {
+                dropOldestGap();
+                if (i == 0) { // a própria lacuna dividida era a mais antiga: fica só a parte de cima
+                    for (std::size_t k = gapCount; k > 0; --k)
+                        gaps[k] = gaps[k - 1];
+                    gaps[0] = upper;
+                    ++gapCount;
+                    return;
+                }
+                --i;
+            }
+            for (std::size_t k = gapCount; k > i + 1; --k)
+                gaps[k] = gaps[k - 1];
+            gaps[i + 1] = upper;
+            ++gapCount;
+        }
+    }
+
+    bool started = false;             /**< Já recebeu um pacote. */
+    std::uint32_t highest = 0;        /**< Maior número recebido. */
+    std::uint32_t low = 0;            /**< Números abaixo deste já foram decididos (recebidos ou perdidos). */
+    Gap gaps[SEQUENCE_MAX_GAPS];      /**< Lacunas abertas, da mais antiga para a mais recente. */
+    std::size_t gapCount = 0;         /**< Lacunas em `gaps`. */
+    SequenceStats counters;           /**< Contadores. */
+};
+
+/**
+ * @class SequenceTracker
+ * @brief Acompanha os fluxos de um sensor nas últimas `SEQUENCE_SESSIONS` sessões do remetente.
+ *
+ * Cada sessão tem o seu `SequenceFlow`: depois de um reinício, as leituras
+ * da sessão anterior reenviadas do spool continuam fechando as lacunas
+ * dela, sem confundir a sessão nova. Com todas as posições ocupadas, a
+ * sessão usada há mais tempo é encerrada (os contadores são mantidos).
+ *
+ * Não aloca memória nem é thread-safe.
+ */
+class SequenceTracker {
+public:
+    /**
+     * @brief Registra um pacote no fluxo da sua sessão.
+     *
+     * @param session Sessão do remetente.
+     * @param seq Número de sequência.
+     * @param gap Ver `SequenceFlow::update()`.
+     * @return `false` se o pacote for repetido ou antigo demais.
+     */
+    bool update(std::uint32_t session, std::uint32_t seq, NackRange *gap = nullptr) {
+        ++clock;
+        Slot *slot = nullptr;
+        for (Slot &s : slots)
+            if (s.lastUse && s.session == session)
+                slot = &s;
+        if (!slot) {
+            slot = &slots[0];
+            for (Slot &s : slots)
+                if (s.lastUse < slot->lastUse)
+                    slot = &s;
+            if (slot->lastUse)
+                retired.add(slot->flow.stats());
+            if (sessions++)
+                ++retired.restarts;
+            slot->session = session;
+            slot->flow = SequenceFlow();
+            newest = session;
+        }
+        slot->lastUse = clock;
+        return slot->flow.update(seq, gap);
+    }
+
+    /**
+     * @brief Indica se o sensor já recebeu algum pacote com sequência.
+     */
+    bool active() const { return sessions != 0; }
+
+    /**
+     * @brief Sessão mais recente do remetente.
+     */
+    std::uint32_t session() const { return newest; }
+
+    /**
+     * @brief Maior número de sequência recebido na sessão mais recente.
+     */
+    std::uint32_t highestSeq() const {
+        for (const Slot &s : slots)
+            if (s.lastUse && s.session == newest)
+                return s.flow.highestSeq();
+        return 0;
+    }
+
+    /**
+     * @brief Soma dos contadores de todas as sessões.
+     */
+    SequenceStats stats() const {
+        SequenceStats total = retired;
+        for (const Slot &s : slots)
+            if (s.lastUse)
+                total.add(s.flow.stats());
+        return total;
+    }
+
+private:
+    /**
+     * @struct Slot
+     * @brief Fluxo de uma sessão.
+     */
+    struct Slot {
+        std::uint32_t session = 0;  /**< Sessão do remetente. */
+        std::uint64_t lastUse = 0;  /**< Último uso (0 = livre). */
+        SequenceFlow flow;          /**< Números da sessão. */
+    };
+
+    Slot slots[SEQUENCE_SESSIONS];  /**< Fluxos das sessões recentes. */
+    SequenceStats retired;          /**< Contadores das sessões encerradas e reinícios. */
+    std::uint64_t clock = 0;        /**< Contador de usos. */
+    std::uint64_t sessions = 0;     /**< Sessões vistas. */
+    std::uint32_t newest = 0;       /**< Sessão mais recente. */
+};
+
+#endif // SEQUENCE_HPP
@@ -0,0 +1,98 @@
+/**
+ * @file shm_publisher.hpp
+ * @brief Declaração da classe ShmPublisher, escritor do segmento de últimas leituras.
+ *
+ * O formato do segmento e o leitor usado pelos outros processos estão em
+ * `shm_readings.hpp`.
+ */
+
+#ifndef SHM_PUBLISHER_HPP
+#define SHM_PUBLISHER_HPP
+
+#include "shm_readings.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct ShmConfig
+ * @brief Parâmetros do segmento de últimas leituras.
+ */
+struct ShmConfig {
+    std::string name = SHM_READINGS_NAME;  /**< Nome do segmento (`shm_open()`). */
+    std::size_t historyLength = 256;       /**< Leituras recentes guardadas por sensor (0 = só a última). */
+};
+
+/**
+ * @class ShmPublisher
+ * @brief Publica a última leitura de cada sensor (e o histórico recente) em memória compartilhada.
+ *
+ * Cada `publish()` grava a entrada do histórico e a posição do sensor,
+ * cada uma sob o seu seqlock: algumas cópias de memória, sem chamadas de
+ * sistema nem espera pelos leitores.
+ *
+ * Um único escritor por sensor: deve ser usada pela thread de aquisição.
+ */
+class ShmPublisher {
+public:
+    ShmPublisher();
+    ~ShmPublisher();
+
+    ShmPublisher(const ShmPublisher &) = delete;
+    ShmPublisher &operator=(const ShmPublisher &) = delete;
+
+    /**
+     * @brief Cria o segmento para `sensors` sensores.
+     *
+     * Um segmento anterior com o mesmo nome é marcado como abandonado
+     * (`ShmReadingsReader::retired()`) e substituído. Os sensores devem ser
+     * descritos com `describe()` antes de `publish()`; o segmento só fica
+     * visível aos leitores após a primeira publicação.
+     *
+     * @param cfg Nome e tamanho do histórico.
+     * @param sensors Número de sensores.
+     * @return `true` se o segmento foi criado.
+     */
+    bool open(const ShmConfig &cfg, std::size_t sensors);
+
+    /**
+     * @brief Marca o segmento como abandonado, desfaz o mapeamento e remove o nome.
+     */
+    void close();
+
+    /**
+     * @brief Indica se o segmento está aberto.
+     */
+    bool isOpen() const { return base != nullptr; }
+
+    /**
+     * @brief Grava a descrição do sensor `index` (cortada no tamanho dos campos).
+     */
+    void describe(std::size_t index, const std::string &sensorId, const std::string &unit, std::uint16_t sensorNum);
+
+    /**
+     * @brief Publica uma leitura do sensor `index`.
+     *
+     * Na primeira chamada, marca o cabeçalho como válido.
+     *
+     * @param index Sensor.
+     * @param value Valor convertido.
+     * @param raw Valor bruto (filtrado).
+     * @param valid `false` se a leitura falhou (o valor publicado é NaN).
+     * @param epochNs Instante da leitura.
+     */
+    void publish(std::size_t index, double value, float raw, bool valid, std::int64_t epochNs);
+
+private:
+    char *base;                 /**< Início do mapeamento (`nullptr` = fechado). */
+    std::size_t size;           /**< Tamanho do mapeamento. */
+    std::size_t count;          /**< Número de sensores. */
+    std::size_t historyLen;     /**< Entradas de histórico por sensor. */
+    ShmHeader *header;          /**< Cabeçalho. */
+    ShmSlot *slots;             /**< Última leitura de cada sensor. */
+    ShmHistoryEntry *history;   /**< Históricos, `historyLen` entradas por sensor. */
+    bool published;             /**< Cabeçalho já marcado como válido. */
+    std::string name;           /**< Nome do segmento. */
+};
+
+#endif // SHM_PUBLISHER_HPP
@@ -0,0 +1,342 @@
+/**
+ * @file shm_readings.hpp
+ * @brief Últimas leituras em memória compartilhada: formato do segmento e leitor.
+ *
+ * A thread de aquisição publica, para cada sensor, o último valor, o
+ * instante e um número de sequência em um segmento POSIX (`shm_open()`,
+ * padrão `SHM_READINGS_NAME`), e opcionalmente um histórico circular das
+ * leituras recentes (`ShmPublisher`). Outros processos da placa (display,
+ * controle, watchdog) mapeiam o segmento só para leitura com
+ * `ShmReadingsReader` e leem sem chamadas de sistema:
+ * @code
+ * ShmReadingsReader reader;
+ * if (reader.open()) {
+ *     int i = reader.find("SensorDeTemperatura");
+ *     ShmReading r;
+ *     if (i >= 0 && reader.latest(i, r))
+ *         std::printf("%.2f %s (#%llu)\n", r.value, reader.unit(i), (unsigned long long)r.seq);
+ * }
+ * @endcode
+ *
+ * Cada posição (último valor e cada entrada do histórico) é protegida por
+ * um seqlock: o escritor torna o contador ímpar, grava e o torna par de
+ * novo; o leitor copia os campos e repete se o contador mudou ou estava
+ * ímpar. O escritor nunca espera pelos leitores.
+ *
+ * Formato (campos na ordem nativa da placa):
+ * @code
+ * ShmHeader                                64 bytes
+ * ShmSlot[sensorCount]                     128 bytes cada
+ * ShmHistoryEntry[sensorCount][historyLength]  32 bytes cada
+ * @endcode
+ *
+ * Apenas cabeçalho: os consumidores só precisam incluir este arquivo
+ * (e ligar com `-lrt` em glibc anterior à 2.34).
+ */
+
+#ifndef SHM_READINGS_HPP
+#define SHM_READINGS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Nome padrão do segmento (em `/dev/shm`). */
+static const char SHM_READINGS_NAME[] = "/sensor_readings";
+
+/** Marca do cabeçalho; 0 indica segmento em preparação ou abandonado pelo escritor. */
+constexpr std::uint32_t SHM_READINGS_MAGIC = 0x534E5352;
+
+/** Versão do formato. */
+constexpr std::uint16_t SHM_READINGS_VERSION = 1;
+
+/** Bytes do identificador do sensor (com o terminador). */
+constexpr std::size_t SHM_SENSOR_ID_BYTES = 48;
+
+/** Bytes da unidade (com o terminador). */
+constexpr std::size_t SHM_UNIT_BYTES = 16;
+
+/** Tentativas de leitura de uma posição antes de desistir (escritor parado no meio da gravação). */
+constexpr int SHM_READ_RETRIES = 64;
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "seqlock exige atômico de 32 bits sem trava");
+
+/**
+ * @struct ShmHeader
+ * @brief Cabeçalho do segmento.
+ */
+struct alignas(64) ShmHeader {
+    std::atomic<std::uint32_t> magic;  /**< `SHM_READINGS_MAGIC`, gravado por último. */
+    std::uint16_t version;             /**< `SHM_READINGS_VERSION`. */
+    std::uint16_t sensorCount;         /**< Número de sensores. */
+    std::uint32_t historyLength;       /**< Entradas de histórico por sensor (0 = sem histórico). */
+    std::uint32_t slotSize;            /**< `sizeof(ShmSlot)`, para validação. */
+    std::int64_t startNs;              /**< Início do escritor (muda a cada reinício). */
+};
+
+/**
+ * @struct ShmSlot
+ * @brief Última leitura de um sensor e a sua descrição.
+ *
+ * A descrição (`sensorNum`, `sensorId`, `unit`) é gravada antes de o
+ * cabeçalho ser marcado como válido e não muda depois.
+ */
+struct alignas(64) ShmSlot {
+    std::atomic<std::uint32_t> lock;      /**< Seqlock (ímpar durante a gravação). */
+    std::uint16_t sensorNum;              /**< ID numérico do sensor. */
+    std::uint8_t valid;                   /**< 0 se a leitura falhou (valor de erro). */
+    std::uint64_t seq;                    /**< Leituras publicadas (0 = nenhuma ainda). */
+    std::int64_t epochNs;                 /**< Instante da leitura (ns desde 1970, UTC). */
+    double value;                         /**< Valor convertido. */
+    float raw;                            /**< Valor bruto (filtrado) do ADC. */
+    char sensorId[SHM_SENSOR_ID_BYTES];   /**< Identificador do sensor. */
+    char unit[SHM_UNIT_BYTES];            /**< Unidade do valor. */
+};
+
+/**
+ * @struct ShmHistoryEntry
+ * @brief Uma leitura no histórico circular de um sensor.
+ */
+struct ShmHistoryEntry {
+    std::atomic<std::uint32_t> lock;  /**< Seqlock (ímpar durante a gravação). */
+    float raw;                        /**< Valor bruto (filtrado) do ADC. */
+    std::uint64_t seq;                /**< Número da leitura (a entrada é `(seq - 1) % historyLength`). */
+    std::int64_t epochNs;             /**< Instante da leitura. */
+    double value;                     /**< Valor convertido (NaN se a leitura falhou). */
+};
+
+static_assert(sizeof(ShmHeader) == 64, "ShmHeader deve ter 64 bytes");
+static_assert(sizeof(ShmSlot) == 128, "ShmSlot deve ter 128 bytes");
+static_assert(sizeof(ShmHistoryEntry) == 32, "ShmHistoryEntry deve ter 32 bytes");
+
+/**
+ * @brief Tamanho do segmento para `sensors` sensores com `history` entradas cada.
+ */
+inline std::size_t shmReadingsSize(std::size_t sensors, std::size_t history) {
+    return sizeof(ShmHeader) + sensors * sizeof(ShmSlot) + sensors * history * sizeof(ShmHistoryEntry);
+}
+
+/**
+ * @brief Inicia a gravação de uma posição protegida por seqlock (apenas o escritor).
+ *
+ * @return Valor a passar para `shmWriteEnd()`.
+ */
+inline std::uint32_t shmWriteBegin(std::atomic<std::uint32_t> &lock) {
+    const std::uint32_t v = lock.load(std::memory_order_relaxed);
+    lock.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return v + 2;
+}
+
+/**
+ * @brief Conclui a gravação iniciada por `shmWriteBegin()`.
+ */
+inline void shmWriteEnd(std::atomic<std::uint32_t> &lock, std::uint32_t v) {
+    lock.store(v, std::memory_order_release);
+}
+
+/**
+ * @brief Copia uma posição protegida por seqlock.
+ *
+ * @param lock Seqlock da posição.
+ * @param copy Função que copia os campos.
+ * @return `false` se a posição continuou em gravação por `SHM_READ_RETRIES` tentativas.
+ */
+template <typename Fn>
+inline bool shmRead(const std::atomic<std::uint32_t> &lock, Fn copy) {
+    for (int i = 0; i < SHM_READ_RETRIES; ++i) {
+        const std::uint32_t before = lock.load(std::memory_order_acquire);
+        if (before & 1u)
+            continue;
+        copy();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (lock.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @struct ShmReading
+ * @brief Cópia de uma leitura publicada.
+ */
+struct ShmReading {
+    std::uint64_t seq = 0;     /**< Número da leitura (1, 2, ...) desde o início do escritor. */
+    std::int64_t epochNs = 0;  /**< Instante da leitura (ns desde 1970, UTC). */
+    double value = 0.0;        /**< Valor convertido. */
+    float raw = 0.0f;          /**< Valor bruto (filtrado) do ADC. */
+    bool valid = false;        /**< `false` se a leitura falhou. */
+};
+
+/**
+ * @class ShmReadingsReader
+ * @brief Leitor do segmento de últimas leituras (outros processos).
+ *
+ * Mapeia o segmento só para leitura; `latest()` e `history()` apenas leem
+ * memória. Um leitor pode ser usado por várias threads.
+ */
+class ShmReadingsReader {
+public:
+    ShmReadingsReader() = default;
+    ~ShmReadingsReader() { close(); }
+
+    ShmReadingsReader(const ShmReadingsReader &) = delete;
+    ShmReadingsReader &operator=(const ShmReadingsReader &) = delete;
+
+    /**
+     * @brief Mapeia o segmento e valida o formato.
+     *
+     * @param name Nome do segmento.
+     * @return `false` se o segmento não existir ou ainda estiver em preparação.
+     */
+    bool open(const char *name = SHM_READINGS_NAME) {
+        close();
+        int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(ShmHeader)) {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            return false;
+        base = static_cast<const char *>(p);
+        size = static_cast<std::size_t>(st.st_size);
+
+        const ShmHeader *h = header();
+        if (h->magic.load(std::memory_order_acquire) != SHM_READINGS_MAGIC || h->version != SHM_READINGS_VERSION ||
+            h->slotSize != sizeof(ShmSlot) || size < shmReadingsSize(h->sensorCount, h->historyLength)) {
+            close();
+            return false;
+        }
+        count = h->sensorCount;
+        historyLen = h->historyLength;
+        return true;
+    }
+
+    /**
+     * @brief Desfaz o mapeamento.
+     */
+    void close() {
+        if (base)
+            munmap(const_cast<char *>(base), size);
+        base = nullptr;
+        size = 0;
+        count = 0;
+        historyLen = 0;
+    }
+
+    /**
+     * @brief Indica se o segmento está mapeado.
+     */
+    bool isOpen() const { return base != nullptr; }
+
+    /**
+     * @brief Indica se o escritor abandonou o segmento (encerrou ou recriou com outro formato).
+     *
+     * Nesse caso, chame `open()` de novo. Um escritor que terminou sem
+     * encerrar (queda) deixa o segmento válido, com as últimas leituras
+     * envelhecendo: confira `ShmReading::epochNs`.
+     */
+    bool retired() const { return !base || header()->magic.load(std::memory_order_acquire) != SHM_READINGS_MAGIC; }
+
+    /**
+     * @brief Início do escritor; muda quando ele reinicia.
+     */
+    std::int64_t startNs() const { return base ? header()->startNs : 0; }
+
+    std::size_t sensorCount() const { return count; }       /**< Número de sensores. */
+    std::size_t historyLength() const { return historyLen; } /**< Entradas de histórico por sensor. */
+    const char *sensorId(std::size_t i) const { return slot(i).sensorId; } /**< Identificador do sensor `i`. */
+    const char *unit(std::size_t i) const { return slot(i).unit; }         /**< Unidade do sensor `i`. */
+    std::uint16_t sensorNum(std::size_t i) const { return slot(i).sensorNum; } /**< ID numérico do sensor `i`. */
+
+    /**
+     * @brief Procura um sensor pelo identificador.
+     *
+     * @return Índice do sensor, ou -1.
+     */
+    int find(const char *sensorId) const {
+        for (std::size_t i = 0; i < count; ++i)
+            if (std::strncmp(slot(i).sensorId, sensorId, SHM_SENSOR_ID_BYTES) == 0)
+                return static_cast<int>(i);
+        return -1;
+    }
+
+    /**
+     * @brief Copia a última leitura do sensor `i`.
+     *
+     * @return `false` se não houver leitura publicada ou a posição estiver presa em gravação.
+     */
+    bool latest(std::size_t i, ShmReading &out) const {
+        if (i >= count)
+            return false;
+        const ShmSlot &s = slot(i);
+        const bool ok = shmRead(s.lock, [&] {
+            out.seq = s.seq;
+            out.epochNs = s.epochNs;
+            out.value = s.value;
+            out.raw = s.raw;
+            out.valid = s.valid != 0;
+        });
+        return ok && out.seq != 0;
+    }
+
+    /**
+     * @brief Copia as leituras recentes do sensor `i`, da mais nova para a mais antiga.
+     *
+     * Para na primeira entrada já sobrescrita por uma leitura mais nova
+     * (o escritor avançou durante a cópia).
+     *
+     * @param i Sensor.
+     * @param out Leituras copiadas.
+     * @param max Capacidade de `out`.
+     * @return Número de leituras copiadas (até `min(max, historyLength())`).
+     */
+    std::size_t history(std::size_t i, ShmReading *out, std::size_t max) const {
+        ShmReading last;
+        if (historyLen == 0 || !latest(i, last))
+            return 0;
+        const ShmHistoryEntry *ring = entries(i);
+        std::size_t n = 0;
+        for (std::uint64_t seq = last.seq; seq > 0 && n < max && n < historyLen; --seq) {
+            const ShmHistoryEntry &e = ring[(seq - 1) % historyLen];
+            ShmReading &r = out[n];
+            if (!shmRead(e.lock, [&] {
+                    r.seq = e.seq;
+                    r.epochNs = e.epochNs;
+                    r.value = e.value;
+                    r.raw = e.raw;
+                }) || r.seq != seq)
+                break;
+            r.valid = r.value == r.value; // NaN = leitura com erro
+            ++n;
+        }
+        return n;
+    }
+
+private:
+    const ShmHeader *header() const { return reinterpret_cast<const ShmHeader *>(base); }
+    const ShmSlot &slot(std::size_t i) const {
+        return reinterpret_cast<const ShmSlot *>(base + sizeof(ShmHeader))[i];
+    }
+    const ShmHistoryEntry *entries(std::size_t i) const {
+        return reinterpret_cast<const ShmHistoryEntry *>(base + sizeof(ShmHeader) + count * sizeof(ShmSlot)) +
+               i * historyLen;
+    }
+
+    const char *base = nullptr;  /**< Início do mapeamento. */
+    std::size_t size = 0;        /**< Tamanho do mapeamento. */
+    std::size_t count = 0;       /**< Número de sensores. */
+    std::size_t historyLen = 0;  /**< Entradas de histórico por sensor. */
+};
+
+#endif // SHM_READINGS_HPP
@@ -0,0 +1,162 @@
+/**
+ * @file spool.hpp
+ * @brief Declaração da classe Spool, armazenamento local de datagramas durante quedas de rede.
+ *
+ * Quando o envio falha (ou o enlace está marcado como fora do ar), o
+ * datagrama já serializado é gravado em um arquivo circular mapeado em
+ * memória (`mmap`) na flash local; quando o envio volta a funcionar, os
+ * registros são reenviados do mais antigo para o mais novo, em ritmo
+ * limitado para não atrasar o tráfego ao vivo.
+ *
+ * Formato do arquivo: um cabeçalho de 4096 bytes seguido de `capacity`
+ * registros de `recordSize` bytes. Cada registro tem um cabeçalho com
+ * número de sequência, tamanho, checksum e uma marca de confirmação escrita
+ * por último; registros incompletos (queda no meio da escrita) são
+ * ignorados na recuperação. Com o arquivo cheio, o registro mais antigo é
+ * sobrescrito.
+ */
+
+#ifndef SPOOL_HPP
+#define SPOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @struct SpoolConfig
+ * @brief Parâmetros do arquivo de spool e do reenvio.
+ */
+struct SpoolConfig {
+    std::string path = "/home/root/sensor.spool"; /**< Arquivo na flash local. */
+    std::size_t recordSize = 256;                 /**< Tamanho fixo de cada registro, em bytes (inclui 24 de cabeçalho). */
+    std::size_t capacity = 16384;                 /**< Número de registros (padrão: 4 MiB de arquivo). */
+    unsigned syncEvery = 64;                      /**< `msync()` assíncrono a cada N gravações (0 = só em `sync()`). */
+    double replayRateHz = 20.0;                   /**< Reenvios por segundo durante a recuperação. */
+    unsigned replayBurst = 8;                     /**< Máximo de reenvios acumulados em uma chamada de `replay()`. */
+};
+
+/**
+ * @struct SpoolStats
+ * @brief Contadores do spool.
+ */
+struct SpoolStats {
+    std::uint64_t appended = 0;   /**< Registros gravados. */
+    std::uint64_t replayed = 0;   /**< Registros reenviados com sucesso. */
+    std::uint64_t evicted = 0;    /**< Registros mais antigos sobrescritos com o arquivo cheio. */
+    std::uint64_t rejected = 0;   /**< Datagramas maiores que o registro. */
+    std::uint64_t corrupt = 0;    /**< Registros incompletos ignorados. */
+};
+
+/**
+ * @class Spool
+ * @brief Fila circular persistente de registros de tamanho fixo.
+ *
+ * As gravações não chamam `fsync()`: os dados ficam no cache de páginas
+ * (sobrevivem a uma falha do processo) e são enviados à flash por
+ * `msync(MS_ASYNC)` a cada `syncEvery` registros. O envio é "pelo menos
+ * uma vez": uma queda entre o reenvio e a confirmação repete o registro.
+ *
+ * Não é thread-safe; deve ser usada pela thread de rede.
+ */
+class Spool {
+public:
+    /**
+     * @brief Função de envio usada por `replay()`; retorna `true` se o datagrama foi enviado.
+     */
+    using SendFn = std::function<bool(const void *data, std::size_t len)>;
+
+    Spool();
+    ~Spool();
+
+    Spool(const Spool &) = delete;
+    Spool &operator=(const Spool &) = delete;
+
+    /**
+     * @brief Abre (ou cria) o arquivo e recupera os registros pendentes.
+     *
+     * Um arquivo com formato diferente do configurado é recriado vazio.
+     *
+     * @param cfg Parâmetros do spool.
+     * @return `true` se o arquivo estiver mapeado.
+     */
+    bool open(const SpoolConfig &cfg);
+
+    /**
+     * @brief Sincroniza e desmapeia o arquivo.
+     */
+    void close();
+
+    /**
+     * @brief Indica se o arquivo está aberto.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Grava um datagrama no fim da fila.
+     *
+     * @param data Bytes do datagrama.
+     * @param len Tamanho, até `recordSize - 24`.
+     * @return `false` se o spool estiver fechado ou o datagrama não couber.
+     */
+    bool append(const void *data, std::size_t len);
+
+    /**
+     * @brief Reenvia registros pendentes, respeitando `replayRateHz`.
+     *
+     * Para no primeiro envio que falhar (o registro continua pendente).
+     *
+     * @param nowNs Instante atual (CLOCK_MONOTONIC, ns).
+     * @param send Função de envio.
+     * @return Número de registros reenviados.
+     */
+    std::size_t replay(std::int64_t nowNs, const SendFn &send);
+
+    /**
+     * @brief Número de registros pendentes.
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Força a gravação das páginas alteradas (`msync(MS_SYNC)`).
+     */
+    void sync();
+
+    /**
+     * @brief Retorna os contadores do spool.
+     */
+    const SpoolStats &getStats() const;
+
+private:
+    struct FileHeader;
+    struct RecordHeader;
+
+    /**
+     * @brief Endereço do registro de número de sequência `seq`.
+     */
+    unsigned char *slot(std::uint64_t seq) const;
+
+    /**
+     * @brief Reconstrói início e fim da fila a partir dos registros válidos.
+     */
+    void recover();
+
+    /**
+     * @brief Confere a marca, a sequência e o checksum de um registro.
+     */
+    bool valid(std::uint64_t seq) const;
+
+    SpoolConfig config;           /**< Parâmetros do spool. */
+    SpoolStats stats;             /**< Contadores. */
+    int fd;                       /**< Descritor do arquivo. */
+    unsigned char *map;           /**< Início do mapeamento. */
+    std::size_t mapSize;          /**< Tamanho do mapeamento, em bytes. */
+    std::uint64_t head;           /**< Próxima sequência a gravar. */
+    std::uint64_t tail;           /**< Sequência mais antiga pendente. */
+    unsigned sinceSync;           /**< Gravações desde o último `msync()`. */
+    double replayTokens;          /**< Reenvios disponíveis (balde de fichas). */
+    std::int64_t lastReplayNs;    /**< Instante da última recarga do balde. */
+};
+
+#endif // SPOOL_HPP
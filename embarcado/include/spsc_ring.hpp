@@ -0,0 +1,173 @@
+/**
+ * @file spsc_ring.hpp
+ * @brief Fila circular sem travas para um produtor e um consumidor (SPSC).
+ *
+ * Usada para desacoplar a thread de aquisição (produtora) da thread de
+ * rede (consumidora): um `sendto()` lento ou bloqueado não atrasa a
+ * próxima leitura do ADC. O comportamento com a fila cheia é definido por
+ * `OverflowPolicy`, e os descartes são contados.
+ */
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @enum OverflowPolicy
+ * @brief Comportamento de `SpscRing::push()` com a fila cheia.
+ */
+enum class OverflowPolicy {
+    DropOldest,  /**< Descarta o elemento mais antigo e insere o novo. */
+    DropNewest,  /**< Descarta o elemento novo. */
+    Block,       /**< Espera o consumidor liberar espaço (ou `close()`). */
+};
+
+/**
+ * @class SpscRing
+ * @brief Fila circular de capacidade fixa (potência de 2) para um produtor e um consumidor.
+ *
+ * Os índices `head` (produtor) e `tail` (consumidor) crescem sem limite e
+ * são mapeados nas posições por máscara. O consumidor confirma a leitura
+ * com compare-and-swap em `tail`; assim, na política `DropOldest`, o
+ * produtor pode avançar `tail` para descartar o elemento mais antigo, e
+ * uma cópia feita pelo consumidor de um elemento descartado no meio do
+ * caminho é detectada (o CAS falha) e refeita.
+ *
+ * @tparam T Tipo do elemento; deve ser trivialmente copiável.
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing exige T trivialmente copiável");
+
+public:
+    /**
+     * @brief Cria a fila.
+     *
+     * @param capacity Capacidade mínima; arredondada para a próxima potência de 2.
+     * @param policy Comportamento com a fila cheia.
+     */
+    explicit SpscRing(std::size_t capacity, OverflowPolicy policy = OverflowPolicy::DropOldest)
+    : policy(policy)
+    {
+        std::size_t cap = 2;
+        while (cap < capacity)
+            cap <<= 1;
+        slots.resize(cap);
+        mask = cap - 1;
+    }
+
+    /**
+     * @brief Insere um elemento (apenas a thread produtora).
+     *
+     * @param value Elemento a inserir.
+     * @return `false` se o elemento foi descartado (`DropNewest`) ou a fila foi fechada (`Block`).
+     */
+    bool push(const T &value) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+
+        for (;;) {
+            std::size_t t = tail.load(std::memory_order_acquire);
+            if (h - t <= mask)
+                break;
+
+            if (policy == OverflowPolicy::DropNewest) {
+                bump(dropped);
+                return false;
+            }
+            if (policy == OverflowPolicy::DropOldest) {
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_acq_rel))
+                    bump(dropped);
+                continue;
+            }
+            if (closed.load(std::memory_order_acquire))
+                return false;
+            bump(blocked);
+            std::this_thread::yield();
+        }
+
+        slots[h & mask] = value;
+        head.store(h + 1, std::memory_order_release);
+        bump(pushed);
+        return true;
+    }
+
+    /**
+     * @brief Remove até `max` elementos (apenas a thread consumidora).
+     *
+     * @param out Destino dos elementos, em ordem de inserção.
+     * @param max Capacidade de `out`.
+     * @return Número de elementos removidos (0 se a fila estiver vazia).
+     */
+    std::size_t popBulk(T *out, std::size_t max) {
+        std::size_t t = tail.load(std::memory_order_acquire);
+
+        for (;;) {
+            const std::size_t h = head.load(std::memory_order_acquire);
+            std::size_t n = h - t;
+            if (n == 0 || max == 0)
+                return 0;
+            if (n > max)
+                n = max;
+
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = slots[(t + i) & mask];
+
+            // Se o produtor descartou algum desses elementos, o CAS falha,
+            // `t` recebe o novo valor de `tail` e a cópia é refeita.
+            if (tail.compare_exchange_weak(t, t + n, std::memory_order_acq_rel, std::memory_order_acquire))
+                return n;
+        }
+    }
+
+    /**
+     * @brief Remove um elemento (apenas a thread consumidora).
+     *
+     * @return `true` se um elemento foi removido.
+     */
+    bool pop(T &out) {
+        return popBulk(&out, 1) == 1;
+    }
+
+    /**
+     * @brief Libera um produtor bloqueado na política `Block`.
+     */
+    void close() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    std::size_t capacity() const { return mask + 1; }                                      /**< Capacidade da fila. */
+    std::size_t size() const {                                                            /**< Ocupação aproximada. */
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    std::uint64_t pushedCount() const { return pushed.load(std::memory_order_relaxed); }   /**< Elementos inseridos. */
+    std::uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); } /**< Elementos descartados. */
+    std::uint64_t blockedCount() const { return blocked.load(std::memory_order_relaxed); } /**< Esperas por espaço (`Block`). */
+
+private:
+    /**
+     * @brief Incrementa um contador escrito apenas pelo produtor.
+     *
+     * Como há um único escritor, load + store relaxados bastam (sem RMW atômico).
+     */
+    static void bump(std::atomic<std::uint64_t> &c) {
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    alignas(64) std::atomic<std::size_t> head{0};   /**< Próxima posição de escrita (produtor). */
+    alignas(64) std::atomic<std::size_t> tail{0};   /**< Próxima posição de leitura (consumidor). */
+    alignas(64) std::atomic<std::uint64_t> pushed{0};  /**< Elementos inseridos. */
+    std::atomic<std::uint64_t> dropped{0};          /**< Elementos descartados. */
+    std::atomic<std::uint64_t> blocked{0};          /**< Esperas na política `Block`. */
+    std::atomic<bool> closed{false};                /**< Fila fechada (libera `Block`). */
+    OverflowPolicy policy;                          /**< Comportamento com a fila cheia. */
+    std::size_t mask;                               /**< Capacidade - 1. */
+    std::vector<T> slots;                           /**< Armazenamento dos elementos. */
+};
+
+#endif // SPSC_RING_HPP
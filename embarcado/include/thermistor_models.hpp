@@ -0,0 +1,221 @@
+/**
+ * @file thermistor_models.hpp
+ * @brief Modelos de sensor resolvidos em tempo de compilação.
+ *
+ * Um conversor é a combinação de um modelo (Steinhart-Hart, Beta, RTD
+ * linear ou tensão bruta), de um divisor de tensão (resistor série e
+ * topologia) e da resolução do ADC, todos como tipos com constantes
+ * `constexpr`:
+ *
+ * @code
+ * struct MeuNtc { static constexpr float beta = 3950.0f, r0 = 10000.0f, t0Celsius = 25.0f; };
+ * using MeuSensor = SensorModel<BetaModel<MeuNtc>, VoltageDivider<10000, AdcResolution<12>>>;
+ * float c = MeuSensor::convert(raw);
+ * @endcode
+ *
+ * Cada combinação gera uma função própria, com as constantes embutidas e
+ * sem desvios de configuração em tempo de execução. Para associar um
+ * modelo a um `Sensor`, use `makeConverter<MeuSensor>()` em
+ * `SensorConfig::converter`; sem conversor, o sensor usa a calibração de
+ * `SensorConfig::calibration`, ajustável em campo.
+ *
+ * Leituras inválidas resultam em -273.15, como em `convertRawToCelsius()`.
+ */
+
+#ifndef THERMISTOR_MODELS_HPP
+#define THERMISTOR_MODELS_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/** Valor devolvido para leituras inválidas (zero absoluto), como em `convertRawToCelsius()`. */
+static constexpr float MODEL_ERROR_VALUE = -273.15f;
+
+/**
+ * @struct AdcResolution
+ * @brief Resolução do ADC, em bits.
+ */
+template <unsigned Bits>
+struct AdcResolution {
+    static_assert(Bits >= 1 && Bits <= 24, "resolução de ADC não suportada");
+    static constexpr float maxValue = static_cast<float>((1ul << Bits) - 1); /**< Maior leitura. */
+};
+
+/**
+ * @enum DividerTopology
+ * @brief Posição do sensor no divisor de tensão.
+ */
+enum class DividerTopology {
+    SensorHigh,  /**< Sensor entre Vref e o ADC, resistor série ao GND: R = Rs · (max/raw − 1). KY-013. */
+    SensorLow    /**< Resistor série entre Vref e o ADC, sensor ao GND: R = Rs · raw/(max − raw). */
+};
+
+/**
+ * @struct VoltageDivider
+ * @brief Divisor de tensão com resistor série de `SeriesOhms` Ω lido por um ADC `Adc`.
+ */
+template <unsigned long SeriesOhms, typename Adc, DividerTopology Topology = DividerTopology::SensorHigh>
+struct VoltageDivider {
+    static constexpr float seriesResistor = static_cast<float>(SeriesOhms); /**< Resistor série (Ω). */
+    static constexpr float adcMax = Adc::maxValue;                          /**< Maior leitura do ADC. */
+
+    /**
+     * @brief Resistência do sensor para uma leitura; `false` se a leitura não corresponder a uma resistência finita e positiva.
+     */
+    static inline bool resistance(float raw, float &ohms) {
+        if (!(raw > 0.0f) || !(raw < adcMax))
+            return false;
+        ohms = Topology == DividerTopology::SensorHigh
+             ? seriesResistor * (adcMax / raw - 1.0f)
+             : seriesResistor * raw / (adcMax - raw);
+        return true;
+    }
+};
+
+/**
+ * @struct SteinhartHart
+ * @brief NTC pela equação de Steinhart-Hart: 1/T = A + B·ln R + C·(ln R)³.
+ *
+ * `Coef` define `static constexpr float A, B, C`.
+ */
+template <typename Coef>
+struct SteinhartHart {
+    template <typename Divider>
+    static inline float convert(float raw) {
+        float r;
+        if (!Divider::resistance(raw, r))
+            return MODEL_ERROR_VALUE;
+        const float l = std::log(r);
+        return 1.0f / (Coef::A + Coef::B * l + Coef::C * l * l * l) - 273.15f;
+    }
+};
+
+/**
+ * @struct BetaModel
+ * @brief NTC pelo parâmetro B: 1/T = 1/T0 + ln(R/R0)/B.
+ *
+ * `Coef` define `static constexpr float beta, r0, t0Celsius`.
+ */
+template <typename Coef>
+struct BetaModel {
+    template <typename Divider>
+    static inline float convert(float raw) {
+        constexpr float invT0 = 1.0f / (Coef::t0Celsius + 273.15f);
+        constexpr float invBeta = 1.0f / Coef::beta;
+        constexpr float invR0 = 1.0f / Coef::r0;
+        float r;
+        if (!Divider::resistance(raw, r))
+            return MODEL_ERROR_VALUE;
+        return 1.0f / (invT0 + std::log(r * invR0) * invBeta) - 273.15f;
+    }
+};
+
+/**
+ * @struct LinearRtd
+ * @brief RTD (ex: PT100) na aproximação linear: R = R0 · (1 + α·T).
+ *
+ * `Coef` define `static constexpr float r0, alpha`.
+ */
+template <typename Coef>
+struct LinearRtd {
+    template <typename Divider>
+    static inline float convert(float raw) {
+        constexpr float invR0 = 1.0f / Coef::r0;
+        constexpr float invAlpha = 1.0f / Coef::alpha;
+        float r;
+        if (!Divider::resistance(raw, r))
+            return MODEL_ERROR_VALUE;
+        return (r * invR0 - 1.0f) * invAlpha;
+    }
+};
+
+/**
+ * @struct RawVoltage
+ * @brief Tensão no pino do ADC, sem modelo de sensor: V = raw / max · Vref.
+ *
+ * `Coef` define `static constexpr float vref`. Apenas a resolução do
+ * divisor é usada.
+ */
+template <typename Coef>
+struct RawVoltage {
+    template <typename Divider>
+    static inline float convert(float raw) {
+        constexpr float scale = Coef::vref / Divider::adcMax;
+        if (!(raw >= 0.0f))
+            return MODEL_ERROR_VALUE;
+        return raw * scale;
+    }
+};
+
+/**
+ * @struct SensorModel
+ * @brief Conversor completo: modelo `Model` lido através do divisor `Divider`.
+ */
+template <typename Model, typename Divider>
+struct SensorModel {
+    /**
+     * @brief Converte uma leitura (possivelmente fracionária, após filtros).
+     */
+    static inline float convert(float raw) {
+        return Model::template convert<Divider>(raw);
+    }
+
+    /**
+     * @brief Converte um bloco de leituras.
+     */
+    static void convertBlock(const std::uint16_t *in, float *out, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = Model::template convert<Divider>(static_cast<float>(in[i]));
+    }
+};
+
+/**
+ * @struct RawConverter
+ * @brief Conversor escolhido em tempo de compilação, guardado por um `Sensor`.
+ *
+ * Com os ponteiros nulos (padrão), o sensor usa a calibração em tempo de
+ * execução (`ThermistorCalibration`).
+ */
+struct RawConverter {
+    float (*convert)(float raw) = nullptr;                                        /**< Uma leitura. */
+    void (*convertBlock)(const std::uint16_t *in, float *out, std::size_t n) = nullptr; /**< Um bloco. */
+};
+
+/**
+ * @brief Conversor de um `SensorModel`.
+ */
+template <typename M>
+RawConverter makeConverter() {
+    RawConverter c;
+    c.convert = &M::convert;
+    c.convertBlock = &M::convertBlock;
+    return c;
+}
+
+/**
+ * @struct Ky013Coefficients
+ * @brief Coeficientes de Steinhart-Hart do NTC do módulo KY-013 (10 kΩ).
+ *
+ * São também os valores padrão de `ThermistorCalibration`.
+ */
+struct Ky013Coefficients {
+    static constexpr float A = 1.009249522e-03f;
+    static constexpr float B = 9.18160536e-05f;
+    static constexpr float C = 2.00265654e-06f;
+};
+
+/**
+ * @struct Pt100Coefficients
+ * @brief PT100 IEC 60751 (α = 0.00385).
+ */
+struct Pt100Coefficients {
+    static constexpr float r0 = 100.0f;
+    static constexpr float alpha = 0.00385f;
+};
+
+/** KY-013 no kit: Steinhart-Hart, resistor série de 10 kΩ, ADC de 16 bits. */
+using Ky013Model = SensorModel<SteinhartHart<Ky013Coefficients>,
+                               VoltageDivider<10000, AdcResolution<16>, DividerTopology::SensorHigh>>;
+
+#endif // THERMISTOR_MODELS_HPP
@@ -6,12 +6,94 @@
  * pela rede utilizando o protocolo UDP (User Datagram Protocol).
  * É ideal para aplicações leves de comunicação, como transmissão
  * de dados de sensores para um servidor.
+ *
+ * Além do destino principal, o cliente mantém um conjunto de destinos
+ * adicionais (unicast IPv4/IPv6 ou grupos multicast), cada um com a sua
+ * codificação e divisor de taxa; `sendToAll()` serializa a leitura uma vez
+ * por codificação e a entrega a todos com um `sendmmsg()` por família de
+ * endereços.
  */
 
 #ifndef UDP_CLIENT_HPP
 #define UDP_CLIENT_HPP
 
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "udp_protocol.hpp"
+
+/**
+ * @enum WireEncoding
+ * @brief Codificação usada por `UDPClient::sendPacket()` para o destino.
+ */
+enum class WireEncoding {
+    Json,    /**< JSON de `serialize()` (padrão). */
+    Binary,  /**< Registro binário de 14 bytes (22 com sequência) de `encodeBinary()`. */
+};
+
+/**
+ * @struct UdpSendStats
+ * @brief Contadores de envio de um `UDPClient`.
+ */
+struct UdpSendStats {
+    std::uint64_t calls = 0;        /**< Chamadas de sistema de envio (send/sendmmsg/sendmsg). */
+    std::uint64_t datagrams = 0;    /**< Datagramas aceitos pelo kernel. */
+    std::uint64_t bytes = 0;        /**< Bytes de payload aceitos pelo kernel. */
+    std::uint64_t eagainDrops = 0;  /**< Datagramas descartados por EAGAIN (modo não bloqueante). */
+    std::uint64_t errors = 0;       /**< Datagramas perdidos por outros erros. */
+    std::uint64_t gsoFallbacks = 0; /**< Envios segmentados refeitos sem GSO. */
+};
+
+/**
+ * @struct UdpDestination
+ * @brief Destino adicional de um `UDPClient` (ver `UDPClient::addDestination()`).
+ */
+struct UdpDestination {
+    std::string address;                        /**< IPv4 ou IPv6, unicast ou multicast (ex: "239.1.2.3", "ff15::42"). */
+    int port = 0;                               /**< Porta UDP. */
+    WireEncoding encoding = WireEncoding::Json; /**< Codificação dos pacotes para este destino. */
+    unsigned rateDivisor = 1;                   /**< Envia 1 a cada `rateDivisor` leituras de cada sensor. */
+    int multicastTtl = 1;                       /**< TTL (IPv4) ou limite de saltos (IPv6) dos datagramas multicast. */
+    std::string multicastInterface;             /**< Interface de saída do multicast (ex: "eth0"); vazio = rota padrão. */
+};
+
+/**
+ * @struct UdpDestinationStats
+ * @brief Contadores de um destino do conjunto.
+ */
+struct UdpDestinationStats {
+    std::uint64_t sent = 0;     /**< Datagramas aceitos pelo kernel. */
+    std::uint64_t skipped = 0;  /**< Leituras puladas pelo divisor de taxa. */
+    std::uint64_t dropped = 0;  /**< Datagramas perdidos (EAGAIN ou erro). */
+};
+
+/**
+ * @brief Interpreta a descrição textual de um destino.
+ *
+ * Formato: `endereço:porta[,binary][,div=N][,ttl=N][,if=interface]`, com
+ * endereços IPv6 entre colchetes (ex: `239.1.2.3:6000,binary,div=10,ttl=4`,
+ * `[ff02::1]:6000,if=eth0`).
+ *
+ * @param spec Descrição do destino.
+ * @param out Destino preenchido.
+ * @return `false` se a descrição for inválida (o erro é mostrado).
+ */
+bool parseDestination(const std::string &spec, UdpDestination &out);
+
+/**
+ * @brief Indica se um erro de envio aponta o enlace com o servidor fora do ar.
+ *
+ * São erros de rota e de destino (ENETUNREACH, EHOSTUNREACH, ECONNREFUSED,
+ * ENETDOWN, EHOSTDOWN, ENOTCONN). EAGAIN e ENOBUFS (buffer do socket ou
+ * fila da interface cheios) não são: o datagrama é descartado, mas os
+ * próximos passam.
+ *
+ * @param err Valor de `errno` (ver `UDPClient::getLastError()`).
+ */
+bool isLinkError(int err);
 
 /**
  * @class UDPClient
@@ -19,19 +101,26 @@
  *
  * A classe abstrai a criação do socket, configuração do endereço
  * do servidor e envio de pacotes de dados no formato texto.
+ *
+ * O endereço é resolvido e o socket é conectado (`connect()`) uma única
+ * vez no construtor. Datagramas enfileirados podem ser enviados em lote
+ * com `sendBatch()` (`sendmmsg()`) ou, para segmentos de mesmo tamanho,
+ * com `sendSegmented()` (offload `UDP_SEGMENT`, quando suportado).
  */
 class UDPClient {
 public:
     /**
      * @brief Construtor da classe UDPClient.
      *
-     * Cria um cliente UDP e armazena o endereço IP e a porta do servidor
-     * para o qual os dados serão enviados.
+     * Cria um socket UDP e o conecta ao endereço IP e à porta do servidor
+     * para o qual os dados serão enviados. Espaços em volta do IP são ignorados.
+     * O servidor passa a ser o destino 0 de `sendToAll()`.
      *
-     * @param ip Endereço IP do servidor de destino (ex: "192.168.0.10").
+     * @param ip Endereço IPv4 ou IPv6 do servidor de destino (ex: "192.168.0.10").
      * @param port Porta UDP do servidor de destino.
+     * @param encoding Codificação dos pacotes enviados por `sendPacket()`.
      */
-    UDPClient(const std::string &ip, int port);
+    UDPClient(const std::string &ip, int port, WireEncoding encoding = WireEncoding::Json);
 
     /**
      * @brief Destrutor da classe UDPClient.
@@ -48,10 +137,200 @@ public:
      */
     bool sendData(const std::string &data);
 
+    /**
+     * @brief Envia um bloco de bytes como um único datagrama.
+     *
+     * @param data Início dos dados (ex: buffer preenchido por `serializeInto()`).
+     * @param len Tamanho dos dados, em bytes.
+     * @return `true` se o envio for bem-sucedido, `false` em caso de erro.
+     */
+    bool sendData(const void *data, std::size_t len);
+
+    /**
+     * @brief Codifica e envia um pacote na codificação configurada para o destino.
+     *
+     * @param p Pacote a ser enviado.
+     * @return `true` se o envio for bem-sucedido, `false` em caso de erro.
+     */
+    bool sendPacket(const UdpPacket &p);
+
+    /**
+     * @brief Envia vários datagramas com o mínimo de chamadas de sistema.
+     *
+     * Cada `iovec` é um datagrama. Os envios são feitos com `sendmmsg()`
+     * em blocos de até 64 mensagens. No modo não bloqueante, os datagramas
+     * que não couberem no buffer do socket (EAGAIN) são descartados e
+     * contados em `UdpSendStats::eagainDrops`.
+     *
+     * @param datagrams Vetor de datagramas.
+     * @param count Número de datagramas.
+     * @return Número de datagramas aceitos pelo kernel.
+     */
+    std::size_t sendBatch(const iovec *datagrams, std::size_t count);
+
+    /**
+     * @brief Envia um buffer como uma sequência de datagramas de tamanho fixo.
+     *
+     * Usa o offload de segmentação genérica (`UDP_SEGMENT`, Linux ≥ 4.18):
+     * uma única chamada envia até 64 segmentos de `segmentSize` bytes (o
+     * último pode ser menor). Se o kernel não suportar, recorre a `sendBatch()`.
+     *
+     * @param data Início do buffer.
+     * @param len Tamanho total, em bytes (até 65507).
+     * @param segmentSize Tamanho de cada datagrama.
+     * @return Número de datagramas aceitos pelo kernel.
+     */
+    std::size_t sendSegmented(const void *data, std::size_t len, std::uint16_t segmentSize);
+
+    /**
+     * @brief Acrescenta um destino ao conjunto de `sendToAll()`.
+     *
+     * O endereço é resolvido uma vez. Para multicast, o TTL e a interface
+     * vão em mensagens de controle de cada datagrama (`IP_TTL`/`IP_PKTINFO`
+     * ou `IPV6_HOPLIMIT`/`IPV6_PKTINFO`), de modo que destinos com opções
+     * diferentes compartilham o mesmo socket.
+     *
+     * @param dest Destino.
+     * @return Índice do destino (o principal é o 0), ou -1 se for inválido ou o conjunto estiver cheio.
+     */
+    int addDestination(const UdpDestination &dest);
+
+    /**
+     * @brief Número de destinos do conjunto, incluindo o principal.
+     */
+    std::size_t destinationCount() const;
+
+    /**
+     * @brief Retorna os contadores do destino `index`.
+     */
+    const UdpDestinationStats &getDestinationStats(std::size_t index) const;
+
+    /**
+     * @brief Envia um pacote a todos os destinos cujo divisor de taxa o aceite.
+     *
+     * O pacote é codificado uma vez por codificação em uso (JSON e/ou
+     * binário) e os datagramas são enviados com um `sendmmsg()` por família
+     * de endereços. O divisor de taxa é contado por `sensor_num`.
+     *
+     * Os destinos adicionais são de melhor esforço: falhas apenas entram em
+     * `getDestinationStats()`. O resultado reflete o destino principal, o
+     * único com spool.
+     *
+     * @param p Pacote a ser enviado.
+     * @param json JSON de `p` já serializado (ex: por `serializeInto()` com o prefixo do sensor), ou `nullptr`.
+     * @param jsonLen Tamanho de `json`.
+     * @param binary Registro binário já codificado (ex: `encodeBinarySummary()`), ou `nullptr` para `encodeBinary()`.
+     * @param binaryLen Tamanho de `binary`.
+     * @return `true` se o destino principal aceitou o datagrama.
+     */
+    bool sendToAll(const UdpPacket &p, const char *json = nullptr, std::size_t jsonLen = 0,
+                   const std::uint8_t *binary = nullptr, std::size_t binaryLen = 0);
+
+    /**
+     * @brief Lê, sem esperar, um datagrama enviado pelo servidor principal (ex: um NACK).
+     *
+     * O socket conectado só recebe datagramas do endereço e da porta do
+     * servidor; erros de ICMP pendentes (ex: porta inacessível) são
+     * descartados.
+     *
+     * @param buf Buffer de destino.
+     * @param cap Capacidade de `buf`.
+     * @return Tamanho do datagrama (truncado em `cap`), ou -1 se não houver nenhum.
+     */
+    long receiveData(void *buf, std::size_t cap);
+
+    /**
+     * @brief Ativa ou desativa o modo não bloqueante do socket.
+     *
+     * @param enable `true` para não bloquear quando o buffer do socket estiver cheio.
+     * @return `true` se o modo foi aplicado.
+     */
+    bool setNonBlocking(bool enable);
+
+    /**
+     * @brief Indica se o socket está pronto (criado e conectado).
+     */
+    bool isConnected() const;
+
+    /**
+     * @brief Retorna os contadores de envio.
+     */
+    const UdpSendStats &getStats() const;
+
+    /**
+     * @brief `errno` do último envio ao servidor principal (`sendData()`, `sendPacket()` ou `sendToAll()`).
+     *
+     * @return 0 se o último envio foi aceito pelo kernel.
+     */
+    int getLastError() const;
+
+    /**
+     * @brief Define a codificação usada por `sendPacket()`.
+     */
+    void setEncoding(WireEncoding enc);
+
+    /**
+     * @brief Retorna a codificação usada por `sendPacket()`.
+     */
+    WireEncoding getEncoding() const;
+
 private:
-    int sockfd;              /**< Descritor do socket UDP. */
+    /**
+     * @brief Registra o resultado de envios que falharam com `errno`.
+     */
+    void countFailure(int err, std::size_t lost);
+
+    /**
+     * @brief Envia mensagens já montadas com `sendmmsg()`, em blocos de até 64.
+     *
+     * Um erro diferente de EAGAIN descarta apenas a mensagem que falhou;
+     * EAGAIN descarta o restante. Mensagens não enviadas ficam com `msg_len` 0.
+     *
+     * @param firstError Se não for nulo, recebe o `errno` que descartou a primeira mensagem (0 = aceita).
+     * @return Número de mensagens aceitas pelo kernel.
+     */
+    std::size_t submit(int fd, mmsghdr *msgs, std::size_t count, int *firstError = nullptr);
+
+    /**
+     * @brief Socket da família `af` (criado no primeiro uso), ou -1.
+     */
+    int socketFor(int af);
+
+    /** Tamanho do espaço para mensagens de controle de um destino. */
+    static const std::size_t CONTROL_SPACE = 96;
+
+    /**
+     * @struct Destination
+     * @brief Destino resolvido, com as mensagens de controle já montadas.
+     */
+    struct Destination {
+        sockaddr_storage addr;              /**< Endereço de destino. */
+        socklen_t addrLen;                  /**< Tamanho de `addr`. */
+        WireEncoding encoding;              /**< Codificação. */
+        unsigned rateDivisor;               /**< Divisor de taxa (≥ 1). */
+        std::vector<unsigned> countdown;    /**< Leituras a pular, por `sensor_num` (cresce ao ver um número maior; vazio com divisor 1). */
+        alignas(cmsghdr) char control[CONTROL_SPACE]; /**< TTL e interface do multicast. */
+        std::size_t controlLen;             /**< Bytes usados em `control` (0 = nenhum). */
+        UdpDestinationStats stats;          /**< Contadores. */
+    };
+
+    /**
+     * @brief Resolve `dest` em `out`; `false` se o endereço ou a interface forem inválidos.
+     */
+    static bool resolve(const UdpDestination &dest, Destination &out);
+
+    int sockfd;              /**< Descritor do socket UDP (conectado ao destino principal). */
+    int familyFd[2];         /**< Socket de cada família (IPv4, IPv6) para `sendToAll()`; o da principal é `sockfd`. */
+    bool nonBlocking;        /**< Modo de `setNonBlocking()`, aplicado também aos sockets criados depois. */
     std::string server_ip;   /**< Endereço IP do servidor de destino. */
     int server_port;         /**< Porta UDP do servidor de destino. */
+    WireEncoding encoding;   /**< Codificação usada por `sendPacket()`. */
+    bool connected;          /**< Socket conectado ao destino. */
+    bool gsoSupported;       /**< `UDP_SEGMENT` ainda não foi recusado pelo kernel por falta de suporte. */
+    bool gsoConfirmed;       /**< Algum envio com `UDP_SEGMENT` já foi aceito. */
+    UdpSendStats stats;      /**< Contadores de envio. */
+    int lastError;           /**< `errno` do último envio ao servidor principal (0 = aceito). */
+    std::vector<Destination> destinations; /**< Conjunto de `sendToAll()`; o principal é o 0. */
 };
 
 #endif // UDP_CLIENT_HPP
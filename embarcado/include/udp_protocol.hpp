@@ -11,9 +11,12 @@
 #define UDP_PROTOCOL_HPP
 
 #include <string>
-#include <sstream>
-#include <iomanip>
 #include <ctime>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <string_view>
 
 /**
  * @struct UdpPacket
@@ -22,35 +25,469 @@
  * Contém as informações básicas enviadas por um sensor, incluindo
  * o identificador do grupo, o ID do sensor, o valor medido, a unidade
  * e o timestamp UTC da leitura.
+ *
+ * Os campos `sensor_num` e `epoch_ns` são usados pela codificação binária
+ * (`binary_protocol.hpp`) e não aparecem no JSON.
+ *
+ * Com `session` diferente de zero, o pacote leva também a sessão do
+ * remetente, o `sensor_num` e o número de sequência da leitura, com os
+ * quais o receptor conta perdas e pede retransmissões (`sequence.hpp`).
  */
 struct UdpPacket {
-    std::string group_id;   /**< Identificador do grupo de sensores (ex: "Temperatura"). */
-    std::string sensor_id;  /**< Identificador único do sensor (ex: "Sensor1"). */
-    double value;           /**< Valor medido pelo sensor. */
-    std::string unit;       /**< Unidade de medida (ex: "°C", "V"). */
-    std::string timestamp;  /**< Data/hora da leitura no formato ISO8601 (UTC). */
+    std::string group_id;       /**< Identificador do grupo de sensores (ex: "Temperatura"). */
+    std::string sensor_id;      /**< Identificador único do sensor (ex: "Sensor1"). */
+    double value = 0.0;         /**< Valor medido pelo sensor. */
+    std::string unit;           /**< Unidade de medida (ex: "°C", "V"). */
+    std::string timestamp;      /**< Data/hora da leitura no formato ISO8601 (UTC). */
+    std::uint16_t sensor_num = 0; /**< Identificador numérico do sensor (formato binário). */
+    std::int64_t epoch_ns = 0;  /**< Instante da leitura em ns desde 1970-01-01 UTC. */
+    std::uint32_t session = 0;  /**< Sessão do remetente, sorteada a cada início (0 = sem sequência). */
+    std::uint32_t seq = 0;      /**< Número de sequência da leitura, crescente por sensor. */
+};
+
+/**
+ * @struct UdpSummaryPacket
+ * @brief Resumo de uma janela de leituras (ver `WindowAggregator`).
+ *
+ * Estende `UdpPacket`: `value` é a média da janela e `epoch_ns`/`timestamp`
+ * o seu fim, de modo que um receptor que ignora os campos de janela vê o
+ * resumo como uma leitura comum.
+ */
+struct UdpSummaryPacket : UdpPacket {
+    std::int64_t window_start_ns = 0;  /**< Início da janela (ns desde 1970, UTC). */
+    std::string window_start;          /**< Início da janela em ISO8601. */
+    std::uint32_t count = 0;           /**< Leituras na janela. */
+    double min = 0.0;                  /**< Menor leitura. */
+    double max = 0.0;                  /**< Maior leitura. */
+    double stddev = 0.0;               /**< Desvio padrão amostral. */
+    double p50 = 0.0;                  /**< Mediana (NaN = não calculada). */
+    double p90 = 0.0;                  /**< Percentil 90 (NaN = não calculado). */
+    double p99 = 0.0;                  /**< Percentil 99 (NaN = não calculado). */
+};
+
+/**
+ * @brief Retorna o instante atual em nanossegundos desde a época Unix (UTC).
+ *
+ * @return Nanossegundos desde 1970-01-01T00:00:00Z (`CLOCK_REALTIME`).
+ */
+inline std::int64_t currentEpochNs() {
+    std::timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @enum TimestampPrecision
+ * @brief Casas da fração de segundo em um timestamp ISO8601.
+ */
+enum class TimestampPrecision {
+    Seconds,       /**< `2025-10-22T22:15:30Z` */
+    Milliseconds,  /**< `2025-10-22T22:15:30.123Z` */
+    Microseconds   /**< `2025-10-22T22:15:30.123456Z` */
 };
 
+/**
+ * @brief Formata um instante em UTC no formato ISO8601 em um buffer do chamador.
+ *
+ * A parte `AAAA-MM-DDTHH:MM:` é calculada com `gmtime_r()` apenas quando o
+ * minuto muda e guardada em um cache por thread (`thread_local`); nas demais
+ * chamadas só os segundos e a fração são escritos. Não aloca memória e pode
+ * ser chamada de várias threads.
+ *
+ * @param epochNs Nanossegundos desde a época Unix.
+ * @param precision Casas da fração de segundo (truncada, não arredondada).
+ * @param buf Buffer de destino (não recebe terminador nulo).
+ * @param cap Capacidade de `buf` (32 bytes bastam).
+ * @return Número de bytes escritos, ou 0 se não couber.
+ */
+inline std::size_t formatTimestampInto(std::int64_t epochNs, TimestampPrecision precision,
+                                       char *buf, std::size_t cap)
+{
+    struct MinuteCache {
+        std::int64_t minute = INT64_MIN;  /**< Minuto (desde a época) de `prefix`. */
+        char prefix[32];                  /**< `AAAA-MM-DDTHH:MM:` */
+        std::size_t len = 0;              /**< Tamanho de `prefix`. */
+    };
+    static thread_local MinuteCache cache;
+
+    // Divisões arredondadas para baixo, para instantes anteriores a 1970
+    std::int64_t sec = epochNs / 1000000000LL;
+    std::int64_t nsInSec = epochNs % 1000000000LL;
+    if (nsInSec < 0) {
+        nsInSec += 1000000000LL;
+        --sec;
+    }
+    std::int64_t minute = sec / 60;
+    int secInMin = static_cast<int>(sec % 60);
+    if (secInMin < 0) {
+        secInMin += 60;
+        --minute;
+    }
+
+    if (minute != cache.minute) {
+        std::time_t t = static_cast<std::time_t>(minute * 60);
+        std::tm gmt;
+        if (!gmtime_r(&t, &gmt))
+            return 0;
+        cache.len = std::strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%dT%H:%M:", &gmt);
+        cache.minute = cache.len ? minute : INT64_MIN;
+    }
+
+    const unsigned digits = precision == TimestampPrecision::Microseconds ? 6
+                          : precision == TimestampPrecision::Milliseconds ? 3 : 0;
+    const std::size_t total = cache.len + 2 + (digits ? digits + 1 : 0) + 1;
+    if (cache.len == 0 || cap < total)
+        return 0;
+
+    char *p = buf;
+    std::memcpy(p, cache.prefix, cache.len);
+    p += cache.len;
+    *p++ = static_cast<char>('0' + secInMin / 10);
+    *p++ = static_cast<char>('0' + secInMin % 10);
+    if (digits) {
+        *p++ = '.';
+        std::uint32_t frac = static_cast<std::uint32_t>(nsInSec / (digits == 3 ? 1000000 : 1000));
+        for (unsigned i = digits; i-- > 0; frac /= 10)
+            p[i] = static_cast<char>('0' + frac % 10);
+        p += digits;
+    }
+    *p++ = 'Z';
+    return static_cast<std::size_t>(p - buf);
+}
+
+/**
+ * @brief Formata um instante em UTC no formato ISO8601.
+ *
+ * @param epochNs Nanossegundos desde a época Unix.
+ * @param precision Casas da fração de segundo (padrão: nenhuma).
+ * @return String no formato `"2025-10-22T22:15:30Z"` (ou com `.mmm`/`.uuuuuu`).
+ */
+inline std::string formatTimestamp(std::int64_t epochNs,
+                                   TimestampPrecision precision = TimestampPrecision::Seconds)
+{
+    char buf[32];
+    return std::string(buf, formatTimestampInto(epochNs, precision, buf, sizeof(buf)));
+}
+
 /**
  * @brief Gera um timestamp atual em UTC no formato ISO8601.
  *
  * Exemplo de saída: `"2025-10-22T22:15:30Z"`.
  *
+ * @param precision Casas da fração de segundo (padrão: nenhuma).
  * @return String contendo o timestamp atual no formato ISO8601.
  */
-inline std::string currentTimestamp() {
-    std::time_t t = std::time(nullptr);
-    std::tm *gmt = std::gmtime(&t);
-    char buf[64];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", gmt);
-    return std::string(buf);
+inline std::string currentTimestamp(TimestampPrecision precision = TimestampPrecision::Seconds) {
+    return formatTimestamp(currentEpochNs(), precision);
+}
+
+/**
+ * @brief Converte um timestamp ISO8601 UTC (inverso de `formatTimestamp()`) em ns desde a época Unix.
+ *
+ * Aceita `AAAA-MM-DDTHH:MM:SSZ`, com fração de segundo opcional
+ * (`…SS.mmmZ`, `…SS.uuuuuuZ`, até 9 dígitos). Não aloca memória.
+ *
+ * @param ts Timestamp como enviado no pacote.
+ * @param epochNs Instante convertido.
+ * @return `true` se o formato for válido.
+ */
+inline bool parseTimestamp(std::string_view ts, std::int64_t &epochNs) {
+    auto num = [&ts](std::size_t pos, std::size_t len, int &out) {
+        out = 0;
+        for (std::size_t i = pos; i < pos + len; ++i) {
+            if (ts[i] < '0' || ts[i] > '9')
+                return false;
+            out = out * 10 + (ts[i] - '0');
+        }
+        return true;
+    };
+
+    int y, mo, d, h, mi, sec;
+    if (ts.size() < 20 || ts[4] != '-' || ts[7] != '-' || ts[10] != 'T' || ts[13] != ':' ||
+        ts[16] != ':' || ts.back() != 'Z' ||
+        !num(0, 4, y) || !num(5, 2, mo) || !num(8, 2, d) ||
+        !num(11, 2, h) || !num(14, 2, mi) || !num(17, 2, sec) ||
+        mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || sec > 60)
+        return false;
+
+    std::int64_t frac = 0;
+    std::size_t pos = 19;
+    if (ts[pos] == '.') {
+        if (pos + 2 >= ts.size())
+            return false;
+        std::int64_t scale = 100000000;
+        for (++pos; pos + 1 < ts.size(); ++pos, scale /= 10) {
+            if (ts[pos] < '0' || ts[pos] > '9' || scale == 0)
+                return false;
+            frac += (ts[pos] - '0') * scale;
+        }
+    }
+    if (pos != ts.size() - 1)
+        return false;
+
+    // Dias desde 1970-01-01 (algoritmo "days_from_civil" de H. Hinnant)
+    const int yy = y - (mo <= 2);
+    const int era = (yy >= 0 ? yy : yy - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(yy - era * 400);
+    const unsigned doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const std::int64_t days = static_cast<std::int64_t>(era) * 146097 + doe - 719468;
+
+    epochNs = ((days * 24 + h) * 60 + mi) * 60 + sec;
+    epochNs = epochNs * 1000000000LL + frac;
+    return true;
+}
+
+/**
+ * @brief Copia uma string para `buf` aplicando o escape de strings JSON.
+ *
+ * Aspas e barras invertidas recebem `\`, caracteres de controle viram
+ * `\n`, `\t`, ... ou `\u00XX`. Bytes UTF-8 (ex: "°") são copiados como estão.
+ *
+ * @param s String de origem.
+ * @param buf Posição de escrita.
+ * @param end Fim do buffer.
+ * @return Nova posição de escrita, ou `nullptr` se não couber.
+ */
+inline char *appendJsonEscaped(const std::string &s, char *buf, char *end) {
+    static const char hex[] = "0123456789abcdef";
+
+    for (unsigned char c : s) {
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            if (buf == end)
+                return nullptr;
+            *buf++ = static_cast<char>(c);
+            continue;
+        }
+
+        char esc = 0;
+        switch (c) {
+        case '"':  esc = '"';  break;
+        case '\\': esc = '\\'; break;
+        case '\b': esc = 'b';  break;
+        case '\f': esc = 'f';  break;
+        case '\n': esc = 'n';  break;
+        case '\r': esc = 'r';  break;
+        case '\t': esc = 't';  break;
+        default: break;
+        }
+
+        if (esc) {
+            if (end - buf < 2)
+                return nullptr;
+            *buf++ = '\\';
+            *buf++ = esc;
+        } else {
+            if (end - buf < 6)
+                return nullptr;
+            std::memcpy(buf, "\\u00", 4);
+            buf[4] = hex[c >> 4];
+            buf[5] = hex[c & 0xF];
+            buf += 6;
+        }
+    }
+    return buf;
+}
+
+/**
+ * @brief Copia um literal para `buf`.
+ *
+ * @return Nova posição de escrita, ou `nullptr` se não couber.
+ */
+inline char *appendLiteral(const char *lit, std::size_t len, char *buf, char *end) {
+    if (static_cast<std::size_t>(end - buf) < len)
+        return nullptr;
+    std::memcpy(buf, lit, len);
+    return buf + len;
+}
+
+/**
+ * @brief Monta o prefixo JSON constante de um sensor.
+ *
+ * O resultado (`{"group":"…","sensor_id":"…",`) não muda entre leituras e
+ * deve ser calculado uma vez por sensor e reutilizado em `serializeInto()`.
+ *
+ * @param group Identificador do grupo.
+ * @param sensor Identificador do sensor.
+ * @return Prefixo JSON, com as strings já escapadas.
+ */
+inline std::string jsonPrefix(const std::string &group, const std::string &sensor) {
+    std::string out(24 + 6 * (group.size() + sensor.size()), '\0');
+    char *buf = &out[0];
+    char *end = buf + out.size();
+
+    buf = appendLiteral("{\"group\":\"", 10, buf, end);
+    buf = appendJsonEscaped(group, buf, end);
+    buf = appendLiteral("\",\"sensor_id\":\"", 15, buf, end);
+    buf = appendJsonEscaped(sensor, buf, end);
+    buf = appendLiteral("\",", 2, buf, end);
+
+    out.resize(buf - out.data());
+    return out;
+}
+
+/**
+ * @brief Escreve um número em ponto fixo com `decimals` casas.
+ *
+ * @return Nova posição de escrita, ou `nullptr` se não couber.
+ */
+inline char *appendFixed(double v, int decimals, char *buf, char *end) {
+    if (!buf)
+        return nullptr;
+    std::to_chars_result r = std::to_chars(buf, end, v, std::chars_format::fixed, decimals);
+    return (r.ec == std::errc()) ? r.ptr : nullptr;
+}
+
+/**
+ * @brief Escreve um inteiro sem sinal.
+ *
+ * @return Nova posição de escrita, ou `nullptr` se não couber.
+ */
+inline char *appendUnsigned(std::uint32_t v, char *buf, char *end) {
+    if (!buf)
+        return nullptr;
+    std::to_chars_result r = std::to_chars(buf, end, v);
+    return (r.ec == std::errc()) ? r.ptr : nullptr;
+}
+
+/**
+ * @brief Escreve os campos variáveis do JSON (`"value":…,"unit":"…","ts":"…"`), sem fechar o objeto.
+ *
+ * O valor é formatado com `std::to_chars` (ponto fixo, 2 casas), produzindo
+ * os mesmos bytes que `std::fixed << std::setprecision(2)`, sem depender
+ * de locale. Com `session` diferente de zero, seguem
+ * `,"session":…,"sensor_num":…,"seq":…`.
+ *
+ * @return Nova posição de escrita, ou `nullptr` se não couber.
+ */
+inline char *appendJsonFields(const UdpPacket &p, char *buf, char *end) {
+    buf = appendLiteral("\"value\":", 8, buf, end);
+    buf = appendFixed(p.value, 2, buf, end);
+    if (buf) buf = appendLiteral(",\"unit\":\"", 9, buf, end);
+    if (buf) buf = appendJsonEscaped(p.unit, buf, end);
+    if (buf) buf = appendLiteral("\",\"ts\":\"", 8, buf, end);
+    if (buf) buf = appendJsonEscaped(p.timestamp, buf, end);
+    if (buf) buf = appendLiteral("\"", 1, buf, end);
+    if (buf && p.session != 0) {
+        buf = appendLiteral(",\"session\":", 11, buf, end);
+        buf = appendUnsigned(p.session, buf, end);
+        if (buf) buf = appendLiteral(",\"sensor_num\":", 14, buf, end);
+        buf = appendUnsigned(p.sensor_num, buf, end);
+        if (buf) buf = appendLiteral(",\"seq\":", 7, buf, end);
+        buf = appendUnsigned(p.seq, buf, end);
+    }
+    return buf;
+}
+
+/**
+ * @brief Escreve a parte variável do JSON (`"value":…,"unit":"…","ts":"…"}`).
+ *
+ * @return Nova posição de escrita, ou `nullptr` se não couber.
+ */
+inline char *appendJsonTail(const UdpPacket &p, char *buf, char *end) {
+    buf = appendJsonFields(p, buf, end);
+    if (buf) buf = appendLiteral("}", 1, buf, end);
+    return buf;
+}
+
+/**
+ * @brief Serializa um pacote em `buf` usando um prefixo pré-calculado.
+ *
+ * Não aloca memória. `group_id` e `sensor_id` do pacote são ignorados,
+ * pois já estão no prefixo.
+ *
+ * @param prefix Prefixo gerado por `jsonPrefix()` para o sensor do pacote.
+ * @param p Pacote a ser serializado.
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`, em bytes.
+ * @return Número de bytes escritos (sem terminador), ou 0 se não couber.
+ */
+inline std::size_t serializeInto(const std::string &prefix, const UdpPacket &p,
+                                 char *buf, std::size_t cap) {
+    char *const start = buf;
+    char *const end = buf + cap;
+
+    buf = appendLiteral(prefix.data(), prefix.size(), buf, end);
+    if (buf) buf = appendJsonTail(p, buf, end);
+
+    return buf ? static_cast<std::size_t>(buf - start) : 0;
+}
+
+/**
+ * @brief Serializa um pacote em `buf`, escapando grupo e sensor a cada chamada.
+ *
+ * @param p Pacote a ser serializado.
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`, em bytes.
+ * @return Número de bytes escritos (sem terminador), ou 0 se não couber.
+ */
+inline std::size_t serializeInto(const UdpPacket &p, char *buf, std::size_t cap) {
+    char *const start = buf;
+    char *const end = buf + cap;
+
+    buf = appendLiteral("{\"group\":\"", 10, buf, end);
+    if (buf) buf = appendJsonEscaped(p.group_id, buf, end);
+    if (buf) buf = appendLiteral("\",\"sensor_id\":\"", 15, buf, end);
+    if (buf) buf = appendJsonEscaped(p.sensor_id, buf, end);
+    if (buf) buf = appendLiteral("\",", 2, buf, end);
+    if (buf) buf = appendJsonTail(p, buf, end);
+
+    return buf ? static_cast<std::size_t>(buf - start) : 0;
+}
+
+/**
+ * @brief Serializa o resumo de uma janela em `buf`, usando o prefixo do sensor.
+ *
+ * O objeto é o de `serializeInto()` com um campo `window` no fim; os
+ * percentis só aparecem se tiverem sido calculados:
+ * @code
+ * {"group":"…","sensor_id":"…","value":25.31,"unit":"°C","ts":"2025-10-22T22:16:00.000Z",
+ *  "window":{"start":"2025-10-22T22:15:00.000Z","count":60000,"min":25.02,"max":25.77,
+ *  "stddev":0.1032,"p50":25.30,"p90":25.45,"p99":25.61}}
+ * @endcode
+ *
+ * @param prefix Prefixo gerado por `jsonPrefix()` para o sensor.
+ * @param p Resumo a ser serializado.
+ * @param buf Buffer de destino.
+ * @param cap Capacidade de `buf`, em bytes.
+ * @return Número de bytes escritos, ou 0 se não couber.
+ */
+inline std::size_t serializeSummaryInto(const std::string &prefix, const UdpSummaryPacket &p,
+                                        char *buf, std::size_t cap) {
+    char *const start = buf;
+    char *const end = buf + cap;
+
+    buf = appendLiteral(prefix.data(), prefix.size(), buf, end);
+    if (buf) buf = appendJsonFields(p, buf, end);
+    if (buf) buf = appendLiteral(",\"window\":{\"start\":\"", 20, buf, end);
+    if (buf) buf = appendJsonEscaped(p.window_start, buf, end);
+    if (buf) buf = appendLiteral("\",\"count\":", 10, buf, end);
+    buf = appendUnsigned(p.count, buf, end);
+    if (buf) buf = appendLiteral(",\"min\":", 7, buf, end);
+    buf = appendFixed(p.min, 2, buf, end);
+    if (buf) buf = appendLiteral(",\"max\":", 7, buf, end);
+    buf = appendFixed(p.max, 2, buf, end);
+    if (buf) buf = appendLiteral(",\"stddev\":", 10, buf, end);
+    buf = appendFixed(p.stddev, 4, buf, end);
+    if (buf && p.p50 == p.p50) { // NaN: percentis não calculados
+        buf = appendLiteral(",\"p50\":", 7, buf, end);
+        buf = appendFixed(p.p50, 2, buf, end);
+        if (buf) buf = appendLiteral(",\"p90\":", 7, buf, end);
+        buf = appendFixed(p.p90, 2, buf, end);
+        if (buf) buf = appendLiteral(",\"p99\":", 7, buf, end);
+        buf = appendFixed(p.p99, 2, buf, end);
+    }
+    if (buf) buf = appendLiteral("}}", 2, buf, end);
+
+    return buf ? static_cast<std::size_t>(buf - start) : 0;
 }
 
 /**
  * @brief Serializa uma estrutura `UdpPacket` em formato JSON.
  *
  * Converte os dados do pacote para uma string JSON simples,
- * adequada para envio via rede UDP.
+ * adequada para envio via rede UDP. Para evitar a alocação da string,
+ * use `serializeInto()`.
  *
  * Exemplo de saída:
  * @code
@@ -67,16 +504,344 @@ inline std::string currentTimestamp() {
  * @return String contendo os dados do pacote em formato JSON.
  */
 inline std::string serialize(const UdpPacket &p) {
-    std::ostringstream oss;
-    oss << "{";
-    oss << "\"group\":\"" << p.group_id << "\",";
-    oss << "\"sensor_id\":\"" << p.sensor_id << "\",";
-    oss << "\"value\":" << std::fixed << std::setprecision(2) << p.value << ",";
-    oss << "\"unit\":\"" << p.unit << "\",";
-    oss << "\"ts\":\"" << p.timestamp << "\"";
-    oss << "}";
-    return oss.str();
+    // Pior caso: todas as strings escapadas como \u00XX, um valor de ~310 dígitos e os campos de sequência
+    std::string out(112 + 6 * (p.group_id.size() + p.sensor_id.size() + p.unit.size() + p.timestamp.size()) + 320, '\0');
+    out.resize(serializeInto(p, &out[0], out.size()));
+    return out;
 }
 
-#endif // UDP_PROTOCOL_HPP
+/**
+ * @struct UdpPacketView
+ * @brief Pacote JSON decodificado sem cópia, por `parseJson()`.
+ *
+ * As strings apontam para o datagrama recebido e estão como no fio (ainda
+ * escapadas); use `unescapeJson()` para obter o texto original. O buffer
+ * deve permanecer válido enquanto a visão for usada.
+ */
+struct UdpPacketView {
+    std::string_view group_id;    /**< Grupo, escapado. */
+    std::string_view sensor_id;   /**< Sensor, escapado. */
+    double value = 0.0;           /**< Valor medido (média, em um resumo). */
+    std::string_view unit;        /**< Unidade, escapada. */
+    std::string_view timestamp;   /**< Timestamp ISO8601, escapado (fim da janela, em um resumo). */
+    bool hasSequence = false;     /**< Campos `session`, `sensor_num` e `seq` presentes. */
+    std::uint32_t session = 0;    /**< Sessão do remetente. */
+    std::uint16_t sensorNum = 0;  /**< Identificador numérico do sensor. */
+    std::uint32_t seq = 0;        /**< Número de sequência. */
+    bool hasWindow = false;       /**< Objeto com campo `window` (`serializeSummaryInto()`). */
+    std::string_view windowStart; /**< Início da janela, escapado. */
+    std::uint32_t count = 0;      /**< Leituras na janela. */
+    double min = 0.0;             /**< Menor leitura da janela. */
+    double max = 0.0;             /**< Maior leitura da janela. */
+    double stddev = 0.0;          /**< Desvio padrão da janela. */
+    bool hasPercentiles = false;  /**< `p50`, `p90` e `p99` presentes. */
+    double p50 = 0.0;             /**< Mediana. */
+    double p90 = 0.0;             /**< Percentil 90. */
+    double p99 = 0.0;             /**< Percentil 99. */
+};
+
+/**
+ * @brief Pula espaços em branco JSON.
+ */
+inline const char *skipJsonSpace(const char *p, const char *end) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        ++p;
+    return p;
+}
+
+/**
+ * @brief Confere e consome um literal (ex: `"sensor_id":`).
+ *
+ * @return Posição após o literal, ou `nullptr` se não coincidir.
+ */
+inline const char *expectLiteral(const char *lit, std::size_t len, const char *p, const char *end) {
+    p = p ? skipJsonSpace(p, end) : nullptr;
+    if (!p || static_cast<std::size_t>(end - p) < len || std::memcmp(p, lit, len) != 0)
+        return nullptr;
+    return p + len;
+}
+
+/**
+ * @brief Lê uma string JSON sem desfazer o escape.
+ *
+ * @param p Posição da aspa de abertura (espaços iniciais são aceitos).
+ * @param end Fim do buffer.
+ * @param out Conteúdo entre as aspas, como no fio.
+ * @return Posição após a aspa de fechamento, ou `nullptr` se malformada.
+ */
+inline const char *parseJsonString(const char *p, const char *end, std::string_view &out) {
+    p = p ? skipJsonSpace(p, end) : nullptr;
+    if (!p || p == end || *p != '"')
+        return nullptr;
 
+    const char *start = ++p;
+    while (p != end) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"') {
+            out = std::string_view(start, static_cast<std::size_t>(p - start));
+            return p + 1;
+        }
+        if (c < 0x20)
+            return nullptr;
+        if (c == '\\') {
+            if (end - p < 2)
+                return nullptr;
+            ++p;
+        }
+        ++p;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Lê um número JSON após um literal de chave (ex: `,"min":`).
+ *
+ * @return Posição após o número, ou `nullptr` se não coincidir.
+ */
+template <typename T>
+inline const char *parseJsonNumber(const char *key, std::size_t keyLen, const char *p, const char *end, T &out) {
+    p = expectLiteral(key, keyLen, p, end);
+    if (!p)
+        return nullptr;
+    p = skipJsonSpace(p, end);
+    std::from_chars_result r = std::from_chars(p, end, out);
+    return (r.ec == std::errc()) ? r.ptr : nullptr;
+}
+
+/**
+ * @brief Decodifica o campo `window` de um resumo (a partir da vírgula que o precede).
+ *
+ * @return Posição após o `}` da janela, ou `nullptr` se malformado.
+ */
+inline const char *parseJsonWindow(const char *p, const char *end, UdpPacketView &out) {
+    p = expectLiteral(",", 1, p, end);
+    p = expectLiteral("\"window\":", 9, p, end);
+    p = expectLiteral("{", 1, p, end);
+    p = expectLiteral("\"start\":", 8, p, end);
+    p = parseJsonString(p, end, out.windowStart);
+    p = parseJsonNumber(",\"count\":", 9, p, end, out.count);
+    p = parseJsonNumber(",\"min\":", 7, p, end, out.min);
+    p = parseJsonNumber(",\"max\":", 7, p, end, out.max);
+    p = parseJsonNumber(",\"stddev\":", 10, p, end, out.stddev);
+    if (!p)
+        return nullptr;
+
+    const char *q = parseJsonNumber(",\"p50\":", 7, p, end, out.p50);
+    q = parseJsonNumber(",\"p90\":", 7, q, end, out.p90);
+    q = parseJsonNumber(",\"p99\":", 7, q, end, out.p99);
+    out.hasPercentiles = q != nullptr;
+    if (q)
+        p = q;
+    p = expectLiteral("}", 1, p, end);
+    out.hasWindow = p != nullptr;
+    return p;
+}
+
+/**
+ * @brief Decodifica um objeto no formato de `serializeInto()` ou de `serializeSummaryInto()`.
+ *
+ * É o inverso exato do serializador: as chaves devem vir na mesma ordem
+ * (`group`, `sensor_id`, `value`, `unit`, `ts`, opcionalmente `session`,
+ * `sensor_num` e `seq` e, em um resumo, `window`);
+ * espaços entre os tokens são aceitos. Não aloca memória.
+ *
+ * @param p Início do objeto.
+ * @param end Fim do buffer.
+ * @param out Campos decodificados.
+ * @return Posição após o `}`, ou `nullptr` se o objeto for inválido.
+ */
+inline const char *parseJsonObject(const char *p, const char *end, UdpPacketView &out) {
+    p = expectLiteral("{", 1, p, end);
+    p = expectLiteral("\"group\":", 8, p, end);
+    p = parseJsonString(p, end, out.group_id);
+    p = expectLiteral(",", 1, p, end);
+    p = expectLiteral("\"sensor_id\":", 12, p, end);
+    p = parseJsonString(p, end, out.sensor_id);
+    p = expectLiteral(",", 1, p, end);
+    p = expectLiteral("\"value\":", 8, p, end);
+    if (p) {
+        p = skipJsonSpace(p, end);
+        std::from_chars_result r = std::from_chars(p, end, out.value);
+        p = (r.ec == std::errc()) ? r.ptr : nullptr;
+    }
+    p = expectLiteral(",", 1, p, end);
+    p = expectLiteral("\"unit\":", 7, p, end);
+    p = parseJsonString(p, end, out.unit);
+    p = expectLiteral(",", 1, p, end);
+    p = expectLiteral("\"ts\":", 5, p, end);
+    p = parseJsonString(p, end, out.timestamp);
+    out.hasSequence = false;
+    out.hasWindow = false;
+    out.hasPercentiles = false;
+    if (p) {
+        const char *q = parseJsonNumber(",\"session\":", 11, p, end, out.session);
+        if (q) {
+            q = parseJsonNumber(",\"sensor_num\":", 14, q, end, out.sensorNum);
+            p = parseJsonNumber(",\"seq\":", 7, q, end, out.seq);
+            out.hasSequence = p != nullptr;
+        }
+    }
+    if (p && expectLiteral(",", 1, p, end))
+        p = parseJsonWindow(p, end, out);
+    return expectLiteral("}", 1, p, end);
+}
+
+/**
+ * @brief Decodifica um datagrama com um único objeto JSON.
+ *
+ * @param data Datagrama recebido.
+ * @param len Tamanho do datagrama.
+ * @param out Campos decodificados.
+ * @return `true` se o datagrama contiver exatamente um objeto válido.
+ */
+inline bool parseJson(const char *data, std::size_t len, UdpPacketView &out) {
+    const char *end = data + len;
+    const char *p = parseJsonObject(data, end, out);
+    return p && skipJsonSpace(p, end) == end;
+}
+
+/**
+ * @brief Percorre os pacotes de um datagrama JSON: um objeto ou um array de objetos
+ *        (formato `BatchFormat::JsonArray`).
+ *
+ * @param data Datagrama recebido.
+ * @param len Tamanho do datagrama.
+ * @param fn Função chamada com um `UdpPacketView` para cada objeto.
+ * @return `true` se o datagrama estiver bem formado (os objetos anteriores a
+ *         um erro já terão sido entregues a `fn`).
+ */
+template <typename Fn>
+inline bool forEachJsonPacket(const char *data, std::size_t len, Fn fn) {
+    const char *end = data + len;
+    const char *p = skipJsonSpace(data, end);
+    UdpPacketView view;
+
+    if (p == end || *p != '[') {
+        if (!parseJson(data, len, view))
+            return false;
+        fn(view);
+        return true;
+    }
+
+    ++p;
+    if (expectLiteral("]", 1, p, end))
+        return skipJsonSpace(expectLiteral("]", 1, p, end), end) == end;
+
+    for (;;) {
+        p = parseJsonObject(p, end, view);
+        if (!p)
+            return false;
+        fn(view);
+
+        const char *next = expectLiteral(",", 1, p, end);
+        if (!next)
+            break;
+        p = next;
+    }
+
+    p = expectLiteral("]", 1, p, end);
+    return p && skipJsonSpace(p, end) == end;
+}
+
+/**
+ * @brief Desfaz o escape de uma string JSON (inverso de `appendJsonEscaped()`).
+ *
+ * Aceita `\"`, `\\`, `\/`, `\b`, `\f`, `\n`, `\r`, `\t` e `\u00XX`
+ * (sequências `\u` acima de 0xFF são gravadas em UTF-8).
+ *
+ * @param s String escapada.
+ * @param buf Destino.
+ * @param cap Capacidade de `buf`.
+ * @return Número de bytes escritos, ou `std::string::npos` se inválida ou sem espaço.
+ */
+inline std::size_t unescapeJson(std::string_view s, char *buf, std::size_t cap) {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c == '\\') {
+            if (++i == s.size())
+                return std::string::npos;
+            switch (s[i]) {
+            case '"':  c = '"';  break;
+            case '\\': c = '\\'; break;
+            case '/':  c = '/';  break;
+            case 'b':  c = '\b'; break;
+            case 'f':  c = '\f'; break;
+            case 'n':  c = '\n'; break;
+            case 'r':  c = '\r'; break;
+            case 't':  c = '\t'; break;
+            case 'u': {
+                unsigned cp = 0;
+                if (s.size() - i < 5)
+                    return std::string::npos;
+                std::from_chars_result r = std::from_chars(s.data() + i + 1, s.data() + i + 5, cp, 16);
+                if (r.ptr != s.data() + i + 5)
+                    return std::string::npos;
+                i += 4;
+                if (cp < 0x80) {
+                    c = static_cast<char>(cp);
+                    break;
+                }
+                // Fora de ASCII: grava em UTF-8 (2 ou 3 bytes)
+                char utf[3];
+                std::size_t k = 0;
+                if (cp < 0x800) {
+                    utf[k++] = static_cast<char>(0xC0 | (cp >> 6));
+                } else {
+                    utf[k++] = static_cast<char>(0xE0 | (cp >> 12));
+                    utf[k++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                }
+                utf[k++] = static_cast<char>(0x80 | (cp & 0x3F));
+                if (cap - n < k)
+                    return std::string::npos;
+                std::memcpy(buf + n, utf, k);
+                n += k;
+                continue;
+            }
+            default:
+                return std::string::npos;
+            }
+        }
+        if (n == cap)
+            return std::string::npos;
+        buf[n++] = c;
+    }
+    return n;
+}
+
+/**
+ * @brief Decodifica um JSON de `serialize()` em um `UdpPacket` (aloca as strings).
+ *
+ * `epoch_ns` vem de `parseTimestamp()` (0 se o `ts` não for reconhecido);
+ * `session`, `sensor_num` e `seq` são zerados se o pacote não tiver
+ * sequência, pois `serialize()` só os escreve nesse caso.
+ *
+ * @param data Datagrama recebido.
+ * @param len Tamanho do datagrama.
+ * @param p Pacote de saída.
+ * @return `true` se o datagrama for um objeto válido.
+ */
+inline bool parse(const char *data, std::size_t len, UdpPacket &p) {
+    UdpPacketView v;
+    if (!parseJson(data, len, v))
+        return false;
+
+    std::string *fields[] = { &p.group_id, &p.sensor_id, &p.unit, &p.timestamp };
+    std::string_view views[] = { v.group_id, v.sensor_id, v.unit, v.timestamp };
+    for (int i = 0; i < 4; ++i) {
+        fields[i]->resize(views[i].size());
+        std::size_t n = unescapeJson(views[i], &(*fields[i])[0], fields[i]->size());
+        if (n == std::string::npos)
+            return false;
+        fields[i]->resize(n);
+    }
+    p.value = v.value;
+    if (!parseTimestamp(v.timestamp, p.epoch_ns))
+        p.epoch_ns = 0;
+    p.session = v.hasSequence ? v.session : 0;
+    p.sensor_num = v.hasSequence ? v.sensorNum : 0;
+    p.seq = v.hasSequence ? v.seq : 0;
+    return true;
+}
+
+#endif // UDP_PROTOCOL_HPP
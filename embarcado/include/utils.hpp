@@ -1,16 +1,36 @@
 /**
  * @file utils.hpp
- * @brief Funções utilitárias para conversão e registro de dados.
+ * @brief Funções utilitárias para conversão de dados.
  *
  * Este arquivo define funções auxiliares usadas em diversas partes do projeto,
- * incluindo conversão de leituras analógicas (ADC) para temperatura em Celsius
- * e geração de logs simples no console.
+ * incluindo conversão de leituras analógicas (ADC) para temperatura em Celsius.
+ * O log fica em `logger.hpp`.
  */
 
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
 #include <string>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "thermistor_models.hpp"
+
+/**
+ * @struct ThermistorCalibration
+ * @brief Constantes do circuito divisor e do termistor usadas na conversão.
+ *
+ * Os valores padrão são os do KY-013 montado no kit (resistor série de 10 kΩ
+ * e ADC de 16 bits), os mesmos de `Ky013Model`. É a calibração ajustável em
+ * campo; para um modelo fixo em tempo de compilação, veja `thermistor_models.hpp`.
+ */
+struct ThermistorCalibration {
+    float seriesResistor = 10000.0f;      /**< Resistor fixo em série (Ω). */
+    float adcMaxValue = 65535.0f;         /**< Valor máximo do ADC. */
+    float steinhartA = Ky013Coefficients::A;  /**< Coeficiente A do Steinhart-Hart. */
+    float steinhartB = Ky013Coefficients::B;  /**< Coeficiente B do Steinhart-Hart. */
+    float steinhartC = Ky013Coefficients::C;  /**< Coeficiente C do Steinhart-Hart. */
+};
 
 /**
  * @brief Converte o valor bruto do ADC em temperatura (°C).
@@ -26,18 +46,109 @@
 float convertRawToCelsius(int rawValue);
 
 /**
- * @brief Exibe uma mensagem de log no console.
+ * @brief Converte o valor bruto do ADC em temperatura (°C) com calibração própria.
+ *
+ * @param rawValue Valor bruto lido do conversor ADC.
+ * @param cal Constantes do circuito e do termistor.
+ * @return Temperatura em °C, ou -273.15 se `rawValue` for inválido (≤ 0).
+ */
+float convertRawToCelsius(int rawValue, const ThermistorCalibration &cal);
+
+/**
+ * @brief Converte um valor do ADC com parte fracionária (ex: média filtrada) em °C.
+ *
+ * Mesmo cálculo da versão inteira; para valores inteiros o resultado é idêntico.
+ *
+ * @param rawValue Valor do ADC, possivelmente fracionário.
+ * @param cal Constantes do circuito e do termistor.
+ * @return Temperatura em °C, ou -273.15 se `rawValue` for inválido (≤ 0).
+ */
+float convertRawToCelsius(float rawValue, const ThermistorCalibration &cal);
+
+/**
+ * @brief Converte um bloco de leituras do ADC em temperatura (°C).
  *
- * Função simples para registrar eventos, erros ou mensagens informativas
- * durante a execução do programa.
+ * Versão em lote de `convertRawToCelsius()`, sem desvios no laço interno:
+ * o logaritmo é aproximado por polinômio e quatro amostras são processadas
+ * por vez com vetores do compilador (NEON no STM32MP1, SSE/AVX em x86).
+ * O erro máximo em relação ao cálculo em `double`, nas 65536 entradas
+ * possíveis, é medido por `batchConversionMaxError()`; com a calibração
+ * padrão fica abaixo de `BATCH_CONVERSION_MAX_ERROR` (0.001 °C, mesma
+ * ordem do erro da versão escalar em `float`) em toda a faixa útil do
+ * sensor.
  *
- * Exemplo de uso:
- * @code
- * logData("Iniciando leitura do sensor...");
- * @endcode
+ * Leituras inválidas (0, ou acima de `adcMaxValue`) resultam em -273.15.
  *
- * @param msg Mensagem de texto a ser exibida no log.
+ * @param in Leituras brutas do ADC.
+ * @param out Temperaturas convertidas (pode ter o mesmo tamanho de `in`).
+ * @param n Número de leituras.
+ * @param cal Constantes do circuito e do termistor.
  */
-void logData(const std::string &msg);
+void convertRawToCelsius(const std::uint16_t *in, float *out, std::size_t n,
+                         const ThermistorCalibration &cal);
+
+/**
+ * @brief Converte um bloco de leituras do ADC com a calibração padrão.
+ *
+ * @param in Leituras brutas do ADC.
+ * @param out Temperaturas convertidas.
+ * @param n Número de leituras.
+ */
+void convertRawToCelsius(const std::uint16_t *in, float *out, std::size_t n);
+
+/** Erro máximo aceito da conversão em lote com a calibração padrão, em °C (verificado por `bench_conversion`). */
+constexpr double BATCH_CONVERSION_MAX_ERROR = 0.001;
+
+/**
+ * @brief Mede o erro da conversão em lote em todas as 65536 entradas.
+ *
+ * Compara `convertRawToCelsius(const uint16_t*, float*, size_t, cal)` com a
+ * equação de Steinhart-Hart avaliada em `double`. Entradas em que a
+ * temperatura de referência cai fora de [-55 °C, 300 °C] (extremos sem
+ * significado físico, onde o termistor já está saturado) são ignoradas.
+ *
+ * @param cal Constantes do circuito e do termistor.
+ * @return Maior erro absoluto encontrado, em °C.
+ */
+double batchConversionMaxError(const ThermistorCalibration &cal);
+
+/**
+ * @class ConversionTable
+ * @brief Tabela de conversão ADC → °C pré-calculada para uma calibração.
+ *
+ * Como a entrada do ADC é um inteiro de 16 bits, a conversão pode ser
+ * feita por consulta a uma tabela de 65536 posições (256 KiB), calculada
+ * uma única vez em `double` e arredondada para `float`. A consulta tem,
+ * portanto, erro de no máximo meio ULP em relação à equação exata.
+ */
+class ConversionTable {
+public:
+    /**
+     * @brief Calcula a tabela para a calibração informada.
+     *
+     * @param cal Constantes do circuito e do termistor.
+     */
+    explicit ConversionTable(const ThermistorCalibration &cal = ThermistorCalibration());
+
+    /**
+     * @brief Converte uma leitura do ADC.
+     *
+     * @param raw Leitura bruta; valores negativos resultam em -273.15.
+     * @return Temperatura em °C.
+     */
+    float convert(int raw) const;
+
+    /**
+     * @brief Converte um bloco de leituras por consulta à tabela.
+     *
+     * @param in Leituras brutas do ADC.
+     * @param out Temperaturas convertidas.
+     * @param n Número de leituras.
+     */
+    void convert(const std::uint16_t *in, float *out, std::size_t n) const;
+
+private:
+    std::vector<float> table; /**< Temperatura (°C) para cada valor do ADC. */
+};
 
 #endif // UTILS_HPP
@@ -0,0 +1,150 @@
+/**
+ * @file window_aggregator.hpp
+ * @brief Agregação das leituras em janelas de tempo: envia resumos em vez de amostras.
+ *
+ * Os painéis só precisam de estatísticas por intervalo. Com agregação, o
+ * sensor pode amostrar em kHz e enviar um datagrama por janela, com
+ * contagem, mínimo, máximo, média, desvio padrão e, opcionalmente,
+ * percentis (ver `UdpSummaryPacket`).
+ *
+ * A janela é dividida em painéis de `slideS` segundos: cada painel guarda
+ * contagem, média e soma dos quadrados dos desvios (Welford), mínimo,
+ * máximo e, com percentis, um histograma de tamanho fixo. Cada amostra
+ * atualiza apenas o painel atual (O(1)); ao fechar um painel, os painéis
+ * da janela são combinados. Com `slideS` igual a `windowS` (ou 0) há um
+ * único painel: janelas fixas consecutivas (tumbling); com `slideS` menor,
+ * janelas deslizantes que se sobrepõem.
+ */
+
+#ifndef WINDOW_AGGREGATOR_HPP
+#define WINDOW_AGGREGATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Número máximo de painéis por janela (`windowS / slideS`). */
+static const std::size_t AGGREGATE_MAX_PANES = 32;
+
+/** Faixas do histograma de percentis de cada painel. */
+static const std::size_t AGGREGATE_SKETCH_BUCKETS = 256;
+
+/**
+ * @struct AggregateConfig
+ * @brief Parâmetros da agregação de um sensor.
+ *
+ * Com `windowS` em zero (padrão), cada leitura é enviada como antes.
+ */
+struct AggregateConfig {
+    double windowS = 0.0;       /**< Duração da janela, em segundos (0 = sem agregação). */
+    double slideS = 0.0;        /**< Intervalo entre resumos (0 = `windowS`, janelas fixas). */
+    bool percentiles = false;   /**< Calcula p50/p90/p99 com o histograma de cada painel. */
+    double sketchMin = -40.0;   /**< Início da faixa do histograma (valores abaixo contam na primeira faixa). */
+    double sketchMax = 125.0;   /**< Fim da faixa do histograma (valores acima contam na última faixa). */
+};
+
+/**
+ * @struct WindowSummary
+ * @brief Estatísticas de uma janela `[startNs, endNs)`.
+ */
+struct WindowSummary {
+    std::int64_t startNs = 0;   /**< Início da janela (ns desde 1970, UTC). */
+    std::int64_t endNs = 0;     /**< Fim da janela, exclusivo. */
+    std::uint32_t count = 0;    /**< Leituras na janela. */
+    double min = 0.0;           /**< Menor leitura. */
+    double max = 0.0;           /**< Maior leitura. */
+    double mean = 0.0;          /**< Média. */
+    double stddev = 0.0;        /**< Desvio padrão amostral (0 com uma leitura). */
+    double p50 = 0.0;           /**< Mediana (NaN sem percentis). */
+    double p90 = 0.0;           /**< Percentil 90 (NaN sem percentis). */
+    double p99 = 0.0;           /**< Percentil 99 (NaN sem percentis). */
+};
+
+/**
+ * @class WindowAggregator
+ * @brief Estatísticas incrementais de um sensor em janelas fixas ou deslizantes.
+ *
+ * As janelas são alinhadas a múltiplos de `slideS` desde a época Unix, de
+ * modo que sensores diferentes fecham janelas nos mesmos instantes. Uma
+ * janela é fechada pela primeira leitura posterior ao seu fim; janelas
+ * sem leituras não geram resumo.
+ *
+ * A memória é alocada no construtor; `add()` não aloca. Não é
+ * thread-safe: deve ser usada pela thread que monta os pacotes.
+ */
+class WindowAggregator {
+public:
+    /**
+     * @brief Cria o agregador; com `cfg.windowS` em zero, `enabled()` é falso.
+     *
+     * @param cfg Duração, deslocamento e percentis.
+     */
+    explicit WindowAggregator(const AggregateConfig &cfg = AggregateConfig());
+
+    /**
+     * @brief Indica se a agregação está ativa.
+     */
+    bool enabled() const { return windowNs > 0; }
+
+    /**
+     * @brief Acrescenta uma leitura; valores NaN não entram nas estatísticas.
+     *
+     * Se a leitura pertence a um painel posterior ao atual, a janela que
+     * termina no fim do painel atual é resumida antes de a leitura ser
+     * contada. Uma leitura NaN (ex: erro do ADC) apenas faz o tempo andar.
+     *
+     * @param value Valor convertido.
+     * @param epochNs Instante da leitura (ns desde 1970, UTC), não decrescente.
+     * @return `true` se uma janela foi fechada (ver `summary()`).
+     */
+    bool add(double value, std::int64_t epochNs);
+
+    /**
+     * @brief Resumo da última janela fechada.
+     */
+    const WindowSummary &summary() const { return last; }
+
+private:
+    /**
+     * @struct Pane
+     * @brief Estatísticas parciais de um intervalo de `slideS`.
+     */
+    struct Pane {
+        std::uint32_t count;    /**< Leituras. */
+        double mean;            /**< Média. */
+        double m2;              /**< Soma dos quadrados dos desvios em relação à média. */
+        double min;             /**< Menor leitura. */
+        double max;             /**< Maior leitura. */
+    };
+
+    /**
+     * @brief Resume a janela que termina em `paneEnd` em `last`.
+     *
+     * @return `false` se a janela não tiver leituras.
+     */
+    bool closeWindow();
+
+    /**
+     * @brief Torna atual o painel que contém `epochNs`, esvaziando os que ficaram para trás.
+     */
+    void advance(std::int64_t epochNs);
+
+    /**
+     * @brief Valor do quantil `q` no histograma combinado `merged`, com `n` leituras.
+     */
+    double quantile(double q, std::uint32_t n, double lo, double hi) const;
+
+    AggregateConfig config;             /**< Parâmetros. */
+    std::int64_t windowNs;              /**< Duração da janela (0 = desativado). */
+    std::int64_t paneNs;                /**< Duração de um painel. */
+    std::size_t paneCount;              /**< Painéis por janela. */
+    Pane panes[AGGREGATE_MAX_PANES];    /**< Anel de painéis; `current` é o atual. */
+    std::size_t current;                /**< Painel que recebe as leituras. */
+    std::int64_t paneEnd;               /**< Fim do painel atual (0 = nenhuma leitura ainda). */
+    std::vector<std::uint32_t> sketch;  /**< Histogramas dos painéis (`paneCount` × faixas), se houver percentis. */
+    std::vector<std::uint32_t> merged;  /**< Histograma combinado da janela, usado no fechamento. */
+    double bucketScale;                 /**< Faixas por unidade do valor. */
+    WindowSummary last;                 /**< Último resumo. */
+};
+
+#endif // WINDOW_AGGREGATOR_HPP
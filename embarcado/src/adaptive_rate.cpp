@@ -0,0 +1,93 @@
+/**
+ * @file adaptive_rate.cpp
+ * @brief Implementação da classe AdaptiveRateController.
+ */
+
+#include "../include/adaptive_rate.hpp"
+#include <algorithm>
+#include <cmath>
+
+AdaptiveRateController::AdaptiveRateController(const AdaptiveRateConfig &cfg, double initialHz)
+: config(cfg), stats(), currentHz(initialHz), primed(false), lastNs(0), level(0.0), trend(0.0),
+  residualMean(0.0), residualVar(0.0), stableSinceNs(0)
+{
+    if (!enabled())
+        return;
+    if (config.maxHz < config.minHz)
+        config.maxHz = config.minHz;
+    if (!(config.upFactor > 1.0))
+        config.upFactor = 2.0;
+    if (!(config.downFactor > 0.0 && config.downFactor < 1.0))
+        config.downFactor = 0.5;
+    if (!(config.smoothingS > 0.0))
+        config.smoothingS = 5.0;
+    currentHz = std::min(config.maxHz, std::max(config.minHz, initialHz));
+}
+
+double AdaptiveRateController::residualStddev() const {
+    return std::sqrt(residualVar);
+}
+
+/**
+ * @brief Atualiza nível, tendência e resíduos e aplica os limiares com histerese.
+ *
+ * O peso de cada leitura é `1 − exp(−dt / smoothingS)`. A tendência é a
+ * média da variação do nível suavizado por segundo; o resíduo é a
+ * distância da leitura ao nível, descontada a sua própria média (o atraso
+ * do nível numa rampa não conta como ruído).
+ */
+double AdaptiveRateController::update(double value, std::int64_t nowNs) {
+    if (!enabled() || std::isnan(value))
+        return 0.0;
+
+    if (!primed) {
+        primed = true;
+        lastNs = nowNs;
+        level = value;
+        return 0.0;
+    }
+    const double dt = static_cast<double>(nowNs - lastNs) * 1e-9;
+    if (!(dt > 0.0))
+        return 0.0;
+    lastNs = nowNs;
+
+    const double alpha = 1.0 - std::exp(-dt / config.smoothingS);
+    const double residual = value - level;
+    const double previous = level;
+    level += alpha * residual;
+    trend += alpha * ((level - previous) / dt - trend);
+    residualMean += alpha * (residual - residualMean);
+    const double deviation = residual - residualMean;
+    residualVar += alpha * (deviation * deviation - residualVar);
+
+    // Atividade: maior razão entre as estimativas e os limiares (1 = no limiar)
+    double activity = 0.0;
+    if (config.slopeThreshold > 0.0)
+        activity = std::fabs(trend) / config.slopeThreshold;
+    if (config.residualThreshold > 0.0)
+        activity = std::max(activity, std::sqrt(residualVar) / config.residualThreshold);
+
+    double next = currentHz;
+    if (activity >= 1.0) {
+        stableSinceNs = 0;
+        next = std::min(config.maxHz, currentHz * config.upFactor);
+    } else if (activity < config.hysteresis) {
+        if (stableSinceNs == 0) {
+            stableSinceNs = nowNs;
+        } else if (static_cast<double>(nowNs - stableSinceNs) >= config.holdS * 1e9) {
+            stableSinceNs = nowNs;
+            next = std::max(config.minHz, currentHz * config.downFactor);
+        }
+    } else {
+        stableSinceNs = 0; // entre os dois limiares: mantém a frequência
+    }
+
+    if (next == currentHz)
+        return 0.0;
+    if (next > currentHz)
+        ++stats.increases;
+    else
+        ++stats.decreases;
+    currentHz = next;
+    return currentHz;
+}
@@ -24,7 +24,8 @@ namespace DataFormatter {
      *
      * Constrói uma estrutura `UdpPacket` preenchendo os campos
      * com as informações do sensor e adiciona automaticamente
-     * um timestamp no formato ISO8601 (UTC).
+     * um timestamp no formato ISO8601 (UTC) e o instante
+     * correspondente em `epoch_ns`.
      *
      * Exemplo de uso:
      * @code
@@ -48,7 +49,8 @@ namespace DataFormatter {
         p.sensor_id = sensor;
         p.value = value;
         p.unit = unit;
-        p.timestamp = currentTimestamp();
+        p.epoch_ns = currentEpochNs();
+        p.timestamp = formatTimestamp(p.epoch_ns);
         return p;
     }
 }
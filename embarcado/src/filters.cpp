@@ -0,0 +1,274 @@
+/**
+ * @file filters.cpp
+ * @brief Implementação da classe FilterChain.
+ */
+
+#include "../include/filters.hpp"
+#include <algorithm>
+#include <cmath>
+
+FilterChain::FilterChain()
+: stages(), count(0), rateBase(0.0), rateOut(0.0)
+{
+}
+
+/**
+ * @brief Calcula os coeficientes de um passa-baixas Butterworth de 2ª ordem.
+ *
+ * Fórmulas do "Audio EQ Cookbook" (R. Bristow-Johnson) com Q = 1/√2,
+ * calculadas em `double` e normalizadas por a0.
+ *
+ * @return `false` se a frequência de corte não estiver em (0, taxa/2).
+ */
+static bool lowPassCoefficients(double cutoffHz, double sampleRateHz,
+                                float &b0, float &b1, float &b2, float &a1, float &a2)
+{
+    if (!(sampleRateHz > 0.0) || !(cutoffHz > 0.0) || cutoffHz >= sampleRateHz / 2.0)
+        return false;
+
+    const double pi = 3.14159265358979323846;
+    const double w0 = 2.0 * pi * cutoffHz / sampleRateHz;
+    const double cosw = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * std::sqrt(0.5));
+    const double a0 = 1.0 + alpha;
+
+    b0 = static_cast<float>((1.0 - cosw) / 2.0 / a0);
+    b1 = static_cast<float>((1.0 - cosw) / a0);
+    b2 = b0;
+    a1 = static_cast<float>(-2.0 * cosw / a0);
+    a2 = static_cast<float>((1.0 - alpha) / a0);
+    return true;
+}
+
+bool FilterChain::configure(const std::vector<FilterStage> &cfg, double sampleRateHz) {
+    count = 0;
+    rateBase = sampleRateHz;
+    rateOut = sampleRateHz;
+    if (cfg.size() > FILTER_MAX_STAGES)
+        return false;
+
+    double rate = sampleRateHz;
+    for (std::size_t i = 0; i < cfg.size(); ++i) {
+        State &s = stages[i];
+        s = State();
+        s.base = cfg[i];
+        s.cfg = cfg[i];
+
+        switch (s.cfg.type) {
+        case FilterType::Decimate:
+        case FilterType::MovingAverage:
+        case FilterType::Median:
+            if (s.cfg.length == 0 || s.cfg.length > FILTER_MAX_LENGTH)
+                return false;
+            if (s.cfg.type == FilterType::Decimate)
+                rate /= s.cfg.length;
+            break;
+        case FilterType::Ema:
+            if (!(s.cfg.alpha > 0.0f) || s.cfg.alpha > 1.0f)
+                return false;
+            break;
+        case FilterType::LowPass:
+            if (!lowPassCoefficients(s.cfg.cutoffHz, rate, s.b0, s.b1, s.b2, s.a1, s.a2))
+                return false;
+            break;
+        }
+    }
+
+    count = cfg.size();
+    rateOut = rate;
+    return true;
+}
+
+bool FilterChain::setSampleRate(double sampleRateHz) {
+    if (!(sampleRateHz > 0.0))
+        return false;
+    if (count == 0) {
+        rateOut = sampleRateHz;
+        return true;
+    }
+
+    const double ratio = sampleRateHz / rateBase;
+    double rate = sampleRateHz;
+    for (std::size_t i = 0; i < count; ++i) {
+        State &s = stages[i];
+        switch (s.cfg.type) {
+        case FilterType::Decimate:
+            rate /= s.cfg.length;
+            break;
+        case FilterType::MovingAverage:
+        case FilterType::Median: {
+            const double len = std::round(s.base.length * ratio);
+            const unsigned n = len < 1.0 ? 1u : len > FILTER_MAX_LENGTH ? FILTER_MAX_LENGTH
+                                                                        : static_cast<unsigned>(len);
+            if (n != s.cfg.length)
+                resizeWindow(s, n);
+            break;
+        }
+        case FilterType::Ema:
+            // (1 - alpha) por amostra elevado ao número de amostras no mesmo intervalo
+            s.cfg.alpha = static_cast<float>(1.0 - std::pow(1.0 - s.base.alpha, 1.0 / ratio));
+            break;
+        case FilterType::LowPass:
+            if (!lowPassCoefficients(s.base.cutoffHz, rate, s.b0, s.b1, s.b2, s.a1, s.a2)) {
+                // Corte acima de metade da taxa: não há o que atenuar
+                s.b0 = 1.0f;
+                s.b1 = s.b2 = s.a1 = s.a2 = 0.0f;
+            }
+            break;
+        }
+    }
+    rateOut = rate;
+    return true;
+}
+
+void FilterChain::resizeWindow(State &s, unsigned length) {
+    const unsigned old = s.cfg.length;
+    const unsigned keep = s.count < length ? s.count : length;
+    float recent[FILTER_MAX_LENGTH];
+    // A amostra mais recente está em pos - 1; `recent` fica da mais antiga para a mais nova
+    for (unsigned j = 0; j < keep; ++j)
+        recent[j] = s.window[(s.pos + old - keep + j) % old];
+
+    double sum = 0.0;
+    for (unsigned j = 0; j < keep; ++j) {
+        s.window[j] = recent[j];
+        sum += recent[j];
+    }
+    s.cfg.length = length;
+    s.count = keep;
+    s.pos = keep == length ? 0 : keep;
+    s.sum = sum;
+}
+
+void FilterChain::reset() {
+    for (std::size_t i = 0; i < count; ++i) {
+        State &s = stages[i];
+        s.count = 0;
+        s.pos = 0;
+        s.sum = 0.0;
+    }
+}
+
+bool FilterChain::step(State &s, float in, float &out) {
+    const unsigned len = s.cfg.length;
+
+    switch (s.cfg.type) {
+    case FilterType::Decimate:
+        s.sum += in;
+        if (++s.count < len)
+            return false;
+        out = static_cast<float>(s.sum / len);
+        s.sum = 0.0;
+        s.count = 0;
+        return true;
+
+    case FilterType::MovingAverage:
+        if (s.count == len)
+            s.sum -= s.window[s.pos];
+        else
+            ++s.count;
+        s.window[s.pos] = in;
+        s.sum += in;
+        s.pos = (s.pos + 1 == len) ? 0 : s.pos + 1;
+        out = static_cast<float>(s.sum / s.count);
+        return true;
+
+    case FilterType::Median: {
+        if (s.count < len)
+            ++s.count;
+        s.window[s.pos] = in;
+        s.pos = (s.pos + 1 == len) ? 0 : s.pos + 1;
+
+        float sorted[FILTER_MAX_LENGTH];
+        std::copy(s.window, s.window + s.count, sorted);
+        const unsigned mid = s.count / 2;
+        std::nth_element(sorted, sorted + mid, sorted + s.count);
+        out = sorted[mid];
+        if (s.count % 2 == 0)
+            out = (out + *std::max_element(sorted, sorted + mid)) / 2.0f;
+        return true;
+    }
+
+    case FilterType::Ema:
+        if (s.count == 0) {
+            s.y1 = in;
+            s.count = 1;
+        } else {
+            s.y1 += s.cfg.alpha * (in - s.y1);
+        }
+        out = s.y1;
+        return true;
+
+    case FilterType::LowPass: {
+        // Parte do primeiro valor em regime, sem o transitório a partir de zero
+        if (s.count == 0) {
+            s.x1 = s.x2 = s.y1 = s.y2 = in;
+            s.count = 1;
+        }
+        float y = s.b0 * in + s.b1 * s.x1 + s.b2 * s.x2 - s.a1 * s.y1 - s.a2 * s.y2;
+        s.x2 = s.x1;
+        s.x1 = in;
+        s.y2 = s.y1;
+        s.y1 = y;
+        out = y;
+        return true;
+    }
+    }
+
+    return false;
+}
+
+bool FilterChain::process(float in, float &out) {
+    float v = in;
+    for (std::size_t i = 0; i < count; ++i)
+        if (!step(stages[i], v, v))
+            return false;
+    out = v;
+    return true;
+}
+
+std::size_t FilterChain::processBlock(const float *in, float *out, std::size_t n) {
+    if (out != in)
+        std::copy(in, in + n, out);
+
+    for (std::size_t k = 0; k < count; ++k) {
+        State &s = stages[k];
+        std::size_t m = 0;
+        std::size_t i = 0;
+
+        // Decimação alinhada: soma grupos inteiros direto do bloco
+        if (s.cfg.type == FilterType::Decimate && s.count == 0) {
+            const unsigned len = s.cfg.length;
+            for (; i + len <= n; i += len) {
+                double sum = 0.0;
+                for (unsigned j = 0; j < len; ++j)
+                    sum += out[i + j];
+                out[m++] = static_cast<float>(sum / len);
+            }
+        }
+
+        // A saída nunca passa da entrada (m <= i), então o bloco é reescrito no lugar
+        for (; i < n; ++i) {
+            float v;
+            if (step(s, out[i], v))
+                out[m++] = v;
+        }
+        n = m;
+    }
+
+    return n;
+}
+
+std::size_t FilterChain::processBlock(const std::uint16_t *in, float *out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = in[i];
+    return processBlock(out, out, n);
+}
+
+std::size_t FilterChain::size() const {
+    return count;
+}
+
+double FilterChain::outputRate() const {
+    return rateOut;
+}
@@ -0,0 +1,253 @@
+/**
+ * @file logger.cpp
+ * @brief Filas por thread e thread de fundo do log assíncrono.
+ */
+
+#include "../include/logger.hpp"
+#include "../include/spsc_ring.hpp"
+#include "../include/udp_protocol.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @struct LogState
+ * @brief Filas registradas e thread de fundo.
+ *
+ * As filas nunca são removidas: a de uma thread que terminou continua
+ * sendo esvaziada. O destrutor (ao encerrar o programa) para a thread de
+ * fundo e escreve o que ainda estiver pendente.
+ */
+struct LogState {
+    std::mutex lock;                                          /**< Protege os campos abaixo. */
+    std::condition_variable wake;                             /**< Acorda a thread de fundo antes do intervalo. */
+    std::vector<std::unique_ptr<SpscRing<LogRecord>>> rings;  /**< Fila de cada thread. */
+    std::thread worker;                                       /**< Thread de fundo. */
+    bool stopping = false;                                    /**< Pedido de encerramento. */
+    std::FILE *output = nullptr;                              /**< Destino único (`nullptr` = stdout/stderr). */
+    std::uint64_t flushRequests = 0;                          /**< Pedidos de `flushLog()`. */
+    std::uint64_t flushesDone = 0;                            /**< Pedidos atendidos. */
+    std::uint64_t reportedDrops = 0;                          /**< Descartes já avisados. */
+    std::vector<LogRecord> batch;                             /**< Mensagens de uma escrita (só na thread de fundo). */
+
+    ~LogState() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (worker.joinable())
+            worker.join();
+    }
+
+    void run();
+    void drain();
+};
+
+LogState &state() {
+    static LogState s;
+    return s;
+}
+
+const char *levelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:   return "DEBUG";
+    case LogLevel::Info:    return "INFO";
+    case LogLevel::Warning: return "AVISO";
+    case LogLevel::Error:   return "ERRO";
+    }
+    return "?";
+}
+
+/**
+ * @brief Copia `s` para `buf + pos`, sem passar de `cap`.
+ */
+std::size_t put(char *buf, std::size_t pos, std::size_t cap, const char *s, std::size_t n) {
+    if (pos >= cap)
+        return pos;
+    n = std::min(n, cap - pos);
+    std::memcpy(buf + pos, s, n);
+    return pos + n;
+}
+
+std::size_t putArg(const LogRecord &r, std::size_t i, char *buf, std::size_t pos, std::size_t cap) {
+    char num[32];
+    std::to_chars_result res{num, std::errc()};
+    switch (r.types[i]) {
+    case LogArgType::Int:
+        res = std::to_chars(num, num + sizeof(num), static_cast<std::int64_t>(r.values[i]));
+        break;
+    case LogArgType::Uint:
+        res = std::to_chars(num, num + sizeof(num), r.values[i]);
+        break;
+    case LogArgType::Double: {
+        double d;
+        std::memcpy(&d, &r.values[i], sizeof(d));
+        res = std::to_chars(num, num + sizeof(num), d);
+        break;
+    }
+    case LogArgType::Text:
+        return put(buf, pos, cap, r.text + (r.values[i] & 0xffffffffu), static_cast<std::size_t>(r.values[i] >> 32));
+    }
+    return put(buf, pos, cap, num, static_cast<std::size_t>(res.ptr - num));
+}
+
+void LogState::run() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (!stopping) {
+        wake.wait_for(guard, std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS));
+        const std::uint64_t requests = flushRequests;
+        guard.unlock();
+        drain();
+        guard.lock();
+        flushesDone = requests;
+        wake.notify_all();
+    }
+    guard.unlock();
+    drain();
+}
+
+/**
+ * @brief Esvazia as filas, ordena as mensagens pelo instante e as escreve.
+ *
+ * Só a thread de fundo chama: é a única consumidora das filas.
+ */
+void LogState::drain() {
+    std::vector<SpscRing<LogRecord> *> snapshot;
+    std::FILE *out;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto &ring : rings)
+            snapshot.push_back(ring.get());
+        out = output;
+    }
+
+    batch.clear();
+    std::uint64_t drops = 0;
+    LogRecord chunk[16];
+    for (SpscRing<LogRecord> *ring : snapshot) {
+        std::size_t n;
+        while ((n = ring->popBulk(chunk, sizeof(chunk) / sizeof(chunk[0]))) > 0)
+            batch.insert(batch.end(), chunk, chunk + n);
+        drops += ring->droppedCount();
+    }
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const LogRecord &a, const LogRecord &b) { return a.epochNs < b.epochNs; });
+
+    // Ao trocar de stdout para stderr (e vice-versa), esvazia o anterior: no
+    // mesmo terminal, as linhas saem inteiras e na ordem
+    char line[1024];
+    std::FILE *last = nullptr;
+    for (const LogRecord &r : batch) {
+        std::FILE *dest = out ? out : (r.level >= LogLevel::Warning ? stderr : stdout);
+        if (last && dest != last)
+            std::fflush(last);
+        last = dest;
+        std::fwrite(line, 1, formatLogRecord(r, line, sizeof(line)), dest);
+    }
+    if (last && last != stderr)
+        std::fflush(last);
+    if (drops > reportedDrops) {
+        LogRecord r;
+        r.epochNs = logNowNs();
+        r.format = "log: {} mensagens descartadas (fila cheia)";
+        r.suppressed = 0;
+        r.textLen = 0;
+        r.level = LogLevel::Warning;
+        r.argc = 0;
+        r.append(drops - reportedDrops);
+        std::fwrite(line, 1, formatLogRecord(r, line, sizeof(line)), out ? out : stderr);
+        reportedDrops = drops;
+    }
+    std::fflush(out ? out : stderr);
+}
+
+/**
+ * @brief Fila da thread atual, criada e registrada no primeiro uso.
+ */
+SpscRing<LogRecord> &threadRing() {
+    static thread_local SpscRing<LogRecord> *ring = nullptr;
+    if (!ring) {
+        LogState &s = state();
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.rings.push_back(std::make_unique<SpscRing<LogRecord>>(LOG_RING_RECORDS, OverflowPolicy::DropNewest));
+        ring = s.rings.back().get();
+        if (!s.worker.joinable())
+            s.worker = std::thread([&s] { s.run(); });
+    }
+    return *ring;
+}
+
+} // namespace
+
+bool logSubmit(const LogRecord &r) {
+    return threadRing().push(r);
+}
+
+/**
+ * @brief Formata a linha: instante, nível e o formato com os argumentos no lugar de cada `{}`.
+ *
+ * `{}` sem argumento correspondente fica como está.
+ */
+std::size_t formatLogRecord(const LogRecord &r, char *buf, std::size_t cap) {
+    if (cap == 0)
+        return 0;
+    const std::size_t end = cap - 1; // reserva o '\n'
+    std::size_t pos = formatTimestampInto(r.epochNs, TimestampPrecision::Milliseconds, buf, end);
+    pos = put(buf, pos, end, " [", 2);
+    const char *name = levelName(r.level);
+    pos = put(buf, pos, end, name, std::strlen(name));
+    pos = put(buf, pos, end, "] ", 2);
+
+    std::size_t arg = 0;
+    for (const char *f = r.format; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}' && arg < r.argc) {
+            pos = putArg(r, arg++, buf, pos, end);
+            ++f;
+        } else {
+            pos = put(buf, pos, end, f, 1);
+        }
+    }
+
+    if (r.suppressed) {
+        char num[16];
+        const char *numEnd = std::to_chars(num, num + sizeof(num), r.suppressed).ptr;
+        pos = put(buf, pos, end, " (+", 3);
+        pos = put(buf, pos, end, num, static_cast<std::size_t>(numEnd - num));
+        pos = put(buf, pos, end, " suprimidas)", 12);
+    }
+    buf[pos++] = '\n';
+    return pos;
+}
+
+std::uint64_t logDroppedCount() {
+    LogState &s = state();
+    std::lock_guard<std::mutex> guard(s.lock);
+    std::uint64_t total = 0;
+    for (auto &ring : s.rings)
+        total += ring->droppedCount();
+    return total;
+}
+
+void setLogOutput(std::FILE *out) {
+    LogState &s = state();
+    std::lock_guard<std::mutex> guard(s.lock);
+    s.output = out;
+}
+
+void flushLog() {
+    LogState &s = state();
+    std::unique_lock<std::mutex> guard(s.lock);
+    if (!s.worker.joinable())
+        return;
+    const std::uint64_t request = ++s.flushRequests;
+    s.wake.notify_all();
+    s.wake.wait(guard, [&s, request] { return s.flushesDone >= request || s.stopping; });
+}
@@ -5,71 +5,560 @@
  * Este módulo inicializa a comunicação UDP, realiza leituras periódicas de temperatura
  * e envia as informações formatadas em JSON para um servidor remoto.
  *
- * O ciclo principal executa continuamente:
- *  - Lê a temperatura do sensor (via função `getTemperature()`).
- *  - Monta um pacote `UdpPacket` com metadados e timestamp.
- *  - Serializa o pacote em JSON.
- *  - Envia o JSON via `UDPClient` a cada 1 segundo.
+ * A aquisição e a rede rodam em threads separadas, ligadas por uma
+ * `SpscRing<RawSample>`:
+ *  - Thread de aquisição: cada sensor do registro (via `getSensorRegistry()`)
+ *    é uma tarefa do `Scheduler`, executada na sua própria frequência
+ *    (`SensorConfig::sampleRateHz`), que lê e filtra o canal
+ *    (`SensorConfig::filters`) e enfileira `{sensor, valor bruto, instante}`.
+ *    Com `SensorConfig::adaptiveRate`, um `AdaptiveRateController` por
+ *    sensor ajusta essa frequência conforme a dinâmica do sinal (só então
+ *    a aquisição converte o valor, que segue na fila).
+ *  - Thread de rede (principal): esvazia a fila, converte o valor (uma vez
+ *    por amostra), publica-o em memória compartilhada (`ShmPublisher`,
+ *    com `SHARED_MEMORY_READINGS`) para outros processos da placa, decide
+ *    se ele precisa ser enviado (`ReportPolicy`, ver `SensorConfig::report`),
+ *    monta o `UdpPacket`, serializa em JSON e envia via `UDPClient`. Sensores
+ *    com agregação (`SensorConfig::aggregate`) não enviam leituras: cada
+ *    janela fechada gera um `UdpSummaryPacket`. Se o
+ *    envio falhar, o datagrama vai para o `Spool` na flash e é reenviado,
+ *    em ritmo limitado, quando a rede voltar.
+ *
+ * Assim, um envio lento não atrasa a leitura seguinte; se a rede não
+ * acompanhar, a fila descarta conforme `RING_POLICY`.
+ *
+ * O servidor principal é `SERVER_ADDRESS`:`SERVER_PORT`, ou o dado em
+ * `UDP_SERVER` (`endereço:porta[,binary]`, ex: `UDP_SERVER=127.0.0.1:6000`).
+ * Além dele, a variável de ambiente `UDP_DESTINATIONS`
+ * acrescenta destinos (unicast ou multicast, ver `parseDestination()`),
+ * separados por `;`; cada leitura é serializada uma vez e entregue a todos
+ * por `UDPClient::sendToAll()`:
+ * @code
+ * UDP_DESTINATIONS="239.1.2.3:6000,binary,ttl=4;[fd00::2]:5000,div=10" ./sensor
+ * @endcode
+ *
+ * Com `SEQUENCE_NUMBERS` (ou `SENSOR_SEQUENCE=1` no ambiente), cada pacote
+ * leva a sessão deste início do programa e um número de sequência por
+ * sensor; o coletor conta as perdas e pode pedir as lacunas de volta com um
+ * NACK (`sequence.hpp`), atendido com as cópias guardadas na
+ * `RetransmitWindow`.
+ *
+ * As duas threads registram a latência de cada etapa e os erros em
+ * `threadMetrics()`; a cada `METRICS_INTERVAL_S` as métricas são enviadas
+ * em um datagrama JSON para `METRICS_PORT`, e `kill -USR1` as mostra no
+ * console.
+ *
+ * As mensagens vão pelo log assíncrono (`logger.hpp`): o laço de envio só
+ * enfileira registros, e a escrita no console fica com a thread de fundo.
+ * Cada pacote enviado é mostrado no nível debug (`-DLOG_MIN_LEVEL=0`).
  */
 
 #include "../include/utils.hpp"
+#include "../include/logger.hpp"
 #include "../include/udp_client.hpp"
 #include "../include/udp_protocol.hpp"
+#include "../include/sensor_registry.hpp"
+#include "../include/packet_batcher.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/spsc_ring.hpp"
+#include "../include/report_policy.hpp"
+#include "../include/spool.hpp"
+#include "../include/metrics.hpp"
+#include "../include/binary_protocol.hpp"
+#include "../include/window_aggregator.hpp"
+#include "../include/adaptive_rate.hpp"
+#include "../include/retransmit_window.hpp"
+#include "../include/sequence.hpp"
+#include "../include/shm_publisher.hpp"
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <string_view>
 #include <thread>
+#include <vector>
+#include <time.h>
 
 
 /**
- * @brief Função externa que lê a temperatura do sensor embarcado.
+ * @brief Função externa que fornece o registro de sensores da placa.
  *
- * Esta função é implementada em outro módulo (`main_embarcado.cpp`)
- * e fornece o valor da temperatura em graus Celsius.
+ * Esta função é implementada em outro módulo (`main_embarcado.cpp`).
  *
- * @return Temperatura medida em °C.
+ * @return Registro com os canais de ADC configurados.
+ */
+extern SensorRegistry &getSensorRegistry();
+
+/**
+ * Agrupa as leituras em datagramas de até 1400 bytes (ver `PacketBatcher`)
+ * em vez de enviar um datagrama por leitura.
+ */
+static const bool BATCH_READINGS = false;
+
+/** Intervalo, em segundos, entre relatórios de pontualidade do agendador. */
+static const double STATS_INTERVAL_S = 60.0;
+
+/** Capacidade da fila entre aquisição e rede, em amostras. */
+static const std::size_t RING_CAPACITY = 4096;
+
+/** Com a fila cheia, descarta a amostra mais antiga (a mais recente é a mais útil). */
+static const OverflowPolicy RING_POLICY = OverflowPolicy::DropOldest;
+
+/**
+ * Resolução do `ts` enviado. O instante é o da leitura (capturado na thread
+ * de aquisição), não o do envio; acima de 1 Hz os segundos não bastam.
  */
-extern float getTemperature();
+static const TimestampPrecision TIMESTAMP_PRECISION = TimestampPrecision::Milliseconds;
+
+/** Servidor principal (recebe os pacotes e envia os NACKs); `UDP_SERVER` no ambiente o troca. */
+static const char *SERVER_ADDRESS = " 192.168.42.10";
+
+/** Porta UDP do servidor principal. */
+static const int SERVER_PORT = 5000;
+
+/** Porta UDP do datagrama de métricas (no mesmo servidor dos pacotes). */
+static const int METRICS_PORT = 5001;
+
+/** Intervalo, em segundos, entre datagramas de métricas. */
+static const double METRICS_INTERVAL_S = 10.0;
+
+/** Espera da thread de rede quando a fila está vazia, em ns. */
+static const long IDLE_WAIT_NS = 1000000;
+
+/**
+ * Numera os pacotes (sessão e sequência por sensor), para a contagem de
+ * perdas no coletor. Desligado por padrão: cada registro binário passa de
+ * 14 para 22 bytes (`BINARY_SEQUENCE_SIZE`), cada JSON ganha ~45 bytes e
+ * cada envio, uma cópia para a `RetransmitWindow`. `SENSOR_SEQUENCE=1` no
+ * ambiente liga sem recompilar.
+ */
+static const bool SEQUENCE_NUMBERS = false;
+
+/** Datagramas guardados por sensor para atender NACKs (0 = não guarda). */
+static const std::size_t RETRANSMIT_SLOTS = 256;
+
+/** Intervalo, em ns, entre as verificações de NACKs do servidor. */
+static const std::int64_t NACK_POLL_INTERVAL_NS = 10000000;
+
+/** NACKs atendidos por verificação (limita o tempo tirado dos envios novos). */
+static const int NACKS_PER_POLL = 8;
+
+/** Números procurados na janela por verificação, somando todos os NACKs (idem). */
+static const std::uint32_t NACK_LOOKUPS_PER_POLL = 64;
+
+/** Publica a última leitura de cada sensor em memória compartilhada (ver `shm_readings.hpp`). */
+static const bool SHARED_MEMORY_READINGS = true;
+
+/**
+ * @brief Preenche o resumo de uma janela com os dados do sensor e as estatísticas.
+ *
+ * @param out Pacote reutilizado entre janelas.
+ * @param sensor Sensor da janela.
+ * @param w Estatísticas da janela.
+ */
+static void fillSummary(UdpSummaryPacket &out, Sensor &sensor, const WindowSummary &w) {
+    char tsBuf[32];
+    out.group_id   = sensor.getGroupId();
+    out.sensor_id  = sensor.getSensorId();
+    out.sensor_num = sensor.getSensorNum();
+    out.unit       = sensor.getUnit();
+    out.value      = w.mean;
+    out.epoch_ns   = w.endNs;
+    out.timestamp.assign(tsBuf, formatTimestampInto(w.endNs, TIMESTAMP_PRECISION, tsBuf, sizeof(tsBuf)));
+    out.window_start_ns = w.startNs;
+    out.window_start.assign(tsBuf, formatTimestampInto(w.startNs, TIMESTAMP_PRECISION, tsBuf, sizeof(tsBuf)));
+    out.count  = w.count;
+    out.min    = w.min;
+    out.max    = w.max;
+    out.stddev = w.stddev;
+    out.p50    = w.p50;
+    out.p90    = w.p90;
+    out.p99    = w.p99;
+}
+
+/**
+ * @brief Atende os NACKs recebidos do servidor com as cópias da janela de retransmissão.
+ *
+ * NACKs de outra sessão (de antes de um reinício) são ignorados. As faixas
+ * são cortadas aos números ainda na janela, e no máximo
+ * `NACK_LOOKUPS_PER_POLL` números são procurados por chamada; o restante
+ * do NACK é descartado (o receptor volta a pedir o que faltar). Assim, um
+ * NACK malformado ou hostil não segura a thread de rede.
+ *
+ * @param client Cliente conectado ao servidor.
+ * @param window Datagramas guardados.
+ * @param session Sessão deste início do programa.
+ * @param metrics Métricas da thread de rede.
+ */
+static void serveNacks(UDPClient &client, RetransmitWindow &window, std::uint32_t session, ThreadMetrics &metrics) {
+    std::uint8_t buf[NACK_MAX_SIZE];
+    NackView nack;
+    std::uint32_t budget = NACK_LOOKUPS_PER_POLL;
+    for (int i = 0; i < NACKS_PER_POLL && budget > 0; ++i) {
+        long n = client.receiveData(buf, sizeof(buf));
+        if (n < 0)
+            return;
+        if (!nack.parse(buf, static_cast<std::size_t>(n)) || nack.session() != session)
+            continue;
+
+        for (std::size_t r = 0; r < nack.rangeCount() && budget > 0; ++r) {
+            const NackRange range = nack.range(r);
+            std::uint32_t first = range.first, count = range.count;
+            metrics.add(MetricCounter::RetransmitMisses, window.clampRange(nack.sensorNum(), first, count));
+            if (count > budget)
+                count = budget;
+            budget -= count;
+            for (std::uint32_t k = 0; k < count; ++k) {
+                std::size_t len;
+                const char *data = window.find(nack.sensorNum(), first + k, len);
+                if (!data) {
+                    metrics.add(MetricCounter::RetransmitMisses);
+                } else if (client.sendData(data, len)) {
+                    window.markResent();
+                    metrics.add(MetricCounter::Retransmits);
+                }
+            }
+        }
+    }
+}
 
 /**
  * @brief Função principal da aplicação.
  *
- * Inicializa o cliente UDP e executa um loop contínuo que:
- * 1. Lê a temperatura do sensor.
- * 2. Cria um pacote `UdpPacket` com as informações do sensor.
- * 3. Serializa o pacote em JSON.
- * 4. Envia os dados ao servidor via UDP.
+ * Inicializa o cliente UDP, registra no agendador uma tarefa de leitura por
+ * sensor e inicia a thread de aquisição. A thread principal então:
+ * 1. Retira as amostras da fila.
+ * 2. Converte o valor bruto com a calibração do sensor.
+ * 3. Descarta leituras dentro da banda morta do sensor (envio por exceção)
+ *    ou, com agregação, acumula a leitura na janela do sensor.
+ * 4. Cria um pacote `UdpPacket` com as informações do sensor.
+ * 5. Serializa o pacote em JSON e o envia ao servidor via UDP.
  *
- * Em caso de falha no envio, é exibida uma mensagem de erro no console.
- * O envio é repetido a cada 1 segundo.
+ * Em caso de falha no envio por erro de enlace (`isLinkError()`), o
+ * datagrama é guardado no spool e o enlace é marcado como fora do ar: as
+ * leituras seguintes vão direto para o spool até que um reenvio tenha
+ * sucesso. Com o buffer do socket cheio (EAGAIN), o datagrama é apenas
+ * descartado e contado em `send_drops`. Os prazos de leitura são absolutos: o tempo gasto no envio não os afeta.
  *
  * @return Código de status do programa (0 = sucesso).
  */
 int main() {
-    logData("Iniciando comunicação UDP...");
-    UDPClient client(" 192.168.42.10", 5000); /**< Cliente UDP para envio de pacotes. */
+    LOG_INFO("Iniciando comunicação UDP...");
+    UdpDestination server;
+    server.address = SERVER_ADDRESS;
+    server.port = SERVER_PORT;
+    if (const char *spec = std::getenv("UDP_SERVER")) {
+        UdpDestination parsed;
+        if (parseDestination(spec, parsed))
+            server = parsed;
+        else
+            LOG_WARN("UDP_SERVER ignorado: {}", spec);
+    }
+    UDPClient client(server.address, server.port, server.encoding); /**< Cliente UDP para envio de pacotes. */
+    client.setNonBlocking(true); // um buffer de socket cheio descarta o pacote em vez de atrasar o envio dos demais
+    if (const char *extra = std::getenv("UDP_DESTINATIONS")) {
+        std::istringstream specs(extra);
+        std::string spec;
+        while (std::getline(specs, spec, ';')) {
+            UdpDestination dest;
+            if (!spec.empty() && (!parseDestination(spec, dest) || client.addDestination(dest) < 0))
+                LOG_WARN("destino ignorado: {}", spec);
+        }
+    }
+    UDPClient metricsClient(server.address, METRICS_PORT); /**< Destino do datagrama de métricas. */
+    metricsClient.setNonBlocking(true);
+    installMetricsSignal();
+
+    SensorRegistry &registry = getSensorRegistry();
+    SpscRing<RawSample> ring(RING_CAPACITY, RING_POLICY);
+    Scheduler scheduler; /**< Agendador da thread de aquisição. */
+
+    ShmPublisher publisher; /**< Últimas leituras para outros processos (usado só na thread de rede). */
+    if (SHARED_MEMORY_READINGS) {
+        if (publisher.open(ShmConfig(), registry.size())) {
+            for (std::size_t i = 0; i < registry.size(); ++i)
+                publisher.describe(i, registry.at(i).getSensorId(), registry.at(i).getUnit(),
+                                   registry.at(i).getSensorNum());
+        } else {
+            LOG_WARN("memória compartilhada indisponível; leituras só por UDP");
+        }
+    }
 
-    while (true) {
-        float valor = getTemperature();
+    std::vector<int> sensorTasks; /**< Tarefa do agendador de cada sensor (-1 = inválida). */
+    std::vector<AdaptiveRateController> rateControllers; /**< Frequência de cada sensor (usados só na aquisição). */
+    for (std::size_t i = 0; i < registry.size(); ++i)
+        rateControllers.emplace_back(registry.at(i).getAdaptiveRateConfig(), registry.at(i).getSampleRate());
+    for (std::size_t i = 0; i < registry.size(); ++i) {
+        const double rateHz = rateControllers[i].enabled() ? rateControllers[i].rate() : registry.at(i).getSampleRate();
+        sensorTasks.push_back(scheduler.addTask(rateHz, [&registry, &ring, &scheduler, &rateControllers, &sensorTasks, i] {
+            ThreadMetrics &metrics = threadMetrics();
+            metrics.record(MetricStage::LoopJitter, scheduler.currentLatenessNs());
 
-        // Monta o pacote JSON
-        UdpPacket pkt;
-        pkt.group_id  = "grupo6";
-        pkt.sensor_id = "SensorDeTemperatura";
-        pkt.value     = valor;
-        pkt.unit      = "°C";
-        pkt.timestamp = currentTimestamp();
+            RawSample s;
+            s.sensorIndex = static_cast<std::uint32_t>(i);
+            const std::int64_t t0 = metricsNowNs();
+            const bool ready = registry.at(i).readFiltered(s.raw);
+            const std::int64_t t1 = metricsNowNs();
+            metrics.record(MetricStage::AdcRead, t1 - t0);
+            if (s.raw < 0.0f)
+                metrics.add(MetricCounter::ReadErrors);
+            metrics.publishIfDue(t1);
+            if (!ready)
+                return; // decimação ainda acumulando: nada a enviar neste ciclo
+            s.epochNs = currentEpochNs();
+
+            // Sem frequência adaptativa, a conversão fica com a thread de rede
+            AdaptiveRateController &rate = rateControllers[i];
+            if (!rate.enabled()) {
+                s.value = std::nanf("");
+                ring.push(s);
+                return;
+            }
+            s.value = registry.at(i).convert(s.raw);
+            ring.push(s);
+
+            // Frequência adaptativa: vale a partir do próximo prazo desta tarefa
+            if (s.raw >= 0.0f) {
+                const double oldHz = rate.rate();
+                const double newHz = rate.update(s.value, t1);
+                if (newHz > 0.0 && scheduler.setRate(sensorTasks[i], newHz)) {
+                    registry.at(i).setSampleRate(newHz); // filtros com a mesma duração na nova frequência
+                    metrics.add(newHz > oldHz ? MetricCounter::RateIncreases : MetricCounter::RateDecreases);
+                }
+            }
+        }));
+        if (sensorTasks.back() < 0)
+            LOG_ERROR("frequência inválida para {}", registry.at(i).getSensorId());
+    }
+
+    // Relatório periódico de prazos perdidos, atraso de cada sensor e descartes da fila
+    scheduler.addTask(1.0 / STATS_INTERVAL_S, [&] {
+        for (std::size_t i = 0; i < sensorTasks.size(); ++i) {
+            if (sensorTasks[i] < 0)
+                continue;
+            const TaskStats &st = scheduler.getStats(sensorTasks[i]);
+            const long long jitterMeanUs = static_cast<long long>(st.jitterMeanNs() / 1000);
+            AdaptiveRateController &rate = rateControllers[i];
+            if (rate.enabled()) {
+                LOG_INFO("{}: {} leituras, {} prazos perdidos, atraso min/média/max {}/{}/{} us, {} Hz "
+                         "({} aumentos, {} reduções)",
+                         registry.at(i).getSensorId(), st.runs, st.missed, st.jitterMinNs / 1000, jitterMeanUs,
+                         st.jitterMaxNs / 1000, scheduler.getRate(sensorTasks[i]), rate.getStats().increases,
+                         rate.getStats().decreases);
+                rate.resetStats();
+            } else {
+                LOG_INFO("{}: {} leituras, {} prazos perdidos, atraso min/média/max {}/{}/{} us",
+                         registry.at(i).getSensorId(), st.runs, st.missed, st.jitterMinNs / 1000, jitterMeanUs,
+                         st.jitterMaxNs / 1000);
+            }
+        }
+        scheduler.resetStats();
+
+        LOG_INFO("Fila: {} amostras, {} descartadas, ocupação {}/{}",
+                 ring.pushedCount(), ring.droppedCount(), ring.size(), ring.capacity());
+    });
+
+    std::thread acquisition([&scheduler] { scheduler.run(); });
+
+    // Thread de rede: tudo abaixo roda apenas aqui (cliente, lote, buffers)
+    char jsonBuf[512];
+    char tsBuf[32];
+    std::uint8_t binBuf[BINARY_MAX_RECORD_SIZE];
+    const bool binaryPrimary = client.getEncoding() == WireEncoding::Binary; /**< O servidor principal recebe registros binários. */
+    UdpPacket pkt; /**< Reutilizado a cada leitura, para não realocar as strings. */
+    UdpSummaryPacket summary; /**< Reutilizado a cada janela fechada. */
+    PacketBatcher batcher(client); /**< Usado apenas com `BATCH_READINGS`. */
+    RawSample samples[64];
+
+    // O início do JSON ("group" e "sensor_id") não muda: calcula uma vez por sensor
+    std::vector<std::string> prefixes;
+    std::vector<ReportPolicy> policies; /**< Envio por exceção de cada sensor. */
+    std::vector<WindowAggregator> aggregators; /**< Janelas de cada sensor (inativas sem `aggregate.windowS`). */
+    std::vector<std::uint32_t> sequences(registry.size(), 0); /**< Próximo número de sequência de cada sensor. */
+    for (std::size_t i = 0; i < registry.size(); ++i) {
+        prefixes.push_back(jsonPrefix(registry.at(i).getGroupId(), registry.at(i).getSensorId()));
+        policies.emplace_back(registry.at(i).getReportConfig());
+        aggregators.emplace_back(registry.at(i).getAggregateConfig());
+    }
+    std::int64_t nextReportNs = Scheduler::nowNs() + static_cast<std::int64_t>(STATS_INTERVAL_S * 1e9);
 
-        std::string jsonData = serialize(pkt);
+    Spool spool; /**< Datagramas que não puderam ser enviados. */
+    if (!spool.open(SpoolConfig()))
+        LOG_WARN("spool indisponível; leituras não enviadas serão perdidas");
+    bool linkUp = true; /**< Falso após uma falha de envio, até um reenvio bem-sucedido. */
 
-        // Envia o JSON pelo UDP
-        if (client.sendData(jsonData)) {
-            std::cout << "Enviado: " << jsonData << std::endl;
+    const char *sequenceEnv = std::getenv("SENSOR_SEQUENCE");
+    const bool numbered = sequenceEnv ? std::strcmp(sequenceEnv, "0") != 0 : SEQUENCE_NUMBERS;
+    const std::uint32_t session = numbered ? newSessionId() : 0; /**< 0 = pacotes sem sequência. */
+    RetransmitWindow retransmit(session ? RETRANSMIT_SLOTS : 0, registry.size());
+    std::int64_t nextNackPollNs = 0;
+    if (session)
+        LOG_INFO("Sessão {}", session);
+
+    ThreadMetrics &metrics = threadMetrics();
+    MetricsSnapshot snapshot;
+    char metricsBuf[2048];
+    std::int64_t nextMetricsNs = metricsNowNs() + static_cast<std::int64_t>(METRICS_INTERVAL_S * 1e9);
+
+    for (;;) {
+        // Relatório periódico das leituras suprimidas (contadores desta thread)
+        if (Scheduler::nowNs() >= nextReportNs) {
+            nextReportNs += static_cast<std::int64_t>(STATS_INTERVAL_S * 1e9);
+            for (std::size_t i = 0; i < policies.size(); ++i) {
+                const ReportStats &rs = policies[i].getStats();
+                LOG_INFO("{}: {} enviadas ({} heartbeats), {} suprimidas ({}%)", registry.at(i).getSensorId(),
+                         rs.sent, rs.heartbeats, rs.suppressed, static_cast<int>(rs.suppressionRatio() * 100.0 + 0.5));
+                policies[i].resetStats();
+            }
+
+            const SpoolStats &ss = spool.getStats();
+            LOG_INFO("Spool: {} pendentes, {} gravados, {} reenviados, {} sobrescritos",
+                     spool.pending(), ss.appended, ss.replayed, ss.evicted);
+
+            if (session) {
+                const RetransmitStats &rt = retransmit.getStats();
+                LOG_INFO("Retransmissão: {} pedidos, {} reenviados, {} fora da janela",
+                         rt.requested, rt.resent, rt.expired);
+            }
+        }
+
+        // Métricas: datagrama periódico (zera o intervalo) e relatório sob SIGUSR1
+        const std::int64_t nowNs = metricsNowNs();
+        const bool exportDue = nowNs >= nextMetricsNs;
+        const bool dumpDue = metricsDumpRequested();
+        if (exportDue || dumpDue) {
+            metrics.publish(nowNs);
+            collectMetrics(snapshot, exportDue);
+            std::size_t len = formatMetrics(snapshot, metricsBuf, sizeof(metricsBuf));
+            if (exportDue) {
+                nextMetricsNs += static_cast<std::int64_t>(METRICS_INTERVAL_S * 1e9);
+                if (len)
+                    metricsClient.sendData(metricsBuf, len);
+            }
+            // Maior que um registro de log e pedido à mão: vai direto ao console
+            if (dumpDue)
+                std::cout.write(metricsBuf, static_cast<std::streamsize>(len)) << std::endl;
         } else {
-            std::cerr << "Erro ao enviar pacote UDP!" << std::endl;
+            metrics.publishIfDue(nowNs);
         }
 
-        // Aguarda 1 segundo antes da próxima leitura
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        // Reenvio do spool em ritmo limitado; também serve de teste do enlace
+        spool.replay(Scheduler::nowNs(), [&](const void *data, std::size_t len) {
+            if (client.sendData(data, len))
+                return linkUp = true;
+            if (isLinkError(client.getLastError()))
+                linkUp = false;
+            return false; // buffer cheio: o registro fica para a próxima volta
+        });
+
+        // NACKs do servidor: verificados em intervalos, para não custar uma chamada por lote
+        if (session && nowNs >= nextNackPollNs) {
+            nextNackPollNs = nowNs + NACK_POLL_INTERVAL_NS;
+            serveNacks(client, retransmit, session, metrics);
+        }
+
+        std::size_t n = ring.popBulk(samples, sizeof(samples) / sizeof(samples[0]));
+        if (n == 0) {
+            if (BATCH_READINGS && !batcher.poll())
+                LOG_ERROR("falha ao enviar lote UDP");
+            timespec idle{0, IDLE_WAIT_NS};
+            nanosleep(&idle, nullptr);
+            continue;
+        }
+
+        for (std::size_t k = 0; k < n; ++k) {
+            const RawSample &s = samples[k];
+            Sensor &sensor = registry.at(s.sensorIndex);
+            std::int64_t t1 = metricsNowNs();
+            float valor = s.value;
+            if (std::isnan(valor)) {
+                const std::int64_t t0 = t1;
+                valor = sensor.convert(s.raw);
+                t1 = metricsNowNs();
+                metrics.record(MetricStage::Conversion, t1 - t0);
+            }
+            const bool sentinel = valor == -273.15f;
+            if (sentinel)
+                metrics.add(MetricCounter::ErrorSentinels);
+
+            // Memória compartilhada: os processos locais veem a leitura antes do envio UDP
+            publisher.publish(s.sensorIndex, valor, s.raw, !sentinel, s.epochNs);
+
+            const UdpPacket *out = &pkt;
+            std::size_t len, binLen = 0;
+            WindowAggregator &window = aggregators[s.sensorIndex];
+            if (window.enabled()) {
+                // A leitura só entra na janela; um erro apenas faz o tempo andar
+                if (!window.add(sentinel ? std::nan("") : valor, s.epochNs))
+                    continue;
+                fillSummary(summary, sensor, window.summary());
+                summary.session = session;
+                summary.seq = sequences[s.sensorIndex]++;
+                len = serializeSummaryInto(prefixes[s.sensorIndex], summary, jsonBuf, sizeof(jsonBuf));
+                binLen = encodeBinarySummary(summary, binBuf, sizeof(binBuf));
+                out = &summary;
+            } else {
+                // Dentro da banda morta e sem heartbeat vencido: não envia
+                if (!policies[s.sensorIndex].shouldSend(valor, s.epochNs))
+                    continue;
+
+                // Monta o pacote JSON
+                pkt.group_id   = sensor.getGroupId();
+                pkt.sensor_id  = sensor.getSensorId();
+                pkt.sensor_num = sensor.getSensorNum();
+                pkt.value      = valor;
+                pkt.unit       = sensor.getUnit();
+                pkt.epoch_ns   = s.epochNs;
+                pkt.timestamp.assign(tsBuf, formatTimestampInto(pkt.epoch_ns, TIMESTAMP_PRECISION, tsBuf, sizeof(tsBuf)));
+                pkt.session    = session;
+                pkt.seq        = sequences[s.sensorIndex]++;
+
+                if (BATCH_READINGS) {
+                    if (!batcher.add(pkt, &prefixes[s.sensorIndex]))
+                        LOG_ERROR("falha ao enviar lote UDP");
+                    continue;
+                }
+
+                len = serializeInto(prefixes[s.sensorIndex], pkt, jsonBuf, sizeof(jsonBuf));
+            }
+            const std::int64_t t2 = metricsNowNs();
+            metrics.record(MetricStage::Serialize, t2 - t1);
+
+            if (len == 0) {
+                LOG_ERROR("falha ao serializar pacote");
+                continue;
+            }
+            // Reenvios (NACK e spool) vão ao servidor principal: guarda a cópia no formato que ele recebe
+            if (binaryPrimary && binLen == 0 && out == &pkt)
+                binLen = encodeBinary(pkt, binBuf, sizeof(binBuf));
+            const char *primaryData = binaryPrimary ? reinterpret_cast<const char *>(binBuf) : jsonBuf;
+            const std::size_t primaryLen = binaryPrimary ? binLen : len;
+            if (session && primaryLen)
+                retransmit.store(out->sensor_num, out->seq, primaryData, primaryLen);
+
+            // Envia a todos os destinos; com o enlace fora do ar, guarda direto no spool
+            const bool sent = linkUp && client.sendToAll(*out, jsonBuf, len, binLen ? binBuf : nullptr, binLen);
+            metrics.record(MetricStage::Send, metricsNowNs() - t2);
+            if (sent) {
+                LOG_DEBUG("Enviado: {}", std::string_view(jsonBuf, len));
+            } else if (linkUp && !isLinkError(client.getLastError())) {
+                // Buffer do socket cheio (ou outro erro que não é do enlace): só este datagrama se perde
+                metrics.add(MetricCounter::SendDrops);
+            } else {
+                if (linkUp) {
+                    metrics.add(MetricCounter::SendFailures);
+                    LOG_ERROR("falha ao enviar pacote UDP: {}", std::strerror(client.getLastError()));
+                }
+                if (spool.isOpen() && primaryLen) {
+                    linkUp = false;
+                    spool.append(primaryData, primaryLen); // reenviado só ao principal, no formato dele
+                }
+            }
+        }
     }
 
+    scheduler.stop();
+    acquisition.join();
     return 0;
 }
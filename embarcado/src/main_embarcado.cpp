@@ -1,25 +1,55 @@
 /**
  * @file main_embarcado.cpp
- * @brief Implementação da função para leitura de temperatura do sensor embarcado.
+ * @brief Configuração dos sensores embarcados e leitura de temperatura.
  *
- * Este módulo define a função `getTemperature()`, utilizada pelo main principal
- * (`main.cpp`) para obter leituras periódicas de temperatura.
- * A função encapsula a criação e reutilização do objeto `Sensor`.
+ * Este módulo define o registro de sensores usado pelo main principal
+ * (`main.cpp`) e a função `getTemperature()`, mantida para leituras
+ * simples do primeiro canal.
+ *
+ * Sem a placa (ex: em CI), a variável de ambiente `SENSOR_SOURCE` troca o
+ * ADC por uma fonte sintética ou por uma captura (ver `makeRawSource()`),
+ * e `SENSOR_RATE_HZ` altera a frequência de amostragem:
+ * @code
+ * SENSOR_SOURCE=synthetic:sine,noise=20 SENSOR_RATE_HZ=1000 ./sensor
+ * SENSOR_SOURCE=replay:captura.bin ./sensor
+ * @endcode
  */
 
-#include "../include/sensor.hpp"
+#include "../include/sensor_registry.hpp"
+#include <cstdlib>
 
 /**
- * @brief Lê a temperatura do sensor embarcado.
+ * @brief Retorna o registro de sensores da placa.
  *
- * Utiliza um objeto estático da classe `Sensor` para garantir que
- * a inicialização do sensor ocorra apenas uma vez. A função
- * retorna o valor convertido em graus Celsius.
+ * O registro é criado na primeira chamada com os canais da placa. Para
+ * monitorar mais canais, basta adicionar novas entradas `SensorConfig`.
+ *
+ * @return Referência para o registro de sensores.
+ */
+SensorRegistry &getSensorRegistry() {
+    static SensorRegistry registry = [] {
+        SensorRegistry r;
+        SensorConfig cfg; /**< KY-013 no canal 13 (in_voltage13_raw). */
+        cfg.converter = makeConverter<Ky013Model>();
+        if (const char *rate = std::getenv("SENSOR_RATE_HZ"))
+            cfg.sampleRateHz = std::atof(rate);
+
+        const char *spec = std::getenv("SENSOR_SOURCE");
+        std::unique_ptr<RawSource> src = spec ? makeRawSource(spec) : nullptr;
+        if (spec && !src)
+            std::exit(1);
+        r.add(cfg, std::move(src));
+        return r;
+    }();
+
+    return registry;
+}
+
+/**
+ * @brief Lê a temperatura do primeiro sensor do registro.
  *
  * @return Temperatura medida pelo sensor em °C.
  */
 float getTemperature() {
-    static Sensor tempSensor; /**< Objeto estático que representa o sensor. */
-
-    return tempSensor.readValue(); /**< Retorna o valor convertido da leitura ADC. */
+    return getSensorRegistry().at(0).readValue(); /**< Retorna o valor convertido da leitura ADC. */
 }
@@ -0,0 +1,260 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementação dos histogramas de latência, do acumulador global e da exportação.
+ */
+
+#include "../include/metrics.hpp"
+#include <atomic>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    std::memset(counts, 0, sizeof(counts));
+    total = 0;
+    sum = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    if (other.total == 0)
+        return;
+    for (unsigned b = 0; b < BUCKETS; ++b)
+        counts[b] += other.counts[b];
+    total += other.total;
+    sum += other.sum;
+    if (other.minValue < minValue)
+        minValue = other.minValue;
+    if (other.maxValue > maxValue)
+        maxValue = other.maxValue;
+}
+
+std::uint64_t LatencyHistogram::bucketLow(unsigned b) {
+    if (b < SUB_COUNT)
+        return b;
+    const unsigned e = b / SUB_COUNT + SUB_BITS - 1;
+    const std::uint64_t sub = b % SUB_COUNT;
+    return (SUB_COUNT + sub) << (e - SUB_BITS);
+}
+
+std::uint64_t LatencyHistogram::percentile(double q) const {
+    if (total == 0)
+        return 0;
+    if (q < 0.0)
+        q = 0.0;
+    if (q > 1.0)
+        q = 1.0;
+
+    // Posição (1..total) da amostra do quantil
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total) + 0.5);
+    if (rank == 0)
+        rank = 1;
+
+    std::uint64_t seen = 0;
+    for (unsigned b = 0; b < BUCKETS; ++b) {
+        seen += counts[b];
+        if (seen < rank)
+            continue;
+        const std::uint64_t low = bucketLow(b);
+        const std::uint64_t high = b + 1 < BUCKETS ? bucketLow(b + 1) : maxValue + 1;
+        std::uint64_t v = low + (high - low) / 2;
+        if (v < minValue)
+            v = minValue;
+        if (v > maxValue)
+            v = maxValue;
+        return v;
+    }
+    return maxValue;
+}
+
+MetricsSnapshot::MetricsSnapshot()
+: startNs(0), endNs(0)
+{
+    std::memset(counters, 0, sizeof(counters));
+}
+
+const char *metricStageName(MetricStage s) {
+    switch (s) {
+    case MetricStage::AdcRead:    return "adc_read";
+    case MetricStage::Conversion: return "conversion";
+    case MetricStage::Serialize:  return "serialize";
+    case MetricStage::Send:       return "send";
+    case MetricStage::LoopJitter: return "loop_jitter";
+    default:                      return "?";
+    }
+}
+
+const char *metricCounterName(MetricCounter c) {
+    switch (c) {
+    case MetricCounter::ReadErrors:       return "read_errors";
+    case MetricCounter::ErrorSentinels:   return "error_sentinels";
+    case MetricCounter::SendFailures:     return "send_failures";
+    case MetricCounter::SendDrops:        return "send_drops";
+    case MetricCounter::RateIncreases:    return "rate_increases";
+    case MetricCounter::RateDecreases:    return "rate_decreases";
+    case MetricCounter::Retransmits:      return "retransmits";
+    case MetricCounter::RetransmitMisses: return "retransmit_misses";
+    default:                              return "?";
+    }
+}
+
+/**
+ * @brief Acumulador global, com a trava que o protege.
+ *
+ * Criado no primeiro uso, para existir antes de qualquer `ThreadMetrics`
+ * (e ser destruído depois delas).
+ */
+static std::mutex &globalLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+static MetricsSnapshot &globalMetrics() {
+    static MetricsSnapshot global = [] {
+        MetricsSnapshot m;
+        m.startNs = metricsNowNs();
+        return m;
+    }();
+    return global;
+}
+
+ThreadMetrics::ThreadMetrics()
+: lastPublishNs(metricsNowNs())
+{
+    globalLock();
+    globalMetrics();
+}
+
+ThreadMetrics::~ThreadMetrics() {
+    publish(metricsNowNs());
+}
+
+void ThreadMetrics::publish(std::int64_t nowNs) {
+    {
+        std::lock_guard<std::mutex> guard(globalLock());
+        MetricsSnapshot &g = globalMetrics();
+        for (std::size_t i = 0; i < METRIC_STAGES; ++i)
+            g.stages[i].merge(local.stages[i]);
+        for (std::size_t i = 0; i < METRIC_COUNTERS; ++i)
+            g.counters[i] += local.counters[i];
+    }
+    for (std::size_t i = 0; i < METRIC_STAGES; ++i)
+        local.stages[i].reset();
+    std::memset(local.counters, 0, sizeof(local.counters));
+    lastPublishNs = nowNs;
+}
+
+ThreadMetrics &threadMetrics() {
+    static thread_local ThreadMetrics metrics;
+    return metrics;
+}
+
+void collectMetrics(MetricsSnapshot &out, bool reset) {
+    std::lock_guard<std::mutex> guard(globalLock());
+    MetricsSnapshot &g = globalMetrics();
+    const std::int64_t now = metricsNowNs();
+    out = g;
+    out.endNs = now;
+    if (reset) {
+        for (std::size_t i = 0; i < METRIC_STAGES; ++i)
+            g.stages[i].reset();
+        std::memset(g.counters, 0, sizeof(g.counters));
+        g.startNs = now;
+    }
+}
+
+/**
+ * @class JsonOut
+ * @brief Escrita sequencial em um buffer de tamanho fixo; falha de forma definitiva ao estourar.
+ */
+class JsonOut {
+public:
+    JsonOut(char *buf, std::size_t cap) : p(buf), end(buf + cap), begin(buf), ok(true) {}
+
+    void text(const char *s) {
+        const std::size_t n = std::strlen(s);
+        if (!ok || static_cast<std::size_t>(end - p) < n) {
+            ok = false;
+            return;
+        }
+        std::memcpy(p, s, n);
+        p += n;
+    }
+
+    template <typename T>
+    void number(T v) {
+        if (!ok)
+            return;
+        std::to_chars_result r = std::to_chars(p, end, v);
+        if (r.ec != std::errc()) {
+            ok = false;
+            return;
+        }
+        p = r.ptr;
+    }
+
+    std::size_t size() const { return ok ? static_cast<std::size_t>(p - begin) : 0; }
+
+private:
+    char *p;
+    char *end;
+    char *begin;
+    bool ok;
+};
+
+std::size_t formatMetrics(const MetricsSnapshot &m, char *buf, std::size_t cap) {
+    JsonOut out(buf, cap);
+    out.text("{\"metrics\":{\"interval_s\":");
+    out.number(static_cast<double>(m.endNs - m.startNs) / 1e9);
+    out.text(",\"stages\":{");
+    for (std::size_t i = 0; i < METRIC_STAGES; ++i) {
+        const LatencyHistogram &h = m.stages[i];
+        out.text(i ? ",\"" : "\"");
+        out.text(metricStageName(static_cast<MetricStage>(i)));
+        out.text("\":{\"n\":");
+        out.number(h.count());
+        out.text(",\"min\":");
+        out.number(h.min());
+        out.text(",\"p50\":");
+        out.number(h.percentile(0.50));
+        out.text(",\"p90\":");
+        out.number(h.percentile(0.90));
+        out.text(",\"p99\":");
+        out.number(h.percentile(0.99));
+        out.text(",\"max\":");
+        out.number(h.max());
+        out.text(",\"mean\":");
+        out.number(static_cast<std::uint64_t>(h.mean() + 0.5));
+        out.text("}");
+    }
+    out.text("},\"counters\":{");
+    for (std::size_t i = 0; i < METRIC_COUNTERS; ++i) {
+        out.text(i ? ",\"" : "\"");
+        out.text(metricCounterName(static_cast<MetricCounter>(i)));
+        out.text("\":");
+        out.number(m.counters[i]);
+    }
+    out.text("}}}");
+    return out.size();
+}
+
+/** Pedido de relatório feito por SIGUSR1. */
+static std::atomic<bool> dumpRequested(false);
+
+static void onMetricsSignal(int) {
+    dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+void installMetricsSignal() {
+    std::signal(SIGUSR1, onMetricsSignal);
+}
+
+bool metricsDumpRequested() {
+    return dumpRequested.exchange(false, std::memory_order_relaxed);
+}
@@ -0,0 +1,158 @@
+/**
+ * @file packet_batcher.cpp
+ * @brief Implementação da classe PacketBatcher.
+ *
+ * Formatos dos datagramas:
+ *  - JSON: `[` + objetos separados por `,` + `]`.
+ *  - Binário: `BINARY_BATCH_MAGIC`, contador (u8) e registros `[tamanho][bytes]`.
+ */
+
+#include "../include/packet_batcher.hpp"
+#include "../include/binary_protocol.hpp"
+#include <algorithm>
+
+/**
+ * @brief Limita `maxBytes` ao intervalo aceito.
+ *
+ * Abaixo de `BATCH_MIN_BYTES`, os cabeçalhos (`[` ou magic e contador)
+ * seriam escritos além do buffer; acima de `BATCH_MAX_BYTES`, nenhum
+ * datagrama cheio seria aceito pelo kernel.
+ */
+static BatchConfig clampConfig(BatchConfig cfg) {
+    cfg.maxBytes = std::clamp(cfg.maxBytes, BATCH_MIN_BYTES, BATCH_MAX_BYTES);
+    return cfg;
+}
+
+/**
+ * @brief Cria o agrupador e aloca o buffer do datagrama.
+ *
+ * `maxBytes` é limitado a [`BATCH_MIN_BYTES`, `BATCH_MAX_BYTES`].
+ *
+ * @param c Cliente UDP de destino.
+ * @param cfg Parâmetros de agrupamento.
+ */
+PacketBatcher::PacketBatcher(UDPClient &c, const BatchConfig &cfg)
+: client(c), config(clampConfig(cfg)), buf(config.maxBytes), used(0), count(0),
+  datagrams(0), readings(0)
+{
+}
+
+PacketBatcher::~PacketBatcher() {
+    flush();
+}
+
+std::size_t PacketBatcher::encode(const UdpPacket &p, const std::string *prefix, std::size_t limit) {
+    if (limit <= used)
+        return 0;
+
+    std::size_t cap = limit - used;
+    if (config.format == BatchFormat::BinaryRecords)
+        return encodeBinary(p, reinterpret_cast<std::uint8_t *>(buf.data() + used), cap);
+
+    return prefix ? serializeInto(*prefix, p, buf.data() + used, cap)
+                  : serializeInto(p, buf.data() + used, cap);
+}
+
+/**
+ * @brief Adiciona uma leitura ao lote, enviando o lote atual se ela não couber.
+ *
+ * @param p Pacote a ser adicionado.
+ * @param prefix Prefixo JSON pré-calculado do sensor, ou `nullptr`.
+ * @return `false` se um envio falhou ou a leitura não cabe em um datagrama.
+ */
+bool PacketBatcher::add(const UdpPacket &p, const std::string *prefix) {
+    const bool json = (config.format == BatchFormat::JsonArray);
+    bool ok = true;
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const std::size_t saved = used;
+
+        if (count == 0) {
+            if (json) {
+                buf[used++] = '[';
+            } else {
+                buf[used++] = static_cast<char>(BINARY_BATCH_MAGIC);
+                buf[used++] = 0;
+            }
+        } else if (json) {
+            buf[used++] = ',';
+        }
+
+        // No modo binário, reserva o byte de tamanho; no JSON, o ']' final
+        std::size_t lenPos = used;
+        if (!json)
+            ++used;
+        std::size_t limit = json ? config.maxBytes - 1 : config.maxBytes;
+
+        std::size_t n = (used < limit && (json || count < 255)) ? encode(p, prefix, limit) : 0;
+        if (n > 0) {
+            if (!json) {
+                buf[lenPos] = static_cast<char>(n);
+                buf[1] = static_cast<char>(count + 1);
+            }
+            used += n;
+            if (count++ == 0)
+                deadline = std::chrono::steady_clock::now() + config.maxLatency;
+            return ok;
+        }
+
+        used = saved;
+        if (count == 0)
+            break; // não cabe nem em um datagrama vazio
+
+        ok = flush() && ok;
+    }
+
+    if (count == 0)
+        used = 0;
+    return false;
+}
+
+/**
+ * @brief Envia o lote se o prazo tiver vencido.
+ *
+ * @return `false` se o envio falhou.
+ */
+bool PacketBatcher::poll() {
+    if (count == 0 || std::chrono::steady_clock::now() < deadline)
+        return true;
+    return flush();
+}
+
+/**
+ * @brief Fecha e envia o datagrama atual.
+ *
+ * O lote é descartado mesmo em caso de falha, para não reenviar
+ * leituras antigas indefinidamente.
+ *
+ * @return `false` se o envio falhou.
+ */
+bool PacketBatcher::flush() {
+    if (count == 0)
+        return true;
+
+    if (config.format == BatchFormat::JsonArray)
+        buf[used++] = ']';
+
+    bool ok = client.sendData(buf.data(), used);
+    if (ok) {
+        ++datagrams;
+        readings += count;
+    }
+
+    used = 0;
+    count = 0;
+    return ok;
+}
+
+std::size_t PacketBatcher::pending() const {
+    return count;
+}
+
+std::uint64_t PacketBatcher::datagramsSent() const {
+    return datagrams;
+}
+
+std::uint64_t PacketBatcher::readingsSent() const {
+    return readings;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file raw_source.cpp
+ * @brief Implementação das fontes sintética e de reprodução de amostras brutas.
+ */
+
+#include "../include/raw_source.hpp"
+#include "../include/logger.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+/** Maior valor do ADC de 16 bits. */
+static const int ADC_MAX = 65535;
+
+std::size_t RawSource::readBlock(std::uint16_t *out, std::size_t maxSamples) {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < maxSamples; ++i) {
+        int v = read();
+        if (v >= 0)
+            out[n++] = static_cast<std::uint16_t>(v);
+    }
+    return n;
+}
+
+SyntheticSource::SyntheticSource(const SyntheticConfig &cfg)
+: config(cfg), index(0), state(0), sineStep(0.0), errorThreshold(0)
+{
+    if (!(config.period >= 1.0))
+        config.period = 1.0;
+    sineStep = 2.0 * M_PI / config.period;
+
+    if (config.errorRate >= 1.0)
+        errorThreshold = UINT64_MAX;
+    else if (config.errorRate > 0.0)
+        errorThreshold = static_cast<std::uint64_t>(config.errorRate * 18446744073709551616.0);
+    rewind();
+}
+
+void SyntheticSource::rewind() {
+    index = 0;
+    state = config.seed ? config.seed : 0x9E3779B97F4A7C15ULL; // xorshift não aceita estado zero
+}
+
+std::uint64_t SyntheticSource::next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+int SyntheticSource::sample() {
+    const double n = static_cast<double>(index);
+    double v = config.base;
+    switch (config.waveform) {
+    case SyntheticWaveform::Ramp:
+        v += config.amplitude * std::fmod(n, config.period) / config.period;
+        break;
+    case SyntheticWaveform::Sine:
+        v += config.amplitude * std::sin(std::fmod(n, config.period) * sineStep);
+        break;
+    case SyntheticWaveform::Step:
+        if (n >= config.period)
+            v += config.amplitude;
+        break;
+    case SyntheticWaveform::Noise:
+    case SyntheticWaveform::Stuck:
+        break;
+    }
+
+    // Ruído aproximadamente gaussiano: soma de 4 uniformes (Irwin-Hall), desvio 1
+    if (config.noise > 0.0 && config.waveform != SyntheticWaveform::Stuck) {
+        double u = uniform() + uniform() + uniform() + uniform();
+        v += (u - 2.0) * 1.7320508075688772 * config.noise;
+    }
+
+    ++index;
+    if (v < 0.0)
+        return 0;
+    if (v > ADC_MAX)
+        return ADC_MAX;
+    return static_cast<int>(v + 0.5);
+}
+
+int SyntheticSource::read() {
+    if (errorThreshold && next() < errorThreshold) {
+        ++index;
+        return -1;
+    }
+    return sample();
+}
+
+std::size_t SyntheticSource::readBlock(std::uint16_t *out, std::size_t maxSamples) {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < maxSamples; ++i) {
+        if (errorThreshold && next() < errorThreshold) {
+            ++index;
+            continue;
+        }
+        out[n++] = static_cast<std::uint16_t>(sample());
+    }
+    return n;
+}
+
+ReplaySource::ReplaySource()
+: pos(0), loop(true)
+{
+}
+
+bool ReplaySource::open(const std::string &path, ReplayFormat format, bool repeat) {
+    samples.clear();
+    pos = 0;
+    loop = repeat;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("não foi possível abrir a captura {}", path);
+        return false;
+    }
+
+    if (format == ReplayFormat::Binary) {
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        samples.reserve(bytes.size() / 2);
+        for (std::size_t i = 0; i + 1 < bytes.size(); i += 2)
+            samples.push_back(static_cast<std::uint8_t>(bytes[i]) |
+                              (static_cast<std::uint8_t>(bytes[i + 1]) << 8));
+    } else {
+        std::string line;
+        while (std::getline(in, line)) {
+            char *end;
+            long v = std::strtol(line.c_str(), &end, 10);
+            if (end == line.c_str())
+                continue; // linha vazia ou comentário
+            samples.push_back(v < 0 ? -1 : (v > ADC_MAX ? ADC_MAX : static_cast<std::int32_t>(v)));
+        }
+    }
+
+    if (samples.empty()) {
+        LOG_ERROR("captura vazia: {}", path);
+        return false;
+    }
+    return true;
+}
+
+int ReplaySource::read() {
+    if (pos >= samples.size()) {
+        if (!loop || samples.empty())
+            return -1;
+        pos = 0;
+    }
+    return samples[pos++];
+}
+
+std::size_t ReplaySource::readBlock(std::uint16_t *out, std::size_t maxSamples) {
+    std::size_t n = 0;
+    while (n < maxSamples) {
+        if (pos >= samples.size()) {
+            if (!loop || samples.empty())
+                break;
+            pos = 0;
+        }
+        std::int32_t v = samples[pos++];
+        if (v >= 0)
+            out[n++] = static_cast<std::uint16_t>(v);
+    }
+    return n;
+}
+
+/**
+ * @brief Separa `s` em campos delimitados por vírgula.
+ */
+static std::vector<std::string> splitFields(const std::string &s) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t comma = s.find(',', start);
+        fields.push_back(s.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+        if (comma == std::string::npos)
+            return fields;
+        start = comma + 1;
+    }
+}
+
+std::unique_ptr<RawSource> makeRawSource(const std::string &spec) {
+    if (spec.compare(0, 7, "replay:") == 0) {
+        std::vector<std::string> fields = splitFields(spec.substr(7));
+        ReplayFormat format = ReplayFormat::Binary;
+        bool repeat = true;
+        for (std::size_t i = 1; i < fields.size(); ++i) {
+            if (fields[i] == "text") {
+                format = ReplayFormat::Text;
+            } else if (fields[i] == "once") {
+                repeat = false;
+            } else {
+                LOG_ERROR("opção de captura desconhecida: {}", fields[i]);
+                return nullptr;
+            }
+        }
+        std::unique_ptr<ReplaySource> src(new ReplaySource());
+        if (!src->open(fields[0], format, repeat))
+            return nullptr;
+        return std::unique_ptr<RawSource>(std::move(src));
+    }
+
+    if (spec.compare(0, 9, "synthetic") != 0) {
+        LOG_ERROR("fonte desconhecida: {}", spec);
+        return nullptr;
+    }
+
+    SyntheticConfig cfg;
+    std::string rest = spec.substr(9);
+    if (!rest.empty() && rest[0] != ':' && rest[0] != ',') {
+        LOG_ERROR("fonte desconhecida: {}", spec);
+        return nullptr;
+    }
+    std::vector<std::string> fields = splitFields(rest.empty() ? rest : rest.substr(1));
+
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        const std::string &f = fields[i];
+        if (f.empty())
+            continue; // "synthetic" sem parâmetros
+        std::size_t eq = f.find('=');
+        if (eq == std::string::npos) {
+            if (i == 0 && rest[0] == ':') {
+                if (f == "ramp")       cfg.waveform = SyntheticWaveform::Ramp;
+                else if (f == "sine")  cfg.waveform = SyntheticWaveform::Sine;
+                else if (f == "noise") cfg.waveform = SyntheticWaveform::Noise;
+                else if (f == "step")  cfg.waveform = SyntheticWaveform::Step;
+                else if (f == "stuck") cfg.waveform = SyntheticWaveform::Stuck;
+                else {
+                    LOG_ERROR("forma de onda desconhecida: {}", f);
+                    return nullptr;
+                }
+                continue;
+            }
+            LOG_ERROR("parâmetro sem valor: {}", f);
+            return nullptr;
+        }
+
+        const std::string key = f.substr(0, eq);
+        const char *value = f.c_str() + eq + 1;
+        char *end;
+        double v = std::strtod(value, &end);
+        if (end == value || *end != '\0') {
+            LOG_ERROR("valor inválido em {}", f);
+            return nullptr;
+        }
+        if (key == "base")           cfg.base = v;
+        else if (key == "amplitude") cfg.amplitude = v;
+        else if (key == "period")    cfg.period = v;
+        else if (key == "noise")     cfg.noise = v;
+        else if (key == "error")     cfg.errorRate = v;
+        else if (key == "seed")      cfg.seed = static_cast<std::uint64_t>(v);
+        else {
+            LOG_ERROR("parâmetro desconhecido: {}", key);
+            return nullptr;
+        }
+    }
+    return std::unique_ptr<RawSource>(new SyntheticSource(cfg));
+}
@@ -0,0 +1,60 @@
+/**
+ * @file report_policy.cpp
+ * @brief Implementação da classe ReportPolicy.
+ */
+
+#include "../include/report_policy.hpp"
+#include <cmath>
+
+ReportPolicy::ReportPolicy(const ReportConfig &cfg)
+: config(cfg), stats(), hasLast(false), lastSent(0.0), lastSentNs(0)
+{
+}
+
+/**
+ * @brief Decide se a leitura sai da banda morta ou se o heartbeat venceu.
+ *
+ * A comparação é sempre com o último valor enviado (e não com a leitura
+ * anterior), para que uma deriva lenta acabe sendo transmitida.
+ */
+bool ReportPolicy::shouldSend(double value, std::int64_t nowNs) {
+    ++stats.evaluated;
+
+    bool send = !hasLast || std::isnan(value) || std::isnan(lastSent);
+    if (!send) {
+        double threshold = config.absDeadband;
+        double relative = config.relDeadband * std::fabs(lastSent);
+        if (relative > threshold)
+            threshold = relative;
+        send = std::fabs(value - lastSent) >= threshold;
+    }
+
+    if (!send && config.maxSilenceS > 0.0 &&
+        static_cast<double>(nowNs - lastSentNs) >= config.maxSilenceS * 1e9) {
+        send = true;
+        ++stats.heartbeats;
+    }
+
+    if (!send) {
+        ++stats.suppressed;
+        return false;
+    }
+
+    ++stats.sent;
+    hasLast = true;
+    lastSent = value;
+    lastSentNs = nowNs;
+    return true;
+}
+
+void ReportPolicy::reset() {
+    hasLast = false;
+}
+
+const ReportStats &ReportPolicy::getStats() const {
+    return stats;
+}
+
+void ReportPolicy::resetStats() {
+    stats = ReportStats();
+}
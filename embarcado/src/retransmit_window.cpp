@@ -0,0 +1,102 @@
+/**
+ * @file retransmit_window.cpp
+ * @brief Implementação da classe RetransmitWindow e do sorteio da sessão.
+ */
+
+#include "../include/retransmit_window.hpp"
+#include <cstring>
+#include <ctime>
+#include <sys/random.h>
+#include <unistd.h>
+
+RetransmitWindow::RetransmitWindow(std::size_t slots, std::size_t sensors)
+: ring(slots * sensors), lanes(slots ? sensors : 0), perLane(slots), stats()
+{
+    for (Slot &s : ring)
+        s.len = 0;
+}
+
+int RetransmitWindow::laneOf(std::uint16_t sensorNum, bool create) {
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+        Lane &l = lanes[i];
+        if (l.used && l.sensorNum == sensorNum)
+            return static_cast<int>(i);
+        if (!l.used) {
+            if (!create)
+                return -1;
+            l.used = true;
+            l.sensorNum = sensorNum;
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void RetransmitWindow::store(std::uint16_t sensorNum, std::uint32_t seq, const void *data, std::size_t len) {
+    if (len == 0 || len > RETRANSMIT_SLOT_BYTES)
+        return;
+    const int lane = laneOf(sensorNum, true);
+    if (lane < 0)
+        return;
+
+    Slot &s = ring[lane * perLane + seq % perLane];
+    s.seq = seq;
+    s.len = static_cast<std::uint16_t>(len);
+    std::memcpy(s.data, data, len);
+    lanes[lane].newest = seq;
+    ++stats.stored;
+}
+
+const char *RetransmitWindow::find(std::uint16_t sensorNum, std::uint32_t seq, std::size_t &len) {
+    ++stats.requested;
+    const int lane = laneOf(sensorNum, false);
+    if (lane >= 0) {
+        const Slot &s = ring[lane * perLane + seq % perLane];
+        if (s.len != 0 && s.seq == seq) {
+            len = s.len;
+            return s.data;
+        }
+    }
+    ++stats.expired;
+    return nullptr;
+}
+
+std::uint32_t RetransmitWindow::clampRange(std::uint16_t sensorNum, std::uint32_t &first, std::uint32_t &count) {
+    const std::uint32_t requested = count;
+    const int lane = laneOf(sensorNum, false);
+    if (lane < 0) {
+        count = 0;
+    } else {
+        // Janela: [newest - perLane + 1, newest], em aritmética módulo 2^32
+        const std::uint32_t span = static_cast<std::uint32_t>(perLane);
+        const std::uint32_t oldest = lanes[lane].newest - (span - 1);
+        const std::uint32_t offset = first - oldest;
+        if (offset >= span) {
+            const std::uint32_t before = oldest - first; // números antes da janela
+            if (before < count) {
+                first = oldest;
+                count -= before;
+            } else {
+                count = 0;
+            }
+        }
+        const std::uint32_t room = span - (first - oldest);
+        if (count > room)
+            count = room;
+    }
+    const std::uint32_t cut = requested - count;
+    stats.requested += cut;
+    stats.expired += cut;
+    return cut;
+}
+
+std::uint32_t newSessionId() {
+    std::uint32_t id = 0;
+    if (getrandom(&id, sizeof(id), GRND_NONBLOCK) != static_cast<ssize_t>(sizeof(id))) {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        id = static_cast<std::uint32_t>(ts.tv_sec) * 2654435761u ^ static_cast<std::uint32_t>(ts.tv_nsec) ^
+             static_cast<std::uint32_t>(getpid()) << 16;
+    }
+    return id ? id : 1;
+}
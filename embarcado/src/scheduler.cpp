@@ -0,0 +1,134 @@
+/**
+ * @file scheduler.cpp
+ * @brief Implementação da classe Scheduler.
+ */
+
+#include "../include/scheduler.hpp"
+#include <cerrno>
+#include <ctime>
+#include <sys/prctl.h>
+
+std::int64_t Scheduler::nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Converte uma frequência em período, em ns.
+ *
+ * @return Período, ou 0 se a frequência for inválida.
+ */
+static std::int64_t periodFromRate(double rateHz) {
+    if (!(rateHz > 0.0) || rateHz > 1e9)
+        return 0;
+    return static_cast<std::int64_t>(1e9 / rateHz + 0.5);
+}
+
+int Scheduler::addTask(double rateHz, Task fn) {
+    std::int64_t period = periodFromRate(rateHz);
+    if (period == 0 || !fn)
+        return -1;
+
+    tasks.push_back(Entry{std::move(fn), period, nowNs(), TaskStats{}});
+    return static_cast<int>(tasks.size() - 1);
+}
+
+bool Scheduler::setRate(int id, double rateHz) {
+    std::int64_t period = periodFromRate(rateHz);
+    if (period == 0 || id < 0 || static_cast<std::size_t>(id) >= tasks.size())
+        return false;
+
+    tasks[id].periodNs = period;
+    return true;
+}
+
+double Scheduler::getRate(int id) const {
+    return 1e9 / static_cast<double>(tasks.at(id).periodNs);
+}
+
+/**
+ * @brief Dorme até o prazo mais próximo e executa as tarefas vencidas.
+ *
+ * Para cada tarefa executada, o próximo prazo é `prazo + período`. Se esse
+ * instante já passou, os períodos perdidos são contados em
+ * `TaskStats::missed` e o prazo avança para o primeiro instante futuro.
+ *
+ * @return `false` se não houver tarefas.
+ */
+bool Scheduler::runOnce() {
+    if (tasks.empty())
+        return false;
+
+    std::int64_t next = tasks[0].deadline;
+    for (const Entry &t : tasks)
+        if (t.deadline < next)
+            next = t.deadline;
+
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(next / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(next % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+
+    for (Entry &t : tasks) {
+        std::int64_t start = nowNs();
+        if (t.deadline > start)
+            continue;
+
+        lateness = start - t.deadline;
+        TaskStats &st = t.stats;
+        if (st.runs == 0 || lateness < st.jitterMinNs)
+            st.jitterMinNs = lateness;
+        if (st.runs == 0 || lateness > st.jitterMaxNs)
+            st.jitterMaxNs = lateness;
+        st.jitterSumNs += static_cast<double>(lateness);
+        ++st.runs;
+
+        t.fn();
+
+        t.deadline += t.periodNs;
+        std::int64_t now = nowNs();
+        if (t.deadline <= now) {
+            std::int64_t skipped = (now - t.deadline) / t.periodNs + 1;
+            st.missed += static_cast<std::uint64_t>(skipped);
+            t.deadline += skipped * t.periodNs;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Laço do agendador.
+ *
+ * Reduz a folga de temporizadores da thread (50 µs por padrão no Linux)
+ * para 1 ns, pois ela apareceria diretamente como atraso de todas as tarefas.
+ */
+void Scheduler::run() {
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+    stopRequested = false;
+    while (!stopRequested && runOnce()) {
+    }
+}
+
+void Scheduler::stop() {
+    stopRequested = true;
+}
+
+const TaskStats &Scheduler::getStats(int id) const {
+    return tasks.at(id).stats;
+}
+
+std::int64_t Scheduler::currentLatenessNs() const {
+    return lateness;
+}
+
+void Scheduler::resetStats() {
+    for (Entry &t : tasks)
+        t.stats = TaskStats{};
+}
+
+std::size_t Scheduler::size() const {
+    return tasks.size();
+}
@@ -9,67 +9,212 @@
 
 #include "../include/sensor.hpp"
 #include "../include/utils.hpp"
-#include <iostream>
-#include <fstream>
+#include "../include/logger.hpp"
+#include <cerrno>
+#include <charconv>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Converte o texto de um atributo sysfs em inteiro.
+ *
+ * Aceita espaços iniciais, sinal opcional e dígitos decimais; o primeiro
+ * caractere não numérico (normalmente '\n') encerra a conversão. Um valor
+ * que não cabe em `int` (arquivo corrompido ou falso) é rejeitado.
+ *
+ * @param buf Texto lido do arquivo.
+ * @param len Número de bytes válidos em `buf`.
+ * @param out Valor convertido.
+ * @return `true` se ao menos um dígito foi encontrado e o valor cabe em `int`.
+ */
+static bool parseSysfsInt(const char *buf, ssize_t len, int &out) {
+    const char *p = buf;
+    const char *end = buf + len;
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+
+    // from_chars aceita '-', mas não '+'
+    if (p < end && *p == '+' && ++p < end && *p == '-')
+        return false;
+
+    std::from_chars_result r = std::from_chars(p, end, out);
+    return r.ec == std::errc();
+}
 
 /**
  * @brief Construtor da classe Sensor.
  *
- * Inicializa o último valor lido como 0 e define a unidade padrão como "°C".
+ * Inicializa o último valor lido como 0 e usa a configuração padrão
+ * (canal 13, unidade "°C").
  */
-Sensor::Sensor() {
-    lastValue = 0.0f;
-    unit = "°C";
+Sensor::Sensor()
+: Sensor(SensorConfig{})
+{
+}
+
+/**
+ * @brief Constrói um sensor para o canal configurado e abre seu arquivo sysfs.
+ *
+ * Falhas na abertura são apenas registradas; `readRaw()` tenta reabrir.
+ *
+ * @param cfg Configuração do canal.
+ */
+Sensor::Sensor(const SensorConfig &cfg)
+: Sensor(cfg, nullptr)
+{
+}
+
+/**
+ * @brief Constrói um sensor; sem fonte alternativa, abre o arquivo sysfs do canal.
+ *
+ * @param cfg Configuração do canal.
+ * @param src Fonte das amostras brutas (nulo = ADC).
+ */
+Sensor::Sensor(const SensorConfig &cfg, std::unique_ptr<RawSource> src)
+: lastValue(0.0f), lastRaw(-1), config(cfg), fd(-1), source(std::move(src))
+{
+    if (!source)
+        openChannel();
+    if (!filter.configure(config.filters, config.sampleRateHz))
+        LOG_WARN("filtros inválidos para {}; leituras sem filtragem", config.sensorId);
 }
 
 /**
  * @brief Destrutor da classe Sensor.
  *
- * Atualmente não realiza operações adicionais.
+ * Fecha o descritor do canal.
  */
-Sensor::~Sensor() {}
+Sensor::~Sensor() {
+    if (fd >= 0)
+        close(fd);
+}
+
+bool Sensor::openChannel() {
+    if (fd >= 0)
+        return true;
+
+    fd = open(config.channelPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("não foi possível abrir {}", config.channelPath);
+        return false;
+    }
+    return true;
+}
 
 /**
  * @brief Lê o valor bruto do sensor (ADC) a partir de arquivo do sistema.
- *"/sys/bus/iio/devices/iio:device0/in_voltage13_raw"
- * O valor é lido do arquivo correspondente ao canal ADC utilizado
- * pelo sensor embarcado.
+ *
+ * O arquivo do canal (ex: "/sys/bus/iio/devices/iio:device0/in_voltage13_raw")
+ * permanece aberto; cada leitura é um único `pread()` no offset 0, que faz
+ * o driver amostrar o canal novamente.
  *
  * @return Valor inteiro lido do ADC. Retorna -1 em caso de erro ao abrir ou ler o arquivo.
  */
 int Sensor::readRaw() {
-    const std::string path = "/sys/bus/iio/devices/iio:device0/in_voltage13_raw";
-    std::ifstream file(path);
-
-    if (!file.is_open()) {
-        std::cerr << "Erro: não foi possível abrir " << path << std::endl;
+    if (source)
+        return source->read();
+    if (!openChannel())
         return -1;  /**< Valor negativo indica falha na leitura. */
-    }
 
-    int rawValue = 0;
-    file >> rawValue;
+    char buf[32];
+    ssize_t n;
+    do {
+        n = pread(fd, buf, sizeof(buf), 0);
+    } while (n < 0 && errno == EINTR);
 
-    if (file.fail()) {
-        std::cerr << "Erro: falha ao ler valor de " << path << std::endl;
+    int rawValue = 0;
+    if (n <= 0 || !parseSysfsInt(buf, n, rawValue)) {
+        LOG_ERROR("falha ao ler valor de {}", config.channelPath);
         return -1;
     }
 
-    file.close();
     return rawValue;
 }
 
+/**
+ * @brief Habilita a captura em bloco via buffer IIO.
+ *
+ * @param cfg Configuração do buffer IIO.
+ * @return `true` se o buffer foi configurado e aberto.
+ */
+bool Sensor::enableBufferedCapture(const IioBufferConfig &cfg) {
+    return buffer.open(cfg);
+}
+
+/**
+ * @brief Desabilita a captura em bloco e libera o dispositivo IIO.
+ */
+void Sensor::disableBufferedCapture() {
+    buffer.close();
+}
+
+/**
+ * @brief Lê um bloco de amostras brutas do buffer IIO.
+ *
+ * @param out Vetor de saída para as amostras.
+ * @param maxSamples Capacidade de `out`.
+ * @return Número de amostras lidas, 0 se não houver dados ou -1 em caso de erro.
+ */
+int Sensor::readRawBlock(std::uint16_t *out, std::size_t maxSamples) {
+    if (source)
+        return static_cast<int>(source->readBlock(out, maxSamples));
+    if (!buffer.isOpen()) {
+        LOG_ERROR("captura em bloco não habilitada");
+        return -1;
+    }
+    return buffer.readBlock(out, maxSamples);
+}
+
+/**
+ * @brief Lê o ADC e aplica a cadeia de filtros do sensor.
+ *
+ * @param raw Valor bruto filtrado, ou -1 em caso de erro de leitura.
+ * @return `false` se a decimação não produziu valor nesta leitura.
+ */
+bool Sensor::readFiltered(float &raw) {
+    int value = readRaw();
+    lastRaw = value;
+    if (value < 0) {
+        raw = -1.0f;
+        return true;
+    }
+    return filter.process(static_cast<float>(value), raw);
+}
+
+/**
+ * @brief Aplica os filtros do sensor a um bloco de amostras.
+ *
+ * @param in Amostras brutas do ADC.
+ * @param out Amostras filtradas.
+ * @param n Número de amostras de entrada.
+ * @return Número de amostras filtradas.
+ */
+std::size_t Sensor::filterBlock(const std::uint16_t *in, float *out, std::size_t n) {
+    return filter.processBlock(in, out, n);
+}
+
+void Sensor::resetFilter() {
+    filter.reset();
+}
+
+void Sensor::setSampleRate(double hz) {
+    filter.setSampleRate(hz);
+}
+
 /**
  * @brief Lê e converte o valor do sensor para unidade física (°C).
  *
- * Chama `readRaw()` para obter o valor do ADC e depois utiliza
- * a função `convertRawToCelsius()` para converter para temperatura.
- * O último valor lido é armazenado em `lastValue`.
+ * Chama `readFiltered()` para obter o valor do ADC e depois utiliza
+ * `convert()` (modelo fixo do canal ou `convertRawToCelsius()` com a
+ * calibração) para converter para temperatura. Os últimos valores são armazenados em `lastRaw` e `lastValue`.
  *
- * @return Valor convertido em °C.
+ * @return Valor convertido em °C (o anterior, se a decimação ainda acumula).
  */
 float Sensor::readValue() {
-    int raw = readRaw();
-    lastValue = convertRawToCelsius(raw);
+    float raw;
+    if (readFiltered(raw))
+        lastValue = convert(raw);
     return lastValue;
 }
 
@@ -79,5 +224,52 @@ float Sensor::readValue() {
  * @return Unidade como string (ex: "°C").
  */
 std::string Sensor::getUnit() {
-    return unit;
+    return config.unit;
+}
+
+const std::string &Sensor::getGroupId() const {
+    return config.groupId;
+}
+
+const std::string &Sensor::getSensorId() const {
+    return config.sensorId;
+}
+
+std::uint16_t Sensor::getSensorNum() const {
+    return config.sensorNum;
+}
+
+double Sensor::getSampleRate() const {
+    return config.sampleRateHz;
+}
+
+float Sensor::getLastValue() const {
+    return lastValue;
+}
+
+int Sensor::getLastRaw() const {
+    return lastRaw;
+}
+
+void Sensor::convertBlock(const std::uint16_t *in, float *out, std::size_t n) const {
+    if (config.converter.convertBlock)
+        config.converter.convertBlock(in, out, n);
+    else
+        convertRawToCelsius(in, out, n, config.calibration);
+}
+
+const ThermistorCalibration &Sensor::getCalibration() const {
+    return config.calibration;
+}
+
+const ReportConfig &Sensor::getReportConfig() const {
+    return config.report;
+}
+
+const AggregateConfig &Sensor::getAggregateConfig() const {
+    return config.aggregate;
+}
+
+const AdaptiveRateConfig &Sensor::getAdaptiveRateConfig() const {
+    return config.adaptiveRate;
 }
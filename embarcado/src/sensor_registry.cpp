@@ -0,0 +1,52 @@
+/**
+ * @file sensor_registry.cpp
+ * @brief Implementação da classe SensorRegistry.
+ */
+
+#include "../include/sensor_registry.hpp"
+
+/**
+ * @brief Cria um sensor para o canal e o adiciona ao registro.
+ *
+ * @param cfg Configuração do canal.
+ * @return Índice do sensor no registro.
+ */
+std::size_t SensorRegistry::add(const SensorConfig &cfg) {
+    sensors.push_back(std::unique_ptr<Sensor>(new Sensor(cfg)));
+    return sensors.size() - 1;
+}
+
+std::size_t SensorRegistry::add(const SensorConfig &cfg, std::unique_ptr<RawSource> src) {
+    sensors.push_back(std::unique_ptr<Sensor>(new Sensor(cfg, std::move(src))));
+    return sensors.size() - 1;
+}
+
+std::size_t SensorRegistry::size() const {
+    return sensors.size();
+}
+
+Sensor &SensorRegistry::at(std::size_t index) {
+    return *sensors.at(index);
+}
+
+/**
+ * @brief Lê e converte todos os canais em uma única passada.
+ *
+ * Cada canal custa um `pread()` no descritor persistente do sensor.
+ *
+ * @param out Vetor de saída.
+ * @param capacity Capacidade de `out`.
+ * @return Número de leituras escritas.
+ */
+std::size_t SensorRegistry::pollAll(SensorReading *out, std::size_t capacity) {
+    std::size_t count = sensors.size() < capacity ? sensors.size() : capacity;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Sensor &s = *sensors[i];
+        out[i].sensor = &s;
+        out[i].value = s.readValue();
+        out[i].raw = s.getLastRaw();
+    }
+
+    return count;
+}
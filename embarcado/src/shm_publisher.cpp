@@ -0,0 +1,165 @@
+/**
+ * @file shm_publisher.cpp
+ * @brief Implementação da classe ShmPublisher.
+ */
+
+#include "../include/shm_publisher.hpp"
+#include "../include/logger.hpp"
+#include <cmath>
+#include <ctime>
+#include <new>
+
+namespace {
+
+/**
+ * @brief Copia `s` para um campo de tamanho fixo, sempre com terminador.
+ */
+void copyField(char *dst, std::size_t cap, const std::string &s) {
+    const std::size_t n = s.size() < cap - 1 ? s.size() : cap - 1;
+    std::memcpy(dst, s.data(), n);
+    std::memset(dst + n, 0, cap - n);
+}
+
+/**
+ * @brief Marca como abandonado um segmento anterior com o mesmo nome.
+ *
+ * Os leitores que ainda o mapeiam veem `retired()` e reabrem o novo.
+ */
+void retireExisting(const char *name) {
+    int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+        return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(ShmHeader)) {
+        void *p = mmap(nullptr, sizeof(ShmHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            static_cast<ShmHeader *>(p)->magic.store(0, std::memory_order_release);
+            munmap(p, sizeof(ShmHeader));
+        }
+    }
+    ::close(fd);
+    shm_unlink(name);
+}
+
+} // namespace
+
+ShmPublisher::ShmPublisher()
+: base(nullptr), size(0), count(0), historyLen(0),
+  header(nullptr), slots(nullptr), history(nullptr), published(false)
+{
+}
+
+ShmPublisher::~ShmPublisher() {
+    close();
+}
+
+bool ShmPublisher::open(const ShmConfig &cfg, std::size_t sensors) {
+    close();
+
+    if (sensors == 0 || sensors > 0xFFFF || cfg.historyLength > 0xFFFFFFFFu || cfg.name.empty()) {
+        LOG_ERROR("parâmetros de memória compartilhada inválidos");
+        return false;
+    }
+
+    // Um segmento novo a cada início: leitores do anterior não veem o formato mudar sob eles
+    retireExisting(cfg.name.c_str());
+    int fd = shm_open(cfg.name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("não foi possível criar a memória compartilhada {}", cfg.name);
+        return false;
+    }
+
+    const std::size_t bytes = shmReadingsSize(sensors, cfg.historyLength);
+    void *p = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        LOG_ERROR("falha ao mapear a memória compartilhada {}", cfg.name);
+        shm_unlink(cfg.name.c_str());
+        return false;
+    }
+
+    base = static_cast<char *>(p);
+    size = bytes;
+    count = sensors;
+    historyLen = cfg.historyLength;
+    name = cfg.name;
+    published = false;
+
+    // O segmento vem zerado do ftruncate(); só falta construir os atômicos
+    header = new (base) ShmHeader();
+    slots = reinterpret_cast<ShmSlot *>(base + sizeof(ShmHeader));
+    history = reinterpret_cast<ShmHistoryEntry *>(base + sizeof(ShmHeader) + count * sizeof(ShmSlot));
+    for (std::size_t i = 0; i < count; ++i)
+        new (&slots[i]) ShmSlot();
+    for (std::size_t i = 0; i < count * historyLen; ++i)
+        new (&history[i]) ShmHistoryEntry();
+
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    header->magic.store(0, std::memory_order_relaxed);
+    header->version = SHM_READINGS_VERSION;
+    header->sensorCount = static_cast<std::uint16_t>(count);
+    header->historyLength = static_cast<std::uint32_t>(historyLen);
+    header->slotSize = sizeof(ShmSlot);
+    header->startNs = static_cast<std::int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    return true;
+}
+
+void ShmPublisher::close() {
+    if (!base)
+        return;
+    header->magic.store(0, std::memory_order_release);
+    munmap(base, size);
+    shm_unlink(name.c_str());
+    base = nullptr;
+    header = nullptr;
+    slots = nullptr;
+    history = nullptr;
+    size = count = historyLen = 0;
+}
+
+void ShmPublisher::describe(std::size_t index, const std::string &sensorId, const std::string &unit,
+                            std::uint16_t sensorNum) {
+    if (!base || index >= count)
+        return;
+    ShmSlot &s = slots[index];
+    s.sensorNum = sensorNum;
+    copyField(s.sensorId, sizeof(s.sensorId), sensorId);
+    copyField(s.unit, sizeof(s.unit), unit);
+}
+
+void ShmPublisher::publish(std::size_t index, double value, float raw, bool valid, std::int64_t epochNs) {
+    if (!base || index >= count)
+        return;
+    if (!valid)
+        value = std::nan("");
+
+    ShmSlot &s = slots[index];
+    const std::uint64_t seq = s.seq + 1; // só esta thread grava `seq`
+
+    // Histórico primeiro: a última leitura sempre tem a sua entrada
+    if (historyLen) {
+        ShmHistoryEntry &e = history[index * historyLen + (seq - 1) % historyLen];
+        const std::uint32_t v = shmWriteBegin(e.lock);
+        e.seq = seq;
+        e.epochNs = epochNs;
+        e.value = value;
+        e.raw = raw;
+        shmWriteEnd(e.lock, v);
+    }
+
+    const std::uint32_t v = shmWriteBegin(s.lock);
+    s.seq = seq;
+    s.epochNs = epochNs;
+    s.value = value;
+    s.raw = raw;
+    s.valid = valid ? 1 : 0;
+    shmWriteEnd(s.lock, v);
+
+    if (!published) {
+        header->magic.store(SHM_READINGS_MAGIC, std::memory_order_release);
+        published = true;
+    }
+}
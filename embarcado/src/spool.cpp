@@ -0,0 +1,303 @@
+/**
+ * @file spool.cpp
+ * @brief Implementação da classe Spool.
+ */
+
+#include "../include/spool.hpp"
+#include "../include/logger.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/** Tamanho da área de cabeçalho do arquivo (uma página). */
+const std::size_t kHeaderArea = 4096;
+
+/** Identificação do arquivo. */
+const char kMagic[8] = {'S', 'P', 'O', 'O', 'L', 'v', '1', '\0'};
+
+/** Marca escrita por último em um registro completo. */
+const std::uint32_t kCommitMark = 0x314C5053u; // "SPL1"
+
+/**
+ * @brief FNV-1a de 32 bits, continuando de `h`.
+ */
+std::uint32_t fnv1a(const void *data, std::size_t len, std::uint32_t h = 2166136261u) {
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+} // namespace
+
+/**
+ * @struct Spool::FileHeader
+ * @brief Cabeçalho no início do arquivo.
+ *
+ * `tail` é atualizado a cada reenvio confirmado; `head` é apenas
+ * informativo (a recuperação o reconstrói pelos registros válidos).
+ */
+struct Spool::FileHeader {
+    char magic[8];              /**< `kMagic`. */
+    std::uint32_t recordSize;   /**< Tamanho de cada registro. */
+    std::uint32_t reserved;     /**< Alinhamento. */
+    std::uint64_t capacity;     /**< Número de registros. */
+    std::uint64_t tail;         /**< Sequência mais antiga pendente. */
+    std::uint64_t head;         /**< Próxima sequência a gravar. */
+};
+
+/**
+ * @struct Spool::RecordHeader
+ * @brief Cabeçalho de cada registro (24 bytes), seguido do datagrama.
+ */
+struct Spool::RecordHeader {
+    std::uint32_t commit;       /**< `kCommitMark` quando o registro está completo. */
+    std::uint32_t checksum;     /**< FNV-1a de `seq`, `len` e do datagrama. */
+    std::uint64_t seq;          /**< Número de sequência do registro. */
+    std::uint32_t len;          /**< Tamanho do datagrama. */
+    std::uint32_t reserved;     /**< Alinhamento. */
+};
+
+/**
+ * @brief Checksum de um registro.
+ */
+static std::uint32_t recordChecksum(std::uint64_t seq, std::uint32_t len, const void *data) {
+    std::uint32_t h = fnv1a(&seq, sizeof(seq));
+    h = fnv1a(&len, sizeof(len), h);
+    return fnv1a(data, len, h);
+}
+
+Spool::Spool()
+: config(), stats(), fd(-1), map(nullptr), mapSize(0), head(0), tail(0),
+  sinceSync(0), replayTokens(0.0), lastReplayNs(0)
+{
+}
+
+Spool::~Spool() {
+    close();
+}
+
+bool Spool::open(const SpoolConfig &cfg) {
+    close();
+
+    if (cfg.recordSize < sizeof(RecordHeader) + 8 || cfg.recordSize % 8 != 0 || cfg.capacity == 0) {
+        LOG_ERROR("parâmetros de spool inválidos");
+        return false;
+    }
+
+    fd = ::open(cfg.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("não foi possível abrir o spool {}", cfg.path);
+        return false;
+    }
+
+    const std::size_t size = kHeaderArea + cfg.capacity * cfg.recordSize;
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        (static_cast<std::size_t>(st.st_size) != size && ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+        LOG_ERROR("não foi possível dimensionar o spool {}", cfg.path);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        LOG_ERROR("falha ao mapear o spool {}", cfg.path);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    config = cfg;
+    map = static_cast<unsigned char *>(p);
+    mapSize = size;
+    stats = SpoolStats();
+    sinceSync = 0;
+    replayTokens = 0.0;
+    lastReplayNs = 0;
+
+    FileHeader *hdr = reinterpret_cast<FileHeader *>(map);
+    if (std::memcmp(hdr->magic, kMagic, sizeof(kMagic)) != 0 ||
+        hdr->recordSize != cfg.recordSize || hdr->capacity != cfg.capacity) {
+        // Arquivo novo ou de outro formato: começa vazio
+        std::memset(map, 0, mapSize);
+        std::memcpy(hdr->magic, kMagic, sizeof(kMagic));
+        hdr->recordSize = static_cast<std::uint32_t>(cfg.recordSize);
+        hdr->capacity = cfg.capacity;
+        msync(map, mapSize, MS_SYNC);
+    }
+
+    recover();
+    return true;
+}
+
+void Spool::close() {
+    if (map) {
+        msync(map, mapSize, MS_SYNC);
+        munmap(map, mapSize);
+        map = nullptr;
+        mapSize = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool Spool::isOpen() const {
+    return map != nullptr;
+}
+
+unsigned char *Spool::slot(std::uint64_t seq) const {
+    return map + kHeaderArea + (seq % config.capacity) * config.recordSize;
+}
+
+bool Spool::valid(std::uint64_t seq) const {
+    const unsigned char *p = slot(seq);
+    const RecordHeader *rh = reinterpret_cast<const RecordHeader *>(p);
+
+    return __atomic_load_n(&rh->commit, __ATOMIC_ACQUIRE) == kCommitMark &&
+           rh->seq == seq &&
+           rh->len <= config.recordSize - sizeof(RecordHeader) &&
+           rh->checksum == recordChecksum(seq, rh->len, p + sizeof(RecordHeader));
+}
+
+/**
+ * @brief Recupera a fila após abrir o arquivo.
+ *
+ * O fim da fila é o maior número de sequência válido + 1; o início é o
+ * `tail` salvo no cabeçalho, limitado à janela de `capacity` registros.
+ */
+void Spool::recover() {
+    FileHeader *hdr = reinterpret_cast<FileHeader *>(map);
+    bool any = false;
+    std::uint64_t maxSeq = 0;
+
+    for (std::size_t i = 0; i < config.capacity; ++i) {
+        const RecordHeader *rh = reinterpret_cast<const RecordHeader *>(map + kHeaderArea + i * config.recordSize);
+        if (rh->commit != kCommitMark || rh->seq % config.capacity != i || !valid(rh->seq))
+            continue;
+        if (!any || rh->seq > maxSeq)
+            maxSeq = rh->seq;
+        any = true;
+    }
+
+    if (!any) {
+        head = tail = hdr->tail > hdr->head ? hdr->tail : hdr->head;
+    } else {
+        head = maxSeq + 1;
+        tail = hdr->tail;
+        if (head - tail > config.capacity || tail > head)
+            tail = head > config.capacity ? head - config.capacity : 0;
+    }
+
+    hdr->tail = tail;
+    hdr->head = head;
+
+    if (head != tail) {
+        LOG_INFO("spool: {} registros pendentes em {}", head - tail, config.path);
+    }
+}
+
+bool Spool::append(const void *data, std::size_t len) {
+    if (!map)
+        return false;
+    if (len > config.recordSize - sizeof(RecordHeader)) {
+        ++stats.rejected;
+        return false;
+    }
+
+    FileHeader *hdr = reinterpret_cast<FileHeader *>(map);
+    if (head - tail >= config.capacity) {
+        ++tail;
+        hdr->tail = tail;
+        ++stats.evicted;
+    }
+
+    unsigned char *p = slot(head);
+    RecordHeader *rh = reinterpret_cast<RecordHeader *>(p);
+
+    // Invalida o registro antes de reescrevê-lo; a marca volta só no fim
+    __atomic_store_n(&rh->commit, 0u, __ATOMIC_RELEASE);
+    std::memcpy(p + sizeof(RecordHeader), data, len);
+    rh->seq = head;
+    rh->len = static_cast<std::uint32_t>(len);
+    rh->reserved = 0;
+    rh->checksum = recordChecksum(head, rh->len, data);
+    __atomic_store_n(&rh->commit, kCommitMark, __ATOMIC_RELEASE);
+
+    ++head;
+    hdr->head = head;
+    ++stats.appended;
+
+    if (config.syncEvery && ++sinceSync >= config.syncEvery) {
+        msync(map, mapSize, MS_ASYNC);
+        sinceSync = 0;
+    }
+    return true;
+}
+
+/**
+ * @brief Reenvia registros com um balde de fichas de `replayRateHz`.
+ *
+ * Cada tentativa consome uma ficha, mesmo que falhe: com o enlace ainda
+ * fora do ar, o reenvio funciona como sonda na mesma taxa limitada.
+ */
+std::size_t Spool::replay(std::int64_t nowNs, const SendFn &send) {
+    if (!map || head == tail)
+        return 0;
+
+    if (lastReplayNs == 0)
+        lastReplayNs = nowNs;
+    replayTokens += static_cast<double>(nowNs - lastReplayNs) * config.replayRateHz / 1e9;
+    if (replayTokens > config.replayBurst)
+        replayTokens = config.replayBurst;
+    lastReplayNs = nowNs;
+
+    FileHeader *hdr = reinterpret_cast<FileHeader *>(map);
+    std::size_t sent = 0;
+
+    while (head != tail && replayTokens >= 1.0) {
+        if (!valid(tail)) {
+            ++stats.corrupt;
+            ++tail;
+            hdr->tail = tail;
+            continue;
+        }
+
+        const unsigned char *p = slot(tail);
+        const RecordHeader *rh = reinterpret_cast<const RecordHeader *>(p);
+        replayTokens -= 1.0;
+        if (!send(p + sizeof(RecordHeader), rh->len))
+            break;
+
+        ++tail;
+        hdr->tail = tail;
+        ++stats.replayed;
+        ++sent;
+    }
+
+    return sent;
+}
+
+std::size_t Spool::pending() const {
+    return static_cast<std::size_t>(head - tail);
+}
+
+void Spool::sync() {
+    if (map) {
+        msync(map, mapSize, MS_SYNC);
+        sinceSync = 0;
+    }
+}
+
+const SpoolStats &Spool::getStats() const {
+    return stats;
+}
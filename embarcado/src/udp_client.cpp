@@ -2,65 +2,759 @@
  * @file udp_client.cpp
  * @brief Implementação da classe UDPClient para envio de dados via protocolo UDP.
  *
- * Este módulo define a criação do socket UDP, envio de pacotes de dados
- * e fechamento do socket quando o cliente é destruído.
+ * Este módulo define a criação e conexão do socket UDP, envio de pacotes
+ * de dados (individual, em lote com `sendmmsg()` ou segmentado com
+ * `UDP_SEGMENT`), o envio a um conjunto de destinos (`sendToAll()`) e
+ * fechamento dos sockets quando o cliente é destruído.
  */
 
 #include "../include/udp_client.hpp"
-#include <iostream>
+#include "../include/binary_protocol.hpp"
+#include "../include/logger.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103 /**< Valor do kernel Linux, ausente em libcs antigas. */
+#endif
+
+/** Número máximo de mensagens por chamada a `sendmmsg()`. */
+static const std::size_t MAX_BATCH = 64;
+
+/** Número máximo de segmentos aceitos pelo kernel em um envio GSO. */
+static const std::size_t MAX_GSO_SEGMENTS = 64;
+
+/** Número máximo de destinos de `sendToAll()`, incluindo o principal. */
+static const std::size_t MAX_DESTINATIONS = 16;
+
+/**
+ * @brief Posição da família `af` em `familyFd` (0 = IPv4, 1 = IPv6).
+ */
+static int familySlot(int af) {
+    return af == AF_INET6 ? 1 : 0;
+}
+
+/**
+ * @brief Ativa ou desativa `O_NONBLOCK` em `fd`.
+ */
+static bool applyNonBlocking(int fd, bool enable) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0)
+        return false;
+
+    flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(fd, F_SETFL, flags) == 0;
+}
+
+/**
+ * @brief Acrescenta uma mensagem de controle com `len` bytes de `data` em `control`.
+ *
+ * @param control Início do espaço de controle (alinhado como `cmsghdr`).
+ * @param used Bytes já usados; avança com a nova mensagem.
+ * @return `false` se não couber em `cap` bytes.
+ */
+static bool appendControl(char *control, std::size_t cap, std::size_t &used,
+                          int level, int type, const void *data, std::size_t len)
+{
+    if (used + CMSG_SPACE(len) > cap)
+        return false;
+    cmsghdr *cm = reinterpret_cast<cmsghdr *>(control + used);
+    cm->cmsg_level = level;
+    cm->cmsg_type = type;
+    cm->cmsg_len = CMSG_LEN(len);
+    std::memcpy(CMSG_DATA(cm), data, len);
+    used += CMSG_SPACE(len);
+    return true;
+}
+
 /**
  * @brief Construtor da classe UDPClient.
  *
- * Cria um socket UDP e armazena o endereço IP e a porta do servidor destino.
- * Caso ocorra erro na criação do socket, uma mensagem é exibida no console.
+ * Cria um socket UDP, converte o endereço IP uma única vez e conecta o
+ * socket ao destino, de modo que os envios não precisem informar o
+ * endereço. Caso ocorra erro, uma mensagem é exibida no console e os
+ * envios passam a retornar falha.
  *
  * @param ip Endereço IP do servidor (ex: "127.0.0.1").
  * @param port Porta UDP do servidor.
+ * @param enc Codificação usada por `sendPacket()`.
  */
-UDPClient::UDPClient(const std::string &ip, int port)
-: server_ip(ip), server_port(port)
+UDPClient::UDPClient(const std::string &ip, int port, WireEncoding enc)
+: sockfd(-1), familyFd{-1, -1}, nonBlocking(false), server_ip(ip), server_port(port), encoding(enc),
+  connected(false), gsoSupported(true), gsoConfirmed(false), lastError(0)
 {
-    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (sockfd < 0)
-        std::cerr << "Erro criando socket UDP\n";
+    // Ignora espaços em volta do endereço (ex: " 192.168.42.10")
+    std::size_t first = server_ip.find_first_not_of(" \t");
+    std::size_t last = server_ip.find_last_not_of(" \t");
+    server_ip = (first == std::string::npos) ? std::string() : server_ip.substr(first, last - first + 1);
+
+    UdpDestination primary;
+    primary.address = server_ip;
+    primary.port = server_port;
+    primary.encoding = encoding;
+    Destination d;
+    if (!resolve(primary, d))
+        return;
+
+    sockfd = socket(d.addr.ss_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sockfd < 0) {
+        LOG_ERROR("falha ao criar socket UDP: {}", std::strerror(errno));
+        return;
+    }
+
+    if (connect(sockfd, reinterpret_cast<sockaddr *>(&d.addr), d.addrLen) < 0) {
+        LOG_ERROR("falha ao conectar socket UDP: {}", std::strerror(errno));
+        return;
+    }
+
+    // O socket conectado também envia aos destinos da mesma família (endereço por mensagem)
+    familyFd[familySlot(d.addr.ss_family)] = sockfd;
+    destinations.reserve(MAX_DESTINATIONS);
+    destinations.push_back(d);
+    connected = true;
 }
 
 /**
  * @brief Destrutor da classe UDPClient.
  *
- * Fecha o socket UDP, se ele estiver aberto.
+ * Fecha o socket UDP e o socket da outra família, se estiverem abertos.
  */
 UDPClient::~UDPClient() {
     if (sockfd >= 0)
         close(sockfd);
+    for (int fd : familyFd)
+        if (fd >= 0 && fd != sockfd)
+            close(fd);
 }
 
 /**
  * @brief Envia dados para o servidor via UDP.
  *
- * Configura a estrutura sockaddr_in com IP e porta do servidor,
- * e envia a string de dados usando `sendto()`.
- *
  * @param data String contendo os dados a serem enviados.
  * @return `true` se todos os bytes foram enviados corretamente, `false` em caso de erro.
  */
 bool UDPClient::sendData(const std::string &data) {
+    return sendData(data.data(), data.size());
+}
+
+/**
+ * @brief Codifica o pacote conforme `encoding` e o envia.
+ *
+ * O pacote é montado em um buffer local, sem alocação; apenas pacotes JSON
+ * que não caibam nele recorrem a `serialize()`.
+ *
+ * @param p Pacote a ser enviado.
+ * @return `true` se o envio for bem-sucedido.
+ */
+bool UDPClient::sendPacket(const UdpPacket &p) {
+    if (encoding == WireEncoding::Binary) {
+        std::uint8_t buf[BINARY_PACKET_SIZE + BINARY_SEQUENCE_SIZE];
+        std::size_t len = encodeBinary(p, buf, sizeof(buf));
+        return sendData(buf, len);
+    }
+
+    char buf[512];
+    std::size_t len = serializeInto(p, buf, sizeof(buf));
+    if (len == 0)
+        return sendData(serialize(p));
+    return sendData(buf, len);
+}
+
+void UDPClient::setEncoding(WireEncoding enc) {
+    encoding = enc;
+    if (!destinations.empty())
+        destinations[0].encoding = enc;
+}
+
+WireEncoding UDPClient::getEncoding() const {
+    return encoding;
+}
+
+/**
+ * @brief Envia um bloco de bytes como um único datagrama.
+ *
+ * Como o socket já está conectado, usa `send()` sem endereço.
+ *
+ * @param data Início dos dados.
+ * @param len Tamanho dos dados, em bytes.
+ * @return `true` se todos os bytes foram enviados corretamente, `false` em caso de erro.
+ */
+bool UDPClient::sendData(const void *data, std::size_t len) {
+    if (!connected) {
+        lastError = ENOTCONN;
+        return false;
+    }
+
+    ssize_t sent;
+    do {
+        sent = send(sockfd, data, len, 0);
+    } while (sent < 0 && errno == EINTR);
+
+    ++stats.calls;
+    if (sent < 0) {
+        lastError = errno;
+        countFailure(lastError, 1);
+        return false;
+    }
+
+    lastError = 0;
+    ++stats.datagrams;
+    stats.bytes += static_cast<std::uint64_t>(sent);
+    return sent == (ssize_t)len;
+}
+
+long UDPClient::receiveData(void *buf, std::size_t cap) {
+    if (!connected)
+        return -1;
+
+    for (;;) {
+        ssize_t n = recv(sockfd, buf, cap, MSG_DONTWAIT);
+        if (n >= 0)
+            return static_cast<long>(n);
+        if (errno != EINTR && errno != ECONNREFUSED)
+            return -1;
+    }
+}
+
+/**
+ * @brief Contabiliza datagramas perdidos por um erro de envio.
+ *
+ * @param err Valor de `errno`.
+ * @param lost Número de datagramas perdidos.
+ */
+void UDPClient::countFailure(int err, std::size_t lost) {
+    if (err == EAGAIN || err == EWOULDBLOCK)
+        stats.eagainDrops += lost;
+    else
+        stats.errors += lost;
+}
+
+/**
+ * @brief Envia vários datagramas com `sendmmsg()`.
+ *
+ * Um datagrama que falhe por erro diferente de EAGAIN é descartado e o
+ * envio continua a partir do seguinte; em EAGAIN, todo o restante do
+ * lote é descartado, pois o buffer do socket está cheio.
+ *
+ * @param datagrams Vetor de datagramas (um `iovec` por datagrama).
+ * @param count Número de datagramas.
+ * @return Número de datagramas aceitos pelo kernel.
+ */
+std::size_t UDPClient::sendBatch(const iovec *datagrams, std::size_t count) {
+    if (!connected) {
+        stats.errors += count;
+        return 0;
+    }
+
+    mmsghdr msgs[MAX_BATCH];
+    std::size_t done = 0;
+    std::size_t accepted = 0;
+
+    while (done < count) {
+        std::size_t chunk = count - done < MAX_BATCH ? count - done : MAX_BATCH;
+        for (std::size_t i = 0; i < chunk; ++i) {
+            msgs[i] = mmsghdr{};
+            msgs[i].msg_hdr.msg_iov = const_cast<iovec *>(&datagrams[done + i]);
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        std::uint64_t dropsBefore = stats.eagainDrops;
+        accepted += submit(sockfd, msgs, chunk);
+        done += chunk;
+
+        // Buffer do socket cheio: descarta o restante do lote
+        if (stats.eagainDrops != dropsBefore) {
+            stats.eagainDrops += count - done;
+            break;
+        }
+    }
+
+    return accepted;
+}
+
+/**
+ * @brief Envia mensagens montadas com `sendmmsg()`.
+ *
+ * Um datagrama que falhe por erro diferente de EAGAIN é descartado e o
+ * envio continua a partir do seguinte; em EAGAIN, todo o restante é
+ * descartado, pois o buffer do socket está cheio.
+ *
+ * @param fd Socket de envio.
+ * @param msgs Mensagens (com `msg_len` zerado).
+ * @param count Número de mensagens.
+ * @param firstError Se não for nulo, recebe o `errno` que descartou a primeira mensagem (0 = aceita).
+ * @return Número de mensagens aceitas pelo kernel.
+ */
+std::size_t UDPClient::submit(int fd, mmsghdr *msgs, std::size_t count, int *firstError) {
+    std::size_t done = 0;
+    std::size_t accepted = 0;
+    if (firstError)
+        *firstError = 0;
+
+    while (done < count) {
+        std::size_t chunk = count - done < MAX_BATCH ? count - done : MAX_BATCH;
+
+        int n;
+        do {
+            n = sendmmsg(fd, msgs + done, static_cast<unsigned>(chunk), 0);
+        } while (n < 0 && errno == EINTR);
+        ++stats.calls;
+
+        if (n < 0) {
+            int err = errno;
+            if (firstError && done == 0)
+                *firstError = err;
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                countFailure(err, count - done);
+                break;
+            }
+            // Descarta o datagrama que falhou e segue com os próximos
+            countFailure(err, 1);
+            ++done;
+            continue;
+        }
+
+        for (int i = 0; i < n; ++i)
+            stats.bytes += msgs[done + i].msg_len;
+        stats.datagrams += static_cast<std::uint64_t>(n);
+        accepted += static_cast<std::size_t>(n);
+        done += static_cast<std::size_t>(n);
+    }
+
+    return accepted;
+}
+
+/**
+ * @brief Converte o endereço e monta as mensagens de controle do destino.
+ *
+ * Para multicast, cada datagrama leva o TTL (`IP_TTL`/`IPV6_HOPLIMIT`) e,
+ * se houver interface, o índice dela (`IP_PKTINFO`/`IPV6_PKTINFO`); um
+ * endereço IPv6 também recebe a interface como escopo, necessário para
+ * grupos de enlace local (ff02::).
+ *
+ * @param dest Destino informado.
+ * @param out Destino resolvido.
+ * @return `false` se a porta, o endereço, o TTL ou a interface forem inválidos.
+ */
+bool UDPClient::resolve(const UdpDestination &dest, Destination &out) {
+    out = Destination();
+    out.encoding = dest.encoding;
+    out.rateDivisor = dest.rateDivisor ? dest.rateDivisor : 1;
+
+    if (dest.port <= 0 || dest.port > 65535) {
+        LOG_ERROR("porta UDP inválida: {}", dest.port);
+        return false;
+    }
+    if (dest.multicastTtl < 1 || dest.multicastTtl > 255) {
+        LOG_ERROR("TTL multicast inválido: {}", dest.multicastTtl);
+        return false;
+    }
+
+    unsigned ifindex = 0;
+    if (!dest.multicastInterface.empty()) {
+        ifindex = if_nametoindex(dest.multicastInterface.c_str());
+        if (ifindex == 0) {
+            LOG_ERROR("interface desconhecida: {}", dest.multicastInterface);
+            return false;
+        }
+    }
+
+    const int ttl = dest.multicastTtl;
+    sockaddr_in *a4 = reinterpret_cast<sockaddr_in *>(&out.addr);
+    sockaddr_in6 *a6 = reinterpret_cast<sockaddr_in6 *>(&out.addr);
+
+    if (inet_pton(AF_INET, dest.address.c_str(), &a4->sin_addr) == 1) {
+        a4->sin_family = AF_INET;
+        a4->sin_port = htons(static_cast<std::uint16_t>(dest.port));
+        out.addrLen = sizeof(sockaddr_in);
+        if (IN_MULTICAST(ntohl(a4->sin_addr.s_addr))) {
+            appendControl(out.control, sizeof(out.control), out.controlLen, IPPROTO_IP, IP_TTL, &ttl, sizeof(ttl));
+            if (ifindex) {
+                in_pktinfo pi{};
+                pi.ipi_ifindex = static_cast<int>(ifindex);
+                appendControl(out.control, sizeof(out.control), out.controlLen, IPPROTO_IP, IP_PKTINFO, &pi, sizeof(pi));
+            }
+        }
+        return true;
+    }
+
+    if (inet_pton(AF_INET6, dest.address.c_str(), &a6->sin6_addr) == 1) {
+        a6->sin6_family = AF_INET6;
+        a6->sin6_port = htons(static_cast<std::uint16_t>(dest.port));
+        a6->sin6_scope_id = ifindex;
+        out.addrLen = sizeof(sockaddr_in6);
+        if (IN6_IS_ADDR_MULTICAST(&a6->sin6_addr)) {
+            appendControl(out.control, sizeof(out.control), out.controlLen, IPPROTO_IPV6, IPV6_HOPLIMIT, &ttl, sizeof(ttl));
+            if (ifindex) {
+                in6_pktinfo pi{};
+                pi.ipi6_ifindex = ifindex;
+                appendControl(out.control, sizeof(out.control), out.controlLen, IPPROTO_IPV6, IPV6_PKTINFO, &pi, sizeof(pi));
+            }
+        }
+        return true;
+    }
+
+    LOG_ERROR("endereço IP inválido: {}", dest.address);
+    return false;
+}
+
+int UDPClient::addDestination(const UdpDestination &dest) {
+    if (destinations.size() >= MAX_DESTINATIONS) {
+        LOG_ERROR("conjunto de destinos cheio ({})", MAX_DESTINATIONS);
+        return -1;
+    }
+    Destination d;
+    if (!resolve(dest, d) || socketFor(d.addr.ss_family) < 0)
+        return -1;
+    destinations.push_back(d);
+    return static_cast<int>(destinations.size() - 1);
+}
+
+std::size_t UDPClient::destinationCount() const {
+    return destinations.size();
+}
+
+const UdpDestinationStats &UDPClient::getDestinationStats(std::size_t index) const {
+    return destinations.at(index).stats;
+}
+
+/**
+ * @brief Socket da família `af`, criado (não conectado) no primeiro uso.
+ *
+ * @param af `AF_INET` ou `AF_INET6`.
+ * @return Descritor, ou -1 se não puder ser criado.
+ */
+int UDPClient::socketFor(int af) {
+    int &fd = familyFd[familySlot(af)];
+    if (fd >= 0)
+        return fd;
+
+    fd = socket(af, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("falha ao criar socket UDP: {}", std::strerror(errno));
+        return -1;
+    }
+    if (nonBlocking)
+        applyNonBlocking(fd, true);
+    return fd;
+}
+
+/**
+ * @brief Codifica o pacote uma vez por codificação e o envia aos destinos.
+ *
+ * Os datagramas de cada família são montados em um vetor de `mmsghdr`
+ * (endereço e mensagens de controle de cada destino, `iovec` apontando
+ * para o buffer da codificação) e enviados com um `sendmmsg()`.
+ *
+ * @param p Pacote a ser enviado.
+ * @param json JSON já serializado, ou `nullptr` para serializar aqui.
+ * @param jsonLen Tamanho de `json`.
+ * @param binary Registro binário já codificado, ou `nullptr` para codificar aqui.
+ * @param binaryLen Tamanho de `binary`.
+ * @return `true` se o destino principal aceitou o datagrama.
+ */
+bool UDPClient::sendToAll(const UdpPacket &p, const char *json, std::size_t jsonLen,
+                          const std::uint8_t *binary, std::size_t binaryLen)
+{
+    if (destinations.empty()) {
+        ++stats.errors;
+        lastError = ENOTCONN;
+        return false;
+    }
+
+    char jsonBuf[512];
+    std::string jsonFallback;
+    std::uint8_t binBuf[BINARY_PACKET_SIZE + BINARY_SEQUENCE_SIZE];
+    iovec jsonIov{nullptr, 0};
+    iovec binIov{nullptr, 0};
+
+    mmsghdr msgs[2][MAX_DESTINATIONS];
+    std::size_t owner[2][MAX_DESTINATIONS]; /**< Destino de cada mensagem. */
+    std::size_t count[2] = {0, 0};
+    bool primaryOk = true;
+    int primaryFamily = -1; /**< Família da mensagem do principal, sempre a primeira dela. */
+
+    for (std::size_t i = 0; i < destinations.size(); ++i) {
+        Destination &d = destinations[i];
+        if (d.rateDivisor > 1) {
+            // Contagem própria de cada sensor; só aloca na primeira leitura de um número maior
+            if (p.sensor_num >= d.countdown.size())
+                d.countdown.resize(p.sensor_num + 1u, 0);
+            unsigned &left = d.countdown[p.sensor_num];
+            if (left > 0) {
+                --left;
+                ++d.stats.skipped;
+                continue;
+            }
+            left = d.rateDivisor - 1;
+        }
+
+        // Cada codificação é montada uma única vez, no primeiro destino que a usa
+        iovec *iov = &jsonIov;
+        if (d.encoding == WireEncoding::Binary) {
+            iov = &binIov;
+            if (!binIov.iov_base) {
+                if (!binary) {
+                    binaryLen = encodeBinary(p, binBuf, sizeof(binBuf));
+                    binary = binBuf;
+                }
+                binIov.iov_base = const_cast<std::uint8_t *>(binary);
+                binIov.iov_len = binaryLen;
+            }
+        } else if (!jsonIov.iov_base) {
+            if (!json) {
+                jsonLen = serializeInto(p, jsonBuf, sizeof(jsonBuf));
+                json = jsonBuf;
+                if (jsonLen == 0) {
+                    jsonFallback = serialize(p);
+                    json = jsonFallback.data();
+                    jsonLen = jsonFallback.size();
+                }
+            }
+            jsonIov.iov_base = const_cast<char *>(json);
+            jsonIov.iov_len = jsonLen;
+        }
+
+        const int f = familySlot(d.addr.ss_family);
+        mmsghdr &m = msgs[f][count[f]];
+        m = mmsghdr{};
+        m.msg_hdr.msg_name = &d.addr;
+        m.msg_hdr.msg_namelen = d.addrLen;
+        m.msg_hdr.msg_iov = iov;
+        m.msg_hdr.msg_iovlen = 1;
+        if (d.controlLen) {
+            m.msg_hdr.msg_control = d.control;
+            m.msg_hdr.msg_controllen = d.controlLen;
+        }
+        owner[f][count[f]++] = i;
+        if (i == 0) {
+            primaryOk = false; // até o kernel aceitar
+            primaryFamily = f;
+        }
+    }
+
+    lastError = 0;
+    for (int f = 0; f < 2; ++f) {
+        if (count[f] == 0)
+            continue;
+        // Socket já criado por addDestination() (ou o conectado, para a família principal)
+        submit(familyFd[f], msgs[f], count[f], f == primaryFamily ? &lastError : nullptr);
+        for (std::size_t k = 0; k < count[f]; ++k) {
+            Destination &d = destinations[owner[f][k]];
+            if (msgs[f][k].msg_len > 0) {
+                ++d.stats.sent;
+                if (owner[f][k] == 0)
+                    primaryOk = true;
+            } else {
+                ++d.stats.dropped;
+            }
+        }
+    }
+
+    return primaryOk;
+}
+
+/**
+ * @brief Envia um buffer segmentado em datagramas de `segmentSize` bytes.
+ *
+ * O tamanho do segmento é informado por mensagem de controle
+ * (`SOL_UDP`/`UDP_SEGMENT`), e o kernel (ou a placa de rede) divide o
+ * buffer. Se o kernel recusar a opção, o buffer é dividido em `iovec`s
+ * e enviado com `sendBatch()`. A recusa só é memorizada quando indica
+ * falta de suporte: ENOPROTOOPT/EOPNOTSUPP sempre, EINVAL/EIO apenas antes
+ * do primeiro envio com GSO aceito (depois disso, apontam um problema da
+ * chamada, como um segmento maior que o MTU, e só ela é refeita sem GSO).
+ *
+ * @param data Início do buffer.
+ * @param len Tamanho total, em bytes.
+ * @param segmentSize Tamanho de cada datagrama.
+ * @return Número de datagramas aceitos pelo kernel.
+ */
+std::size_t UDPClient::sendSegmented(const void *data, std::size_t len, std::uint16_t segmentSize) {
+    if (segmentSize == 0 || len == 0)
+        return 0;
+
+    const std::size_t segments = (len + segmentSize - 1) / segmentSize;
+
+    if (connected && gsoSupported && segments > 1 && segments <= MAX_GSO_SEGMENTS) {
+        iovec iov{const_cast<void *>(data), len};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint16_t))] = {};
+
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        cmsghdr *cm = CMSG_FIRSTHDR(&msg);
+        cm->cmsg_level = SOL_UDP;
+        cm->cmsg_type = UDP_SEGMENT;
+        cm->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+        std::memcpy(CMSG_DATA(cm), &segmentSize, sizeof(segmentSize));
+
+        ssize_t sent;
+        do {
+            sent = sendmsg(sockfd, &msg, 0);
+        } while (sent < 0 && errno == EINTR);
+        ++stats.calls;
+
+        if (sent >= 0) {
+            gsoConfirmed = true;
+            stats.datagrams += segments;
+            stats.bytes += static_cast<std::uint64_t>(sent);
+            return segments;
+        }
+
+        int err = errno;
+        if (err != EINVAL && err != ENOPROTOOPT && err != EOPNOTSUPP && err != EIO) {
+            countFailure(err, segments);
+            return 0;
+        }
+
+        if (err == ENOPROTOOPT || err == EOPNOTSUPP || !gsoConfirmed)
+            gsoSupported = false;
+        ++stats.gsoFallbacks;
+    }
+
+    // Sem GSO: um iovec por segmento, enviados com sendmmsg()
+    iovec iovs[MAX_BATCH];
+    const char *p = static_cast<const char *>(data);
+    std::size_t offset = 0;
+    std::size_t accepted = 0;
+
+    while (offset < len) {
+        std::size_t n = 0;
+        for (; n < MAX_BATCH && offset < len; ++n) {
+            std::size_t seg = len - offset < segmentSize ? len - offset : segmentSize;
+            iovs[n].iov_base = const_cast<char *>(p + offset);
+            iovs[n].iov_len = seg;
+            offset += seg;
+        }
+
+        std::uint64_t dropsBefore = stats.eagainDrops;
+        accepted += sendBatch(iovs, n);
+
+        // Buffer do socket cheio: descarta o restante do buffer
+        if (stats.eagainDrops != dropsBefore) {
+            stats.eagainDrops += (len - offset + segmentSize - 1) / segmentSize;
+            break;
+        }
+    }
+
+    return accepted;
+}
+
+/**
+ * @brief Ativa ou desativa `O_NONBLOCK` no socket e nos sockets dos destinos adicionais.
+ *
+ * @param enable `true` para modo não bloqueante.
+ * @return `true` se o modo foi aplicado.
+ */
+bool UDPClient::setNonBlocking(bool enable) {
     if (sockfd < 0)
         return false;
 
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(server_port);
-    if (inet_pton(AF_INET, server_ip.c_str(), &addr.sin_addr) <= 0) {
-        std::cerr << "Endereço IP inválido\n";
+    nonBlocking = enable;
+    for (int fd : familyFd)
+        if (fd >= 0 && fd != sockfd)
+            applyNonBlocking(fd, enable);
+    return applyNonBlocking(sockfd, enable);
+}
+
+bool UDPClient::isConnected() const {
+    return connected;
+}
+
+const UdpSendStats &UDPClient::getStats() const {
+    return stats;
+}
+
+int UDPClient::getLastError() const {
+    return lastError;
+}
+
+bool isLinkError(int err) {
+    switch (err) {
+    case ENETUNREACH:
+    case EHOSTUNREACH:
+    case ECONNREFUSED:
+    case ENETDOWN:
+    case EHOSTDOWN:
+    case ENOTCONN:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool parseDestination(const std::string &spec, UdpDestination &out) {
+    out = UdpDestination();
+
+    std::size_t comma = spec.find(',');
+    const std::string hostPort = spec.substr(0, comma);
+
+    // "[ipv6]:porta" ou "ipv4:porta"
+    std::size_t colon;
+    if (!hostPort.empty() && hostPort[0] == '[') {
+        std::size_t close = hostPort.find(']');
+        if (close == std::string::npos || close + 1 >= hostPort.size() || hostPort[close + 1] != ':') {
+            LOG_ERROR("destino inválido: {}", spec);
+            return false;
+        }
+        out.address = hostPort.substr(1, close - 1);
+        colon = close + 1;
+    } else {
+        colon = hostPort.rfind(':');
+        if (colon == std::string::npos) {
+            LOG_ERROR("destino sem porta: {}", spec);
+            return false;
+        }
+        out.address = hostPort.substr(0, colon);
+    }
+
+    char *end;
+    const char *portText = hostPort.c_str() + colon + 1;
+    long port = std::strtol(portText, &end, 10);
+    if (end == portText || *end != '\0' || port <= 0 || port > 65535) {
+        LOG_ERROR("porta inválida em {}", spec);
         return false;
     }
+    out.port = static_cast<int>(port);
 
-    ssize_t sent = sendto(sockfd, data.c_str(), data.size(), 0,
-                          (sockaddr *)&addr, sizeof(addr));
+    while (comma != std::string::npos) {
+        std::size_t next = spec.find(',', comma + 1);
+        const std::string opt = spec.substr(comma + 1, next == std::string::npos ? std::string::npos : next - comma - 1);
+        comma = next;
 
-    return sent == (ssize_t)data.size();
+        if (opt == "binary") {
+            out.encoding = WireEncoding::Binary;
+        } else if (opt == "json") {
+            out.encoding = WireEncoding::Json;
+        } else if (opt.compare(0, 3, "if=") == 0) {
+            out.multicastInterface = opt.substr(3);
+        } else if (opt.compare(0, 4, "div=") == 0 || opt.compare(0, 4, "ttl=") == 0) {
+            const char *value = opt.c_str() + 4;
+            long v = std::strtol(value, &end, 10);
+            if (end == value || *end != '\0' || v < 1) {
+                LOG_ERROR("valor inválido em {}", opt);
+                return false;
+            }
+            if (opt[0] == 'd')
+                out.rateDivisor = static_cast<unsigned>(v);
+            else
+                out.multicastTtl = static_cast<int>(v);
+        } else {
+            LOG_ERROR("opção de destino desconhecida: {}", opt);
+            return false;
+        }
+    }
+    return true;
 }
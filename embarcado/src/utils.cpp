@@ -1,15 +1,15 @@
 /**
  * @file utils.cpp
- * @brief Implementação de funções utilitárias para conversão de ADC e log no console.
+ * @brief Implementação de funções utilitárias para conversão de ADC.
  *
  * Contém funções auxiliares para:
- *  - Converter leituras brutas do ADC em temperatura (°C) usando o modelo Steinhart-Hart.
- *  - Registrar mensagens de log simples no console.
+ *  - Converter leituras brutas do ADC em temperatura (°C) usando o modelo Steinhart-Hart,
+ *    amostra a amostra, em lote (vetorizado) ou por tabela pré-calculada.
  */
 
 #include "../include/utils.hpp"
-#include <iostream>
 #include <cmath>
+#include <cstring>
 
 
 /**
@@ -19,39 +19,243 @@
  * Se o valor do ADC for inválido (≤ 0), retorna -273.15°C como valor de erro.
  *
  * @param rawADC Valor lido do ADC (inteiro).
+ * @param cal Constantes do circuito e do termistor.
  * @return Temperatura correspondente em graus Celsius.
  */
-float convertRawToCelsius(int rawADC)
+float convertRawToCelsius(int rawADC, const ThermistorCalibration &cal)
+{
+    return convertRawToCelsius(static_cast<float>(rawADC), cal);
+}
+
+/**
+ * @brief Converte um valor do ADC, possivelmente fracionário, em °C.
+ *
+ * @param rawADC Valor do ADC (ex: média de várias leituras).
+ * @param cal Constantes do circuito e do termistor.
+ * @return Temperatura em °C, ou -273.15 se `rawADC` for inválido.
+ */
+float convertRawToCelsius(float rawADC, const ThermistorCalibration &cal)
 {
-    if (rawADC <= 0)
+    if (!(rawADC > 0.0f))
         return -273.15f; // retorna valor mínimo possível (erro)
 
-        // Constantes do circuito e do termistor
-        const float seriesResistor = 10000.0f;   /**< Resistor fixo em série (Ω). */
-        const float adcMaxValue = 65535.0f;       /**< Valor máximo do ADC (12 bits). */
-        const float steinhartA = 1.009249522e-03f; /**< Coeficiente A do Steinhart-Hart. */
-        const float steinhartB    = 9.18160536e-05f;   // ≈ 9.1816×10⁻⁵
-        const float steinhartC    = 2.00265654e-06f;   // ≈ 2.0027×10⁻⁶
+    // Cálculo de Steinhart-Hart
+    float resistance = cal.seriesResistor * ((cal.adcMaxValue / rawADC) - 1.0f);
+    float logR = logf(resistance);
+    float tempK = 1.0f / (cal.steinhartA + cal.steinhartB * logR + cal.steinhartC * logR * logR * logR);
+
+    // Converte Kelvin para Celsius
+    return tempK - 273.15f;
+}
+
+/**
+ * @brief Converte um valor bruto do ADC em temperatura em °C com a calibração padrão.
+ *
+ * @param rawADC Valor lido do ADC (inteiro).
+ * @return Temperatura correspondente em graus Celsius.
+ */
+float convertRawToCelsius(int rawADC)
+{
+    static const ThermistorCalibration defaultCalibration;
+    return convertRawToCelsius(rawADC, defaultCalibration);
+}
+
+namespace {
+
+/**
+ * @brief Valor retornado para leituras inválidas (zero absoluto).
+ */
+const float kErrorCelsius = -273.15f;
+
+#if defined(__GNUC__)
+typedef float v4f __attribute__((vector_size(16)));        /**< 4 floats (NEON q / SSE xmm). */
+typedef std::int32_t v4i __attribute__((vector_size(16))); /**< 4 inteiros de 32 bits. */
+
+inline v4f toFloat(v4i v) { return __builtin_convertvector(v, v4f); }
+#endif
+
+inline float toFloat(std::int32_t v) { return static_cast<float>(v); }
+
+/**
+ * @brief Replica uma constante no tipo de trabalho (escalar ou vetor).
+ */
+template <typename F> inline F splat(float x) { return F{} + x; }
+
+/**
+ * @brief Núcleo da conversão em lote, sem desvios.
+ *
+ * Escrito de forma genérica para `float`/`int32_t` (cauda do laço) e
+ * `v4f`/`v4i` (corpo vetorizado), garantindo o mesmo resultado nos dois.
+ *
+ * O logaritmo natural é calculado separando expoente e mantissa do
+ * float (m em [√½, √2)) e usando ln(m) = 2·atanh(s), s = (m-1)/(m+1),
+ * com a série até s⁹. Como |s| ≤ 0.172, o termo desprezado é < 4e-10,
+ * abaixo da precisão do `float`.
+ */
+template <typename F, typename I>
+inline F celsiusKernel(F raw, const ThermistorCalibration &cal)
+{
+    const F one = splat<F>(1.0f);
+
+    // Leituras nulas são trocadas por 1 para não gerar infinito; o resultado
+    // é descartado pela máscara de validade no final.
+    auto rawValid = raw > splat<F>(0.0f);
+    F safeRaw = rawValid ? raw : one;
+
+    F resistance = splat<F>(cal.seriesResistor) * (splat<F>(cal.adcMaxValue) / safeRaw - one);
+    auto valid = rawValid & (resistance > splat<F>(0.0f));
+    F safeR = valid ? resistance : one;
+
+    // Separa expoente e mantissa
+    I bits;
+    std::memcpy(&bits, &safeR, sizeof(bits));
+    I exponent = ((bits >> 23) & 0xFF) - 127;
+    I mantBits = (bits & 0x007FFFFF) | 0x3F800000;
+    F m;
+    std::memcpy(&m, &mantBits, sizeof(m));
+
+    auto big = m > splat<F>(1.41421356f);
+    m = big ? m * splat<F>(0.5f) : m;
+    exponent = big ? exponent + 1 : exponent;
+
+    F t = (m - one) / (m + one);
+    F t2 = t * t;
+    F poly = splat<F>(2.0f / 9.0f);
+    poly = poly * t2 + splat<F>(2.0f / 7.0f);
+    poly = poly * t2 + splat<F>(2.0f / 5.0f);
+    poly = poly * t2 + splat<F>(2.0f / 3.0f);
+    poly = poly * t2 + splat<F>(2.0f);
+    F logR = t * poly + toFloat(exponent) * splat<F>(0.693147180559945f);
+
+    F denom = splat<F>(cal.steinhartA) + logR * (splat<F>(cal.steinhartB) + splat<F>(cal.steinhartC) * logR * logR);
+    F celsius = one / denom - splat<F>(273.15f);
 
-        // Cálculo de Steinhart-Hart
-        float resistance = seriesResistor * ((adcMaxValue / (float)rawADC) - 1.0f);
-        float logR = logf(resistance);
-        float tempK = 1.0f / (steinhartA + steinhartB * logR + steinhartC * logR * logR * logR);
+    return valid ? celsius : splat<F>(kErrorCelsius);
+}
+
+/**
+ * @brief Equação de Steinhart-Hart em `double`, usada como referência.
+ */
+double referenceCelsius(int raw, const ThermistorCalibration &cal)
+{
+    if (raw <= 0)
+        return kErrorCelsius;
+
+    double resistance = cal.seriesResistor * ((double)cal.adcMaxValue / raw - 1.0);
+    if (resistance <= 0.0)
+        return kErrorCelsius;
+
+    double logR = std::log(resistance);
+    double tempK = 1.0 / (cal.steinhartA + cal.steinhartB * logR + cal.steinhartC * logR * logR * logR);
+    return tempK - 273.15;
+}
+
+} // namespace
+
+/**
+ * @brief Converte um bloco de leituras do ADC em temperatura (°C).
+ *
+ * Processa quatro leituras por iteração; a cauda (n % 4) usa o mesmo
+ * núcleo em versão escalar.
+ *
+ * @param in Leituras brutas do ADC.
+ * @param out Temperaturas convertidas.
+ * @param n Número de leituras.
+ * @param cal Constantes do circuito e do termistor.
+ */
+void convertRawToCelsius(const std::uint16_t *in, float *out, std::size_t n,
+                         const ThermistorCalibration &cal)
+{
+    std::size_t i = 0;
 
-        // Converte Kelvin para Celsius
-        return tempK - 273.15f;
+#if defined(__GNUC__)
+    for (; i + 4 <= n; i += 4) {
+        v4f raw = { (float)in[i], (float)in[i + 1], (float)in[i + 2], (float)in[i + 3] };
+        v4f celsius = celsiusKernel<v4f, v4i>(raw, cal);
+        std::memcpy(out + i, &celsius, sizeof(celsius));
+    }
+#endif
+
+    for (; i < n; ++i)
+        out[i] = celsiusKernel<float, std::int32_t>((float)in[i], cal);
 }
 
 /**
- * @brief Exibe uma mensagem de log simples no console.
+ * @brief Converte um bloco de leituras do ADC com a calibração padrão.
  *
- * Prefixa a mensagem com "[LOG]" e envia para std::cout.
+ * @param in Leituras brutas do ADC.
+ * @param out Temperaturas convertidas.
+ * @param n Número de leituras.
+ */
+void convertRawToCelsius(const std::uint16_t *in, float *out, std::size_t n)
+{
+    static const ThermistorCalibration defaultCalibration;
+    convertRawToCelsius(in, out, n, defaultCalibration);
+}
+
+/**
+ * @brief Mede o erro da conversão em lote em todas as entradas de 16 bits.
  *
- * @param msg Mensagem de texto a ser exibida.
+ * @param cal Constantes do circuito e do termistor.
+ * @return Maior erro absoluto (°C) na faixa [-55 °C, 300 °C].
  */
-void logData(const std::string &msg) {
-    std::cout << "[LOG] " << msg << std::endl;
+double batchConversionMaxError(const ThermistorCalibration &cal)
+{
+    std::vector<std::uint16_t> in(65536);
+    std::vector<float> out(65536);
+    for (std::size_t i = 0; i < in.size(); ++i)
+        in[i] = static_cast<std::uint16_t>(i);
+
+    convertRawToCelsius(in.data(), out.data(), in.size(), cal);
+
+    double maxError = 0.0;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        double ref = referenceCelsius(static_cast<int>(i), cal);
+        if (ref < -55.0 || ref > 300.0)
+            continue;
+
+        double err = std::fabs((double)out[i] - ref);
+        if (!(err <= maxError))
+            maxError = err; // também propaga NaN
+    }
+    return maxError;
 }
 
+/**
+ * @brief Pré-calcula a tabela de conversão em `double`.
+ *
+ * @param cal Constantes do circuito e do termistor.
+ */
+ConversionTable::ConversionTable(const ThermistorCalibration &cal)
+: table(65536)
+{
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table[i] = static_cast<float>(referenceCelsius(static_cast<int>(i), cal));
+}
 
+/**
+ * @brief Converte uma leitura por consulta à tabela.
+ *
+ * @param raw Leitura bruta do ADC.
+ * @return Temperatura em °C, ou -273.15 se `raw` estiver fora de [0, 65535].
+ */
+float ConversionTable::convert(int raw) const
+{
+    if (raw < 0 || raw > 65535)
+        return kErrorCelsius;
+    return table[raw];
+}
 
+/**
+ * @brief Converte um bloco de leituras por consulta à tabela.
+ *
+ * @param in Leituras brutas do ADC.
+ * @param out Temperaturas convertidas.
+ * @param n Número de leituras.
+ */
+void ConversionTable::convert(const std::uint16_t *in, float *out, std::size_t n) const
+{
+    const float *t = table.data();
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = t[in[i]];
+}
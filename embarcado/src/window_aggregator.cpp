@@ -0,0 +1,164 @@
+/**
+ * @file window_aggregator.cpp
+ * @brief Implementação da agregação das leituras em janelas.
+ */
+
+#include "../include/window_aggregator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+WindowAggregator::WindowAggregator(const AggregateConfig &cfg)
+: config(cfg), windowNs(0), paneNs(0), paneCount(1), current(0), paneEnd(0), bucketScale(0.0)
+{
+    for (Pane &p : panes)
+        p = Pane{0, 0.0, 0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+    last.p50 = last.p90 = last.p99 = std::nan("");
+
+    if (!(config.windowS > 0.0))
+        return;
+
+    // A janela é um número inteiro de painéis; o deslocamento é arredondado para isso
+    windowNs = static_cast<std::int64_t>(config.windowS * 1e9);
+    const double slide = (config.slideS > 0.0 && config.slideS < config.windowS) ? config.slideS : config.windowS;
+    paneCount = static_cast<std::size_t>(config.windowS / slide + 0.5);
+    if (paneCount < 1)
+        paneCount = 1;
+    if (paneCount > AGGREGATE_MAX_PANES)
+        paneCount = AGGREGATE_MAX_PANES;
+    paneNs = windowNs / static_cast<std::int64_t>(paneCount);
+    windowNs = paneNs * static_cast<std::int64_t>(paneCount);
+
+    if (config.percentiles) {
+        if (!(config.sketchMax > config.sketchMin))
+            config.sketchMax = config.sketchMin + 1.0;
+        sketch.assign(paneCount * AGGREGATE_SKETCH_BUCKETS, 0);
+        merged.assign(AGGREGATE_SKETCH_BUCKETS, 0);
+        bucketScale = AGGREGATE_SKETCH_BUCKETS / (config.sketchMax - config.sketchMin);
+    }
+}
+
+/**
+ * @brief Atualiza o painel atual (Welford e histograma) e fecha a janela anterior, se for o caso.
+ */
+bool WindowAggregator::add(double value, std::int64_t epochNs) {
+    if (!enabled())
+        return false;
+
+    bool closed = false;
+    if (paneEnd == 0) {
+        advance(epochNs);
+    } else if (epochNs >= paneEnd) {
+        closed = closeWindow();
+        advance(epochNs);
+    }
+
+    if (std::isnan(value))
+        return closed;
+
+    Pane &p = panes[current];
+    ++p.count;
+    const double delta = value - p.mean;
+    p.mean += delta / p.count;
+    p.m2 += delta * (value - p.mean);
+    if (value < p.min)
+        p.min = value;
+    if (value > p.max)
+        p.max = value;
+
+    if (!sketch.empty()) {
+        double pos = (value - config.sketchMin) * bucketScale;
+        std::size_t b = pos <= 0.0 ? 0
+                      : pos >= AGGREGATE_SKETCH_BUCKETS ? AGGREGATE_SKETCH_BUCKETS - 1
+                      : static_cast<std::size_t>(pos);
+        ++sketch[current * AGGREGATE_SKETCH_BUCKETS + b];
+    }
+    return closed;
+}
+
+/**
+ * @brief Avança o anel até o painel de `epochNs`; um salto maior que a janela esvazia todos.
+ */
+void WindowAggregator::advance(std::int64_t epochNs) {
+    const std::int64_t newEnd = (epochNs / paneNs + 1) * paneNs;
+    std::int64_t steps = paneEnd ? (newEnd - paneEnd) / paneNs : static_cast<std::int64_t>(paneCount);
+    if (steps > static_cast<std::int64_t>(paneCount))
+        steps = static_cast<std::int64_t>(paneCount);
+
+    for (std::int64_t k = 0; k < steps; ++k) {
+        current = (current + 1) % paneCount;
+        panes[current] = Pane{0, 0.0, 0.0, std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity()};
+        if (!sketch.empty())
+            std::fill_n(sketch.begin() + current * AGGREGATE_SKETCH_BUCKETS, AGGREGATE_SKETCH_BUCKETS, 0u);
+    }
+    paneEnd = newEnd;
+}
+
+/**
+ * @brief Combina os painéis da janela (fórmula de Chan para média e variância).
+ */
+bool WindowAggregator::closeWindow() {
+    std::uint32_t n = 0;
+    double mean = 0.0, m2 = 0.0;
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+
+    for (std::size_t i = 0; i < paneCount; ++i) {
+        const Pane &p = panes[i];
+        if (p.count == 0)
+            continue;
+        const std::uint32_t total = n + p.count;
+        const double delta = p.mean - mean;
+        mean += delta * p.count / total;
+        m2 += p.m2 + delta * delta * (static_cast<double>(n) * p.count / total);
+        n = total;
+        lo = std::min(lo, p.min);
+        hi = std::max(hi, p.max);
+    }
+    if (n == 0)
+        return false;
+
+    last.startNs = paneEnd - windowNs;
+    last.endNs = paneEnd;
+    last.count = n;
+    last.min = lo;
+    last.max = hi;
+    last.mean = mean;
+    last.stddev = n > 1 ? std::sqrt(m2 / (n - 1)) : 0.0;
+
+    if (sketch.empty()) {
+        last.p50 = last.p90 = last.p99 = std::nan("");
+        return true;
+    }
+    std::fill(merged.begin(), merged.end(), 0u);
+    for (std::size_t i = 0; i < paneCount; ++i)
+        for (std::size_t b = 0; b < AGGREGATE_SKETCH_BUCKETS; ++b)
+            merged[b] += sketch[i * AGGREGATE_SKETCH_BUCKETS + b];
+    last.p50 = quantile(0.50, n, lo, hi);
+    last.p90 = quantile(0.90, n, lo, hi);
+    last.p99 = quantile(0.99, n, lo, hi);
+    return true;
+}
+
+/**
+ * @brief Interpola linearmente dentro da faixa que contém a posição `q·(n−1)`.
+ *
+ * O erro é da ordem de uma faixa (`(sketchMax − sketchMin) / 256`); o
+ * resultado é limitado ao mínimo e ao máximo exatos da janela.
+ */
+double WindowAggregator::quantile(double q, std::uint32_t n, double lo, double hi) const {
+    const double target = q * (n - 1);
+    double seen = 0.0;
+    for (std::size_t b = 0; b < AGGREGATE_SKETCH_BUCKETS; ++b) {
+        if (merged[b] == 0)
+            continue;
+        if (seen + merged[b] > target) {
+            const double fraction = (target - seen + 0.5) / merged[b];
+            const double v = config.sketchMin + (b + fraction) / bucketScale;
+            return std::min(hi, std::max(lo, v));
+        }
+        seen += merged[b];
+    }
+    return hi;
+}